@@ -1,4 +1,7 @@
+#include <algorithm>
 #include <cassert>
+#include <iterator>
+#include <sstream>
 #include <thread>
 
 #include "Client.h"
@@ -7,7 +10,9 @@
 namespace vasily
 {
 
-inline const config::Config<std::string, std::string, std::string_view, int, int, long long>
+inline const config::Config<std::string, std::string, std::string_view, int, int, long long,
+                            long long, long long, std::size_t, long long, std::size_t,
+                            std::string, std::size_t, long long, std::size_t>
     Client::CONFIG
 {
     { "in.txt" },
@@ -15,7 +20,16 @@ inline const config::Config<std::string, std::string, std::string_view, int, int
     { "172.27.221.60", 14 },
     59002,
     59003,
-    1000
+    1000,
+    30'000,
+    3000,
+    1024,
+    1000,
+    3,
+    { "client_trace.txt" },
+    8,
+    5000,
+    1024
 };
  
 Client::Client(const int layerPort, const std::string_view serverIP, const WorkMode workMode,
@@ -27,20 +41,29 @@ Client::Client(const int layerPort, const std::string_view serverIP, const WorkM
       _receivingSocket(nullptr),
       _serverSendingPort(0),
       _sendingSocket(nullptr),
+      _motionStatistics(CONFIG.get<Param::MOTION_WINDOW>()),
       _serverIP(serverIP),
       _start(std::chrono::steady_clock::now()),
       _workMode(workMode),
       _logger(CONFIG.get<Param::DEFAULT_IN_FILE_NAME>(),
-              CONFIG.get<Param::DEFAULT_OUT_FILE_NAME>())
+              CONFIG.get<Param::DEFAULT_OUT_FILE_NAME>()),
+      _backoff(std::chrono::milliseconds(CONFIG.get<Param::RECONNECTION_DELAY>()),
+               std::chrono::milliseconds(CONFIG.get<Param::MAX_RECONNECTION_DELAY>())),
+      _reconnectTimer(std::make_unique<QTimer>(this)),
+      _connectionTimer(std::make_unique<QTimer>(this)),
+      _heartbeatTimer(std::make_unique<QTimer>(this)),
+      _rawAnswerTimer(std::make_unique<QTimer>(this)),
+      _heartbeat(CONFIG.get<Param::MAX_MISSED_HEARTBEATS>()),
+      _traces({ "send", "ack" }, CONFIG.get<Param::TRACE_FILE_NAME>())
 {
     _printer.writeLine(std::cout, "Layer Port:", layerPort, "Layer IP:", serverIP);
 
     connect(_socketForLayer.get(), &QTcpSocket::readyRead, this, &Client::slotReadFromLayer);
 
-    connect(_socketForLayer.get(), &QTcpSocket::disconnected, this, &Client::slotServerDisconnected,
-            Qt::QueuedConnection);
-
+    qRegisterMetaType<std::vector<protocol::Message>>();
     connect(this, &Client::signalToSend, this, &Client::slotSendDataToLayer);
+
+    initConnectionHandling();
 }
 
 Client::Client(const int serverReceivingPort, const int serverSendingPort,
@@ -52,24 +75,55 @@ Client::Client(const int serverReceivingPort, const int serverSendingPort,
       _receivingSocket(std::make_unique<QTcpSocket>(this)),
       _serverSendingPort(serverSendingPort),
       _sendingSocket(std::make_unique<QTcpSocket>(this)),
+      _motionStatistics(CONFIG.get<Param::MOTION_WINDOW>()),
       _serverIP(serverIP),
       _start(std::chrono::steady_clock::now()),
       _workMode(workMode),
       _logger(CONFIG.get<Param::DEFAULT_IN_FILE_NAME>(),
-              CONFIG.get<Param::DEFAULT_OUT_FILE_NAME>())
+              CONFIG.get<Param::DEFAULT_OUT_FILE_NAME>()),
+      _backoff(std::chrono::milliseconds(CONFIG.get<Param::RECONNECTION_DELAY>()),
+               std::chrono::milliseconds(CONFIG.get<Param::MAX_RECONNECTION_DELAY>())),
+      _reconnectTimer(std::make_unique<QTimer>(this)),
+      _connectionTimer(std::make_unique<QTimer>(this)),
+      _heartbeatTimer(std::make_unique<QTimer>(this)),
+      _rawAnswerTimer(std::make_unique<QTimer>(this)),
+      _heartbeat(CONFIG.get<Param::MAX_MISSED_HEARTBEATS>()),
+      _traces({ "send", "ack" }, CONFIG.get<Param::TRACE_FILE_NAME>())
 {
     _printer.writeLine(std::cout, "Server Receiving Port:", serverReceivingPort,
                        "Server Sending Port:", serverSendingPort, "Server IP:", serverIP);
 
     connect(_receivingSocket.get(), &QTcpSocket::readyRead, this, &Client::slotReadFromServer);
-    connect(_receivingSocket.get(), &QTcpSocket::disconnected, this,
-            &Client::slotServerDisconnected, Qt::QueuedConnection);
 
     ///connect(_sendingSocket.get(), &QTcpSocket::readyRead, this, &Client::slotClientRead);
-    connect(_sendingSocket.get(), &QTcpSocket::disconnected, this, &Client::slotServerDisconnected,
-            Qt::QueuedConnection);
 
+    qRegisterMetaType<std::vector<protocol::Message>>();
     connect(this, &Client::signalToSend, this, &Client::slotSendDataToServer);
+
+    initConnectionHandling();
+}
+
+void Client::initConnectionHandling()
+{
+    // Connection is established and lost through events only, so event loop never blocks.
+    for (const auto& [socket, port] : getSockets())
+    {
+        connect(socket, &QTcpSocket::connected, this, &Client::slotSocketConnected);
+        connect(socket, &QTcpSocket::stateChanged, this, &Client::slotSocketStateChanged);
+    }
+
+    _reconnectTimer->setSingleShot(true);
+    connect(_reconnectTimer.get(), &QTimer::timeout, this, &Client::startConnecting);
+
+    _connectionTimer->setSingleShot(true);
+    connect(_connectionTimer.get(), &QTimer::timeout, this, &Client::slotConnectionTimedOut);
+
+    _heartbeatTimer->setInterval(static_cast<int>(CONFIG.get<Param::HEARTBEAT_INTERVAL>()));
+    connect(_heartbeatTimer.get(), &QTimer::timeout, this, &Client::slotHeartbeat);
+
+    _rawAnswerTimer->setSingleShot(true);
+    _rawAnswerTimer->setInterval(static_cast<int>(CONFIG.get<Param::ANSWER_TIMEOUT>()));
+    connect(_rawAnswerTimer.get(), &QTimer::timeout, this, &Client::slotRawAnswerTimedOut);
 }
 
 void Client::slotReadFromLayer()
@@ -77,16 +131,21 @@ void Client::slotReadFromLayer()
     if (_socketForLayer->bytesAvailable() > 0)
     {
         const QByteArray array = _socketForLayer->readAll();
-        const std::string receivedData = array.toStdString();
 
-        _duration = std::chrono::steady_clock::now() - _start;
-        ///_start = std::chrono::steady_clock::now();
+        _framer.append({ array.constData(), static_cast<std::size_t>(array.size()) });
+        while (const auto message = nextReceivedMessage())
+        {
+            // Time of every point is measured separately, so points in flight don't mix.
+            const auto latency = completePoint(*message);
+            _duration = latency.has_value() ? *latency : std::chrono::steady_clock::now() - _start;
+            const std::string receivedData = protocol::toText(*message);
 
-        _printer.writeLine(std::cout, _socketForLayer->localPort(), '-', receivedData);
-        _logger.writeLine(_socketForLayer->localPort(), '-', receivedData);
+            _printer.writeLine(std::cout, _socketForLayer->localPort(), '-', receivedData);
+            _logger.writeLine(_socketForLayer->localPort(), '-', receivedData);
 
-        _printer.writeLine(std::cout, "Duration:", _duration.count(), "seconds");
-        _logger.writeLine("Duration:", _duration.count(), "seconds");
+            _printer.writeLine(std::cout, "Duration:", _duration.count(), "seconds");
+            _logger.writeLine("Duration:", _duration.count(), "seconds");
+        }
     }
 }
 
@@ -95,57 +154,432 @@ void Client::slotReadFromServer()
     if (_receivingSocket->bytesAvailable() > 0)
     {
         const QByteArray array = _receivingSocket->readAll();
-        const std::string receivedData = array.toStdString();
 
-        _duration = std::chrono::steady_clock::now() - _start;
-        _isReceive.store(true);
+        // Unterminated robot has only one unanswered point, so piece holds one answer.
+        std::optional<protocol::Message> rawAnswer;
+        if (isRawTextLink())
+        {
+            std::string_view chunk(array.constData(), static_cast<std::size_t>(array.size()));
+            while (!chunk.empty() && (chunk.back() == '\n' || chunk.back() == '\r'))
+            {
+                chunk.remove_suffix(1);
+            }
+            rawAnswer = protocol::makeText(std::string(chunk));
+        }
+        else
+        {
+            // Every complete answer confirms one sent point, even if answers came in one piece.
+            _framer.append({ array.constData(), static_cast<std::size_t>(array.size()) });
+        }
+        auto nextMessage = [this, &rawAnswer]()
+        {
+            return rawAnswer.has_value() ? std::exchange(rawAnswer, std::nullopt)
+                                         : nextReceivedMessage();
+        };
+
+        while (const auto message = nextMessage())
+        {
+            const auto latency = completePoint(*message);
+            _duration = latency.has_value() ? *latency : std::chrono::steady_clock::now() - _start;
+            const std::string receivedData = protocol::toText(*message);
+
+            _printer.writeLine(std::cout, _receivingSocket->localPort(), '-', receivedData);
+            _logger.writeLine(_receivingSocket->localPort(), '-', receivedData);
+
+            _printer.writeLine(std::cout, "Duration:", _duration.count(), "seconds");
+            _logger.writeLine("Duration:", _duration.count(), "seconds");
+        }
+
+        if (isRawTextLink())
+        {
+            _isAwaitingAnswer = false;
+            _rawAnswerTimer->stop();
+            writeRawMessages();
+        }
+    }
+}
+
+void Client::slotSocketConnected()
+{
+    if (_state != State::CONNECTING)
+    {
+        return;
+    }
+
+    for (const auto& [socket, port] : getSockets())
+    {
+        if (socket->state() != QAbstractSocket::ConnectedState)
+        {
+            return;
+        }
+    }
+    onConnected();
+}
+
+void Client::slotSocketStateChanged(const QAbstractSocket::SocketState state)
+{
+    if (state != QAbstractSocket::UnconnectedState)
+    {
+        return;
+    }
+
+    switch (_state)
+    {
+        case State::CONNECTING:
+            _printer.writeLine(std::cout, "Not connected to Server!");
+            scheduleReconnect();
+            break;
+
+        case State::CONNECTED:
+            _printer.writeLine(std::cout, "\nServer disconnected!");
+            scheduleReconnect();
+            break;
 
-        _printer.writeLine(std::cout, _receivingSocket->localPort(), '-', receivedData);
-        _logger.writeLine(_receivingSocket->localPort(), '-', receivedData);
+        case State::DISCONNECTED:
+            // Sockets are closed by client itself.
+            break;
+
+        default:
+            assert(false);
+            break;
+    }
+}
 
-        _printer.writeLine(std::cout, "Duration:", _duration.count(), "seconds");
-        _logger.writeLine("Duration:", _duration.count(), "seconds");
-        updateVertices(_duration.count(), _robotData);
+void Client::slotConnectionTimedOut()
+{
+    if (_state == State::CONNECTING)
+    {
+        _printer.writeLine(std::cout, "Connection to Server timed out!");
+        scheduleReconnect();
     }
 }
 
-void Client::slotServerDisconnected()
+void Client::slotHeartbeat()
 {
-    _printer.writeLine(std::cout, "\nServer disconnected!");
-    tryReconnect();
+    if (_state != State::CONNECTED)
+    {
+        _heartbeatTimer->stop();
+        return;
+    }
+
+    const protocol::Message ping = _heartbeat.makeNextPing();
+    if (!_heartbeat.isAlive())
+    {
+        // Half-open connection isn't reported by socket, so it is detected by missed pings.
+        _printer.writeLine(std::cout, "\nServer didn't answer", _heartbeat.getMissedPongs(),
+                           "pings!");
+        scheduleReconnect();
+        return;
+    }
+
+    // Ping is written at once and not printed, it has its own numbering.
+    QTcpSocket* const socket = _workMode == WorkMode::INDIRECT ? _socketForLayer.get()
+                                                               : _sendingSocket.get();
+    socket->write(QByteArray::fromStdString(protocol::serialize(ping, _sendingFormat)));
 }
 
-void Client::slotSendDataToLayer(const QByteArray& data) const
+void Client::slotRawAnswerTimedOut()
 {
-    _socketForLayer->write(data);
-    _printer.writeLine(std::cout, "Sent data:", data.toStdString(), "successfully.\n");
+    _printer.writeLine(std::cout, "Warning: answer for point timed out!");
+    _isAwaitingAnswer = false;
+    writeRawMessages();
 }
 
-void Client::slotSendDataToServer(const QByteArray& data) const
+void Client::slotSendDataToLayer(const std::vector<protocol::Message>& messages)
 {
-    _sendingSocket->write(data);
-    _printer.writeLine(std::cout, "Sent data:", data.toStdString(), "successfully.\n");
+    writeOrBuffer(_socketForLayer.get(), messages);
 }
 
-void Client::checkConnection(const long long time)
+void Client::slotSendDataToServer(const std::vector<protocol::Message>& messages)
 {
-    while (true)
+    writeOrBuffer(_sendingSocket.get(), messages);
+}
+
+void Client::writeOrBuffer(QTcpSocket* const socket,
+                           const std::vector<protocol::Message>& messages)
+{
+    static const std::size_t kCapacity = CONFIG.get<Param::PENDING_DATA_CAPACITY>();
+
+    if (_state == State::CONNECTED && !_isAwaitingHandshake)
+    {
+        writeMessages(socket, messages);
+        return;
+    }
+
+    // Keep the latest messages, they will be sent right after reconnection or handshake.
+    for (const protocol::Message& message : messages)
+    {
+        if (_pendingMessages.size() >= kCapacity)
+        {
+            _pendingMessages.pop_front();
+        }
+        _pendingMessages.push_back(message);
+    }
+}
+
+void Client::writeMessages(QTcpSocket* const socket,
+                           const std::vector<protocol::Message>& messages)
+{
+    if (isRawTextLink())
+    {
+        _rawMessages.insert(_rawMessages.end(), messages.begin(), messages.end());
+        writeRawMessages();
+        return;
+    }
+
+    // Payload of one Ethernet frame, socket gets one write per frame instead of per message.
+    constexpr std::size_t kChunkSize = 1400;
+
+    std::string buffer;
+    buffer.reserve(kChunkSize + protocol::HEADER_SIZE + protocol::ROBOT_DATA_SIZE);
+
+    auto writeChunk = [this, socket, &buffer]()
+    {
+        const QByteArray data(buffer.data(), static_cast<int>(buffer.size()));
+        socket->write(data);
+        printSentData(data);
+        buffer.clear();
+    };
+
+    for (const protocol::Message& message : messages)
+    {
+        protocol::serialize(message, _sendingFormat, buffer);
+        if (buffer.size() >= kChunkSize)
+        {
+            writeChunk();
+        }
+    }
+    if (!buffer.empty())
+    {
+        writeChunk();
+    }
+}
+
+bool Client::isRawTextLink() const noexcept
+{
+    return _workMode == WorkMode::STRAIGHTFORWARD && _wireFormat == protocol::WireFormat::TEXT
+        && !_isLineFramed;
+}
+
+void Client::writeRawMessages()
+{
+    // Nothing separates two points in stream, so the next one waits for answer.
+    while (!_isAwaitingAnswer && !_rawMessages.empty())
+    {
+        const protocol::Message message = std::move(_rawMessages.front());
+        _rawMessages.pop_front();
+
+        const QByteArray data = QByteArray::fromStdString(protocol::toText(message));
+        _sendingSocket->write(data);
+        printSentData(data);
+
+        if (message.type == protocol::MessageType::POINT)
+        {
+            _isAwaitingAnswer = true;
+            _rawAnswerTimer->start();
+        }
+    }
+}
+
+void Client::printSentData(const QByteArray& data) const
+{
+    if (_sendingFormat == protocol::WireFormat::BINARY)
+    {
+        _printer.writeLine(std::cout, "Sent", data.size(), "bytes successfully.\n");
+    }
+    else
+    {
+        _printer.writeLine(std::cout, "Sent data:", data.toStdString(), "successfully.\n");
+    }
+}
+
+std::optional<protocol::Message> Client::nextReceivedMessage()
+{
+    while (const auto frame = _framer.nextMessage())
+    {
+        if (_framer.getFormat() == protocol::WireFormat::BINARY)
+        {
+            if (const auto message = protocol::decode(*frame); message.has_value())
+            {
+                if (processServiceMessage(*message))
+                {
+                    continue;
+                }
+                return message;
+            }
+            _printer.writeLine(std::cout, "ERROR 07: Incorrect binary message received!");
+            continue;
+        }
+
+        if (*frame == protocol::HANDSHAKE_BINARY)
+        {
+            // Server confirmed binary format, everything after confirmation is binary.
+            _framer.setFormat(protocol::WireFormat::BINARY);
+            _isAwaitingHandshake = false;
+            writePendingMessages();
+            continue;
+        }
+
+        const auto message = protocol::parseHeartbeat(*frame).value_or(protocol::makeText(*frame));
+        if (processServiceMessage(message))
+        {
+            continue;
+        }
+        return message;
+    }
+
+    return std::nullopt;
+}
+
+std::optional<std::chrono::microseconds> Client::completePoint(const protocol::Message& message)
+{
+    constexpr std::uint64_t kSummaryPeriod = 1000;
+
+    std::optional<stats::Trace> trace;
+    RobotData reachedPoint;
+    {
+        std::lock_guard lockGuard(_pendingMutex);
+
+        const auto rejected = message.type == protocol::MessageType::TEXT
+                                  ? protocol::parseRejectedLine(message.text)
+                                  : std::nullopt;
+        if (rejected.has_value())
+        {
+            // Rejected points never reach robot, so answers of next points must not go to them.
+            const auto line = protocol::stripPriorityPrefix(*rejected).value_or(*rejected);
+            for (const RobotData& robotData : utils::parseData(line))
+            {
+                const auto it = std::find_if(_pendingPoints.begin(), _pendingPoints.end(),
+                    [&robotData](const PendingPoint& point) { return point.point == robotData; });
+                if (it != _pendingPoints.end())
+                {
+                    it->completion.set_value(std::nullopt);
+                    _pendingPoints.erase(it);
+                }
+            }
+        }
+        else if (message.type == protocol::MessageType::ANSWER)
+        {
+            // Points which were rejected or dropped are never answered.
+            while (!_pendingPoints.empty() && _pendingPoints.front().trace.id < message.sequence)
+            {
+                _pendingPoints.front().completion.set_value(std::nullopt);
+                _pendingPoints.pop_front();
+            }
+            if (!_pendingPoints.empty() && _pendingPoints.front().trace.id == message.sequence)
+            {
+                trace = _pendingPoints.front().trace;
+                reachedPoint = message.robotData;
+                _pendingPoints.front().completion.set_value(message.robotData);
+                _pendingPoints.pop_front();
+            }
+        }
+        else if (message.type == protocol::MessageType::TEXT && !_pendingPoints.empty())
+        {
+            // Text answer has no number, but it is the only text message which contains point.
+            if (const auto reached = protocol::parseTextAnswer(message.text); reached.has_value())
+            {
+                trace = _pendingPoints.front().trace;
+                reachedPoint = *reached;
+                _pendingPoints.front().completion.set_value(*reached);
+                _pendingPoints.pop_front();
+            }
+        }
+    }
+
+    if (!trace.has_value())
+    {
+        return std::nullopt;
+    }
+
+    trace->mark(TraceStage::ACK);
+    _traces.record(*trace);
+    if (_traces.getCount() % kSummaryPeriod == 0)
+    {
+        _logger.writeLine("Latencies:", _traces.getSummary());
+    }
+    const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+        trace->stamps[TraceStage::ACK] - trace->stamps[TraceStage::SEND]);
+    {
+        std::lock_guard lockGuard(_statisticsMutex);
+        _latencies.record(latency);
+    }
+    updateVertices(reachedPoint, *trace);
+    return latency;
+}
+
+bool Client::isHeartbeatSupported() const noexcept
+{
+    return _workMode == WorkMode::INDIRECT || _wireFormat == protocol::WireFormat::BINARY;
+}
+
+bool Client::processServiceMessage(const protocol::Message& message)
+{
+    if (message.type == protocol::MessageType::PONG)
+    {
+        if (const auto roundTrip = _heartbeat.receivePong(message))
+        {
+            _logger.writeLine("Round-trip time:", roundTrip->count(), "us");
+        }
+        return true;
+    }
+
+    if (message.type != protocol::MessageType::TEXT)
+    {
+        return false;
+    }
+
+    if (const auto eta = protocol::parseEtaAnswer(message.text); eta.has_value())
     {
-        sendCoordinates(_robotData);
-        std::this_thread::sleep_for(std::chrono::milliseconds(time));
+        if (eta->sequence.has_value())
+        {
+            _logger.writeLine("Time left to point", *eta->sequence, ':', eta->time.count(), "us");
+        }
+        else
+        {
+            _logger.writeLine("Time left to the end of queue:", eta->time.count(), "us");
+        }
+        return true;
+    }
+
+    if (!isHeartbeatSupported())
+    {
+        return false;
+    }
+
+    // Layer doesn't read from client while its queue is full, so pings aren't answered either.
+    if (message.text == protocol::QUEUE_FULL)
+    {
+        _heartbeatTimer->stop();
     }
+    else if (message.text == protocol::QUEUE_RESUME && _state == State::CONNECTED
+             && _heartbeatTimer->interval() > 0)
+    {
+        _heartbeat.reset();
+        _heartbeatTimer->start();
+    }
+    return false;
 }
 
-void Client::updateVertices(const double time, const vasily::RobotData& robotData)
+void Client::updateVertices(const vasily::RobotData& robotData, const stats::Trace& trace)
 {
-  
+    constexpr std::uint64_t kSummaryPeriod = 1000;
+
+    const auto answerTime = trace.stamps[TraceStage::ACK];
+    const auto startTime = std::max(trace.stamps[TraceStage::SEND], _lastAnswerTime);
     const double distance = utils::distance(_lastReachedPoint.coordinates.begin(),
                                             _lastReachedPoint.coordinates.begin() + 2,
                                             robotData.coordinates.begin(), 0.0, 10'000.0);
-    _distance.emplace_back(distance);
-    _velocity.emplace_back(_distance.back() / time);
-    _time.emplace_back(time);
     _lastReachedPoint = robotData;
+    _lastAnswerTime = answerTime;
+
+    std::lock_guard lockGuard(_statisticsMutex);
+    _motionStatistics.record(distance, std::chrono::duration_cast<std::chrono::microseconds>(
+                                           answerTime - startTime));
+    if (_motionStatistics.getDistance().getCount() % kSummaryPeriod == 0)
+    {
+        _logger.writeLine("Motion:", _motionStatistics.getSummary());
+    }
 }
 
 void Client::run()
@@ -184,6 +618,20 @@ void Client::waitLoop()
                 _printer.write(std::cout, "Enter command or to change mode enter '=':");
                 std::getline(std::cin, input);
 
+                // Load generator has its own options, Handler doesn't know them.
+                if (input.compare(0, LOAD_COMMAND.size(), LOAD_COMMAND) == 0)
+                {
+                    std::istringstream options(input.substr(LOAD_COMMAND.size()));
+                    const std::vector<std::string> arguments{
+                        std::istream_iterator<std::string>(options),
+                        std::istream_iterator<std::string>() };
+                    if (const auto profile = parseLoadProfile(arguments))
+                    {
+                        runLoad(*profile);
+                    }
+                    break;
+                }
+
                 _handler.appendCommand(input, _robotData);
 
                 if (_handler.getCurrentState() == Handler::State::COORDINATE_TYPE)
@@ -205,7 +653,7 @@ void Client::waitLoop()
                 }
                 else if (_handler.getCurrentState() == Handler::State::HOME)
                 {
-                    sendCoordinates(RobotData::getDefaultPosition());
+                    sendPriorityCoordinates(RobotData::getDefaultPosition());
                 }
                 else if (_handler.getCurrentState() == Handler::State::FROM_FILE)
                 {
@@ -225,123 +673,6 @@ void Client::waitLoop()
                 {
                     sendCoordinates(_robotData);
                 }
-                else if (input == "test1")
-                {
-                    _robotData = RobotData::getDefaultPosition();
-                    constexpr int kNumberOfIterations = 2'000;
-                    constexpr int kDefaultMultiplier  = 100;
-                    for (int i = 1; i <= kNumberOfIterations; ++i)
-                    {
-                        if (i % 2 == 0)
-                        {
-                            _robotData.coordinates.at(Handler::Y) = kDefaultMultiplier * ((i + 1) / 2);
-                        }
-                        else
-                        {
-                            _robotData.coordinates.at(Handler::Y) = -kDefaultMultiplier * ((i + 1) / 2);
-                        }
-
-                        sendCoordinates(_robotData);
-                        while (!_isReceive.load())
-                        {
-                            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                        }
-                        _isReceive.store(false);
-                    }
-                }
-                else if (input == "test2")
-                {
-                    _robotData = RobotData::getDefaultPosition();
-                    constexpr int kNumberOfIterations = 450;
-                    constexpr int kDefaultMultiplier = 100;
-                    _robotData.coordinates.at(Handler::W) += kDefaultMultiplier * kNumberOfIterations;
-                    sendCoordinates(_robotData);
-                    int cache = 0;
-                    for (int i = 1; i <= kNumberOfIterations; ++i)
-                    {
-                        if (i % 2 == 0)
-                        {
-                            const int temp = kDefaultMultiplier * ((i + 1) / 2);
-                            _robotData.coordinates.at(Handler::W) += temp - cache;
-                            cache = temp;
-                        }
-                        else
-                        {
-                            const int temp = -kDefaultMultiplier * ((i + 1) / 2);
-                            _robotData.coordinates.at(Handler::W) += temp - cache;
-                            cache = temp;
-                        }
-
-                        sendCoordinates(_robotData);
-                        while (!_isReceive.load())
-                        {
-                            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                        }
-                        _isReceive.store(false);
-                    }
-                }
-                else if (input == "test3")
-                {
-                    _robotData = RobotData::getDefaultPosition();
-                    constexpr int kNumberOfIterations = 450;
-                    constexpr int kDefaultMultiplier = 100;
-                    _robotData.coordinates.at(Handler::P) -= kDefaultMultiplier * kNumberOfIterations;
-                    sendCoordinates(_robotData);
-                    int cache = 0;
-                    for (int i = 1; i <= kNumberOfIterations; ++i)
-                    {
-                        if (i % 2 == 0)
-                        {
-                            const int temp = kDefaultMultiplier * ((i + 1) / 2);
-                            _robotData.coordinates.at(Handler::P) += temp - cache;
-                            cache = temp;
-                        }
-                        else
-                        {
-                            const int temp = -kDefaultMultiplier * ((i + 1) / 2);
-                            _robotData.coordinates.at(Handler::P) += temp - cache;
-                            cache = temp;
-                        }
-
-                        sendCoordinates(_robotData);
-                        while (!_isReceive.load())
-                        {
-                            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                        }
-                        _isReceive.store(false);
-                    }
-                }
-                else if (input == "test4")
-                {
-                    _robotData = RobotData::getDefaultPosition();
-                    constexpr int kNumberOfIterations = 450;
-                    constexpr int kDefaultMultiplier = 100;
-                    _robotData.coordinates.at(Handler::R) += kDefaultMultiplier * kNumberOfIterations;
-                    sendCoordinates(_robotData);
-                    int cache = 0;
-                    for (int i = 1; i <= kNumberOfIterations; ++i)
-                    {
-                        if (i % 2 == 0)
-                        {
-                            const int temp = kDefaultMultiplier * ((i + 1) / 2);
-                            _robotData.coordinates.at(Handler::R) += temp - cache;
-                            cache = temp;
-                        }
-                        else
-                        {
-                            const int temp = -kDefaultMultiplier * ((i + 1) / 2);
-                            _robotData.coordinates.at(Handler::R) += temp - cache;
-                            cache = temp;
-                        }
-
-                        sendCoordinates(_robotData);
-                        while (!_isReceive.load())
-                        {
-                            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                        }
-                        _isReceive.store(false);
-                    }
-                }
                 break;
 
             default:
@@ -361,94 +692,275 @@ RobotData Client::getRobotData() const noexcept
     return _robotData;
 }
 
-bool Client::tryConnect(const int port, const std::string& ip, QTcpSocket* const socketToConnect,
-                        const bool isNeedToSendSystem, const int msecs) const
+MotionStatistics Client::getMotionStatistics() const
 {
-    if (socketToConnect->isOpen())
-    {
-        socketToConnect->close();
-    }
+    std::lock_guard lockGuard(_statisticsMutex);
+    return _motionStatistics;
+}
 
-    socketToConnect->connectToHost(ip.c_str(), port);
+stats::Histogram Client::getLatencies() const
+{
+    std::lock_guard lockGuard(_statisticsMutex);
+    return _latencies;
+}
 
-    if (socketToConnect->waitForConnected(msecs))
-    {
-        _printer.writeLine(std::cout, "Connected to Server!");
-        if (isNeedToSendSystem)
-        {
-            sendCoordinateSystem(CoordinateSystem::WORLD);
-        }
-        
-        return true;
-    }
+void Client::resetStatistics()
+{
+    std::lock_guard lockGuard(_statisticsMutex);
+    _motionStatistics.reset();
+    _latencies.reset();
+}
 
-    _printer.writeLine(std::cout, "Not connected to Server!");
-    return false;
+void Client::setWireFormat(const protocol::WireFormat wireFormat) noexcept
+{
+    _wireFormat = wireFormat;
 }
 
-void Client::tryReconnect()
+void Client::setLineFramed(const bool isLineFramed) noexcept
 {
-    launch();
+    _isLineFramed = isLineFramed;
 }
 
 void Client::launch()
 {
-    bool isConnected;
+    startConnecting();
+}
+
+std::vector<std::pair<QTcpSocket*, int>> Client::getSockets() const
+{
     switch (_workMode)
     {
         case WorkMode::STRAIGHTFORWARD:
             // Remember that sending socket should be connect to server receiving port
             // and receiving socket should be connect to server sending port!
-            isConnected = tryConnect(_serverReceivingPort, _serverIP, _sendingSocket.get(), true)
-                       && tryConnect(_serverSendingPort, _serverIP, _receivingSocket.get());
-            while (!isConnected)
-            {
-                isConnected = tryConnect(_serverReceivingPort, _serverIP, _sendingSocket.get(), true)
-                           && tryConnect(_serverSendingPort, _serverIP, _receivingSocket.get());
-                
-                std::this_thread::sleep_for(
-                    std::chrono::milliseconds(CONFIG.get<Param::RECONNECTION_DELAY>()));
-            }
-            break;
+            return { { _sendingSocket.get(), _serverReceivingPort },
+                     { _receivingSocket.get(), _serverSendingPort } };
 
         case WorkMode::INDIRECT:
-            isConnected = tryConnect(_layerPort, _serverIP, _socketForLayer.get(), true);
-            while (!isConnected)
-            {
-                isConnected = tryConnect(_layerPort, _serverIP, _socketForLayer.get(), true);
-                
-                std::this_thread::sleep_for(
-                    std::chrono::milliseconds(CONFIG.get<Param::RECONNECTION_DELAY>()));
-            }
-            break;
+            return { { _socketForLayer.get(), _layerPort } };
 
         default:
             assert(false);
-            break;
+            return {};
+    }
+}
+
+void Client::startConnecting()
+{
+    static const int kConnectionTimeout = static_cast<int>(
+        CONFIG.get<Param::CONNECTION_TIMEOUT>());
+
+    const auto sockets = getSockets();
+    _state = State::DISCONNECTED;
+    for (const auto& [socket, port] : sockets)
+    {
+        socket->abort();
+    }
+
+    _state = State::CONNECTING;
+    for (const auto& [socket, port] : sockets)
+    {
+        socket->connectToHost(_serverIP.c_str(), port);
+    }
+    _connectionTimer->start(kConnectionTimeout);
+}
+
+void Client::scheduleReconnect()
+{
+    _state = State::DISCONNECTED;
+    _connectionTimer->stop();
+    _heartbeatTimer->stop();
+    for (const auto& [socket, port] : getSockets())
+    {
+        socket->abort();
+    }
+
+    // Answer of written point never comes, waiting messages are written after reconnection.
+    _rawAnswerTimer->stop();
+    _isAwaitingAnswer = false;
+    _pendingMessages.insert(_pendingMessages.begin(), _rawMessages.begin(), _rawMessages.end());
+    _rawMessages.clear();
+
+    _sendingFormat = protocol::WireFormat::TEXT;
+    _isAwaitingHandshake = false;
+
+    const auto delay = _backoff.nextDelay();
+    _printer.writeLine(std::cout, "Reconnection attempt", _backoff.getAttempts(), "in",
+                       delay.count(), "ms");
+    _reconnectTimer->start(static_cast<int>(delay.count()));
+}
+
+void Client::onConnected()
+{
+    _state = State::CONNECTED;
+    _connectionTimer->stop();
+    _backoff.reset();
+    _printer.writeLine(std::cout, "Connected to Server!");
+
+    // Every new connection starts in text format until handshake.
+    _sendingFormat = protocol::WireFormat::TEXT;
+    _framer.reset();
+
+    // Slot is called directly in this thread, so messages are written in order of emitting.
+    sendCoordinateSystem(CoordinateSystem::WORLD);
+    if (_wireFormat == protocol::WireFormat::BINARY)
+    {
+        // Buffered points go in binary after confirmation, so their answers are matched by
+        // number and never taken for answers of text points.
+        emit signalToSend({ protocol::makeText(std::string(protocol::HANDSHAKE_BINARY)) });
+        _sendingFormat = protocol::WireFormat::BINARY;
+        _isAwaitingHandshake = true;
+    }
+    else
+    {
+        writePendingMessages();
+    }
+
+    // Real robot knows only points in text format, so it is pinged only in binary format.
+    _heartbeat.reset();
+    if (isHeartbeatSupported() && _heartbeatTimer->interval() > 0)
+    {
+        _heartbeatTimer->start();
     }
 
     _printer.writeLine(std::cout, "\nClient launched...\n");
     _logger.writeLine("\nClient launched at", utils::getCurrentSystemTime());
 }
 
-void Client::sendData(const std::string& data) const
+void Client::writePendingMessages()
+{
+    if (_pendingMessages.empty())
+    {
+        return;
+    }
+
+    const std::vector<protocol::Message> messages(_pendingMessages.begin(),
+                                                  _pendingMessages.end());
+    _pendingMessages.clear();
+    emit signalToSend(messages);
+}
+
+std::uint32_t Client::sendMessage(protocol::Message message) const
 {
-    emit signalToSend(data.c_str());
+    message.sequence = _sequence++;
+    const std::uint32_t sequence = message.sequence;
+    emit signalToSend({ std::move(message) });
+    return sequence;
 }
 
 void Client::sendCoordinates(const RobotData& robotData)
 {
+    sendPoint(protocol::makePoint(robotData));
+}
+
+Client::PointFuture Client::sendCoordinatesAsync(const RobotData& robotData)
+{
+    return sendPoint(protocol::makePoint(robotData));
+}
+
+void Client::sendPriorityCoordinates(const RobotData& robotData)
+{
+    // Robot doesn't know priority mark, only layer can take it into account.
+    sendPoint(_workMode == WorkMode::INDIRECT ? protocol::makePriorityPoint(robotData)
+                                              : protocol::makePoint(robotData));
+}
+
+Client::PointFuture Client::sendPoint(const protocol::Message& message)
+{
+    _start = std::chrono::steady_clock::now();
+
+    // Answer is processed in network thread, so point has to be added before answer can come.
+    PendingPoint point;
+    point.trace.mark(TraceStage::SEND, _start);
+    point.point = message.robotData;
+    PointFuture future = point.completion.get_future();
+    {
+        std::lock_guard lockGuard(_pendingMutex);
+        point.trace.id = sendMessage(message);
+        _pendingPoints.push_back(std::move(point));
+    }
+    _robotData = message.robotData;
+    _logger.writeLine(message.robotData);
+    return future;
+}
+
+void Client::waitForAnswer(PointFuture& future) const
+{
+    static const std::chrono::milliseconds kAnswerTimeout(CONFIG.get<Param::ANSWER_TIMEOUT>());
+
+    // Link may be down, point waits in buffer then and window keeps buffer from overflow.
+    if (future.wait_for(kAnswerTimeout) == std::future_status::timeout)
+    {
+        _printer.writeLine(std::cout, "Warning: answer for point timed out!");
+    }
+}
+
+std::vector<Client::PointFuture> Client::sendBatch(const RobotData* points,
+                                                   const std::size_t size)
+{
+    if (size == 0)
+    {
+        return {};
+    }
+
     _start = std::chrono::steady_clock::now();
-    sendData(robotData.toString());
-    _robotData = robotData;
-    _logger.writeLine(robotData);
+
+    std::vector<PointFuture> futures;
+    futures.reserve(size);
+    std::vector<protocol::Message> messages;
+    messages.reserve(size);
+    std::ostringstream batchLog;
+
+    {
+        // Points are added in order of their numbers before any of them can be answered.
+        std::lock_guard lockGuard(_pendingMutex);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            protocol::Message message = protocol::makePoint(points[i]);
+            message.sequence = _sequence++;
+
+            PendingPoint point;
+            point.trace.id = message.sequence;
+            point.trace.mark(TraceStage::SEND, _start);
+            point.point = points[i];
+            futures.push_back(point.completion.get_future());
+            _pendingPoints.push_back(std::move(point));
+
+            messages.push_back(std::move(message));
+            batchLog << (i > 0 ? "\n" : "") << points[i];
+        }
+        // Whole batch is one signal, network thread writes it in chunks.
+        emit signalToSend(messages);
+    }
+
+    _robotData = points[size - 1];
+    _logger.writeLine(batchLog.str());
+    return futures;
 }
 
-void Client::sendCoordinates(const std::vector<RobotData>& points)
+void Client::sendCoordinates(const std::vector<RobotData>& points, const std::size_t window)
 {
-    for (const auto& point : points)
+    if (window == 0)
+    {
+        sendBatch(points.data(), points.size());
+        return;
+    }
+
+    // Answers wake this thread, so next point goes out as soon as robot takes previous one.
+    const std::size_t firstSize = std::min(window, points.size());
+    auto firstFutures = sendBatch(points.data(), firstSize);
+    std::deque<PointFuture> inFlight(std::make_move_iterator(firstFutures.begin()),
+                                     std::make_move_iterator(firstFutures.end()));
+    for (std::size_t i = firstSize; i < points.size(); ++i)
     {
-        sendCoordinates(point);
+        waitForAnswer(inFlight.front());
+        inFlight.pop_front();
+        inFlight.push_back(sendCoordinatesAsync(points[i]));
+    }
+
+    for (auto& future : inFlight)
+    {
+        waitForAnswer(future);
     }
 }
 
@@ -457,7 +969,7 @@ void Client::sendCoordinateSystem(const CoordinateSystem coordinateSystem) const
     switch (coordinateSystem)
     {
         case CoordinateSystem::JOINT:
-            sendData("0");
+            sendMessage(protocol::makeCoordinateSystem(coordinateSystem));
             break;
 
         case CoordinateSystem::JGFRM:
@@ -465,7 +977,7 @@ void Client::sendCoordinateSystem(const CoordinateSystem coordinateSystem) const
             break;
         
         case CoordinateSystem::WORLD:
-            sendData("2");
+            sendMessage(protocol::makeCoordinateSystem(coordinateSystem));
             break;
 
         case CoordinateSystem::INVALID:
@@ -476,4 +988,82 @@ void Client::sendCoordinateSystem(const CoordinateSystem coordinateSystem) const
     }
 }
 
+void Client::requestEta(const std::optional<std::uint32_t> sequence) const
+{
+    sendMessage(protocol::makeText(protocol::makeEtaRequest(sequence)));
+}
+
+void Client::runLoad(const LoadProfile& profile)
+{
+    using Clock = std::chrono::steady_clock;
+
+    PointGenerator generator(profile, RobotData::getDefaultPosition());
+    std::deque<PointFuture> inFlight;
+    std::uint64_t sentPoints = 0;
+    std::uint64_t answeredPoints = 0;
+    stats::Histogram pacingErrors;
+
+    auto collect = [this, &answeredPoints](PointFuture& future)
+    {
+        waitForAnswer(future);
+        if (future.wait_for(std::chrono::seconds(0)) == std::future_status::ready
+            && future.get().has_value())
+        {
+            ++answeredPoints;
+        }
+    };
+
+    resetStatistics();
+    const std::chrono::duration<double> interval(profile.rate > 0.0 ? 1.0 / profile.rate : 0.0);
+    const auto start = Clock::now();
+    while ((profile.count == 0 || sentPoints < profile.count)
+           && (profile.duration.count() == 0 || Clock::now() - start < profile.duration))
+    {
+        if (profile.window > 0 && inFlight.size() >= profile.window)
+        {
+            collect(inFlight.front());
+            inFlight.pop_front();
+        }
+
+        // Schedule is counted from start, so late point doesn't shift the following ones.
+        if (profile.rate > 0.0)
+        {
+            const auto scheduled = start + std::chrono::duration_cast<Clock::duration>(
+                                               interval * static_cast<double>(sentPoints));
+            std::this_thread::sleep_until(scheduled);
+            pacingErrors.record(std::chrono::duration_cast<std::chrono::microseconds>(
+                Clock::now() - scheduled));
+        }
+
+        inFlight.push_back(sendCoordinatesAsync(generator.next()));
+        ++sentPoints;
+    }
+    for (auto& future : inFlight)
+    {
+        collect(future);
+    }
+
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    const stats::Histogram latencies = getLatencies();
+    std::ostringstream report;
+    report << "Load: sent " << sentPoints << " answered " << answeredPoints
+           << " in " << seconds << " s, throughput "
+           << (seconds > 0.0 ? static_cast<double>(answeredPoints) / seconds : 0.0)
+           << " points/s\nLatency (us): p50 " << latencies.getPercentile(0.5).count()
+           << " p90 " << latencies.getPercentile(0.9).count()
+           << " p99 " << latencies.getPercentile(0.99).count()
+           << " p99.9 " << latencies.getPercentile(0.999).count()
+           << " max " << latencies.getMax().count();
+    if (profile.rate > 0.0)
+    {
+        report << "\nPacing error (us): mean " << pacingErrors.getMean().count()
+               << " p99 " << pacingErrors.getPercentile(0.99).count()
+               << " max " << pacingErrors.getMax().count();
+    }
+    report << "\nMotion: " << getMotionStatistics().getSummary();
+
+    _printer.writeLine(std::cout, report.str());
+    _logger.writeLine(report.str());
+}
+
 } // namespace vasily
@@ -1,13 +1,23 @@
 #ifndef CLIENT_H
 #define CLIENT_H
 
+#include <atomic>
 #include <chrono>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
 
 #include <QObject>
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QTimer>
 
 #include "Handler.h"
+#include "LoadGenerator.h"
+#include "MotionStatistics.h"
 #include "Utilities.h"
 #include "TrajectoryManager.h"
 
@@ -41,15 +51,35 @@ public:
         DEFAULT_SERVER_IP,
         DEFAULT_RECEIVING_PORT_FROM_SERVER,
         DEFAULT_SENDING_PORT_TO_SERVER,
-        RECONNECTION_DELAY
+        RECONNECTION_DELAY,
+        MAX_RECONNECTION_DELAY,
+        CONNECTION_TIMEOUT,
+        PENDING_DATA_CAPACITY,
+        HEARTBEAT_INTERVAL,
+        MAX_MISSED_HEARTBEATS,
+        TRACE_FILE_NAME,
+        SEND_WINDOW,
+        ANSWER_TIMEOUT,
+        MOTION_WINDOW
     };
 
+    /**
+     * \brief   Handle of sent point which is resolved when robot answers it.
+     * \details Value is reached point or std::nullopt if point will never be answered (it was
+     *          rejected or dropped, so robot answered later point first). Rejected point is
+     *          resolved in both formats, but text answer has no number, so point dropped by layer
+     *          is resolved only in binary format (in text format it waits until timeout).
+     */
+    using PointFuture = std::future<std::optional<RobotData>>;
+
     /**
      * \brief   Variable used to keep all default parameters and constants.
      * \details Using std::string instead of std::string_view because Logger constructor needs only
      *          std::string because of std::istream and std::ostream.
      */
-    static const config::Config<std::string, std::string, std::string_view, int, int, long long>
+    static const config::Config<std::string, std::string, std::string_view, int, int, long long,
+                                long long, long long, std::size_t, long long, std::size_t,
+                                std::string, std::size_t, long long, std::size_t>
         CONFIG;
 
 
@@ -123,13 +153,50 @@ public:
      */
     RobotData   getRobotData() const noexcept;
 
+    /**
+     * \brief  Get statistics of robot movement.
+     * \return Copy of statistics made at the moment of call.
+     */
+    MotionStatistics getMotionStatistics() const;
+
+    /**
+     * \brief  Get distribution of time from sending point to its answer.
+     * \return Copy of latencies made at the moment of call.
+     */
+    stats::Histogram getLatencies() const;
+
+    /**
+     * \brief Forget motion statistics and latencies of answered points.
+     */
+    void        resetStatistics();
+
     /**
      * \brief Main method which starts infinite working loop.
      */
     void        run();
 
     /**
-     * \brief Fuction processes sockets (call 'connect').
+     * \brief                Set format which client asks server to use after connection.
+     * \details              Has to be called before launch. Server which doesn't know binary
+     *                       format must be used with text one.
+     * \param[in] wireFormat Format of messages.
+     */
+    void        setWireFormat(const protocol::WireFormat wireFormat) noexcept;
+
+    /**
+     * \brief                  Set if robot connected directly terminates text messages.
+     * \details                Has to be called before launch. Real controller doesn't (default),
+     *                         so every point is written without delimiter, the next point waits
+     *                         for answer of previous one and every piece read is one answer.
+     *                         RobotImitator in text format needs line framing.
+     * \param[in] isLineFramed True if messages are terminated by delimiter.
+     */
+    void        setLineFramed(const bool isLineFramed) noexcept;
+
+    /**
+     * \brief   Fuction processes sockets (call 'connect').
+     * \details Doesn't wait for connection: data sent before it is buffered and connection is
+     *          restored automatically after every disconnection.
      */
     void        launch();
 
@@ -140,10 +207,31 @@ public:
     void        sendCoordinates(const RobotData& robotData);
 
     /**
-    * \brief	    	send coordinates to robot.
-    * \param[in] points List of points for sending.
-    */
-    void        sendCoordinates(const std::vector<RobotData>& points);
+     * \brief               Send coordinate to robot without waiting for answer.
+     * \param[in] robotData Point to send.
+     * \return              Handle resolved when robot answers this point.
+     */
+    PointFuture sendCoordinatesAsync(const RobotData& robotData);
+
+    /**
+     * \brief               Send control point (e.g. return home) which layer passes to robot
+     *                      before queued points.
+     * \param[in] robotData Point to send.
+     */
+    void        sendPriorityCoordinates(const RobotData& robotData);
+
+    /**
+     * \brief            Send coordinates to robot keeping limited number of points in flight.
+     * \details          Next point is sent as soon as the oldest one is answered, so robot
+     *                   always has points in its buffer and no thread polls for answers. With
+     *                   window method returns after the last point is answered. It waits for
+     *                   network thread, so it mustn't be called from it.
+     * \param[in] points List of points for sending.
+     * \param[in] window Maximum number of unanswered points, 0 sends all points at once and
+     *                   doesn't wait.
+     */
+    void        sendCoordinates(const std::vector<RobotData>& points,
+                                const std::size_t window = CONFIG.get<Param::SEND_WINDOW>());
 
     /**
      * \brief						Send coordinate system to robot.
@@ -151,13 +239,32 @@ public:
      */
     void        sendCoordinateSystem(const CoordinateSystem coordinateSystem) const;
 
+    /**
+     * \brief              Ask layer how much time is left to point or to the end of queue,
+     *                     answer is written to log.
+     * \param[in] sequence Number of sent point or std::nullopt for the whole queue.
+     */
+    void        requestEta(const std::optional<std::uint32_t> sequence = std::nullopt) const;
+
+    /**
+     * \brief             Send points of load profile and print throughput, latencies and
+     *                    pacing error.
+     * \details           Points are sent at profile rate while window allows, so robot and layer
+     *                    get repeatable load. It waits for network thread, so it mustn't be called
+     *                    from it.
+     * \param[in] profile Parameters of load.
+     */
+    void        runLoad(const LoadProfile& profile);
+
 
 signals:
     /**
-     * \brief          Notify client to send data to layer or server depend on work mode.
-     * \param[in] data Data to be send.
+     * \brief              Notify client to send messages to layer or server depend on work mode.
+     * \details            Messages are serialized in network thread, so they get format which
+     *                     is used when they are written.
+     * \param[in] messages Messages to be send.
      */
-    void signalToSend(const QByteArray& data) const;
+    void signalToSend(const std::vector<protocol::Message>& messages) const;
 
 
 private slots:
@@ -172,24 +279,55 @@ private slots:
     void slotReadFromServer();
 
     /**
-     * \brief Process server disconnection from layer.
+     * \brief Check if all sockets of work mode are connected.
+     */
+    void slotSocketConnected();
+
+    /**
+     * \brief           Process failed connection attempt or server disconnection.
+     * \param[in] state New state of socket.
+     */
+    void slotSocketStateChanged(const QAbstractSocket::SocketState state);
+
+    /**
+     * \brief Abort connection attempt which took too long.
+     */
+    void slotConnectionTimedOut();
+
+    /**
+     * \brief Send ping or reconnect if peer stopped answering pings.
+     */
+    void slotHeartbeat();
+
+    /**
+     * \brief Send next point to unterminated robot which didn't answer previous one in time.
      */
-    void slotServerDisconnected();
+    void slotRawAnswerTimedOut();
 
     /**
-     * \brief          Send data to layer after notifying from signal.
-     * \param[in] data Data to be send.
+     * \brief              Send messages to layer after notifying from signal.
+     * \param[in] messages Messages to be send.
      */
-    void slotSendDataToLayer(const QByteArray& data) const;
+    void slotSendDataToLayer(const std::vector<protocol::Message>& messages);
 
     /**
-     * \brief          Send data to server after notifying from signal.
-     * \param[in] data Data to be send.
+     * \brief              Send messages to server after notifying from signal.
+     * \param[in] messages Messages to be send.
      */
-    void slotSendDataToServer(const QByteArray& data) const;
+    void slotSendDataToServer(const std::vector<protocol::Message>& messages);
 
 
 protected:
+    /**
+     * \brief Array of states of link to layer or server.
+     */
+    enum class State
+    {
+        DISCONNECTED,
+        CONNECTING,
+        CONNECTED
+    };
+
     /**
      * \brief Implementation of type-safe output printer.
      */
@@ -231,29 +369,29 @@ protected:
     RobotData                                          _robotData;
 
     /**
-     * \brief Container that keeps distance between every two last points.
+     * \brief Statistics of robot movement between answered points (memory doesn't grow).
      */
-    std::vector<double>                                _distance;
+    MotionStatistics                                   _motionStatistics;
 
     /**
-     * \brief Container that keeps velocity of robot movement.
+     * \brief Time from sending point to its answer.
      */
-    std::vector<double>                                _velocity;
+    stats::Histogram                                   _latencies;
 
     /**
-     * \brief Container that keeps duration of robot movement.
+     * \brief Mutex used to read motion statistics and latencies from other threads.
      */
-    std::vector<double>                                _time;
+    mutable std::mutex                                 _statisticsMutex;
 
     /**
-     * \brief Flag used to determine whether a response is accepted from the server.
+     * \brief Keep last reached robot's point.
      */
-    std::atomic_bool                                   _isReceive{};
+    vasily::RobotData                                  _lastReachedPoint;
 
     /**
-     * \brief Keep last reached robot's point.
+     * \brief Time when the last point was answered (robot doesn't move to next point earlier).
      */
-    vasily::RobotData                                  _lastReachedPoint;
+    stats::Trace::Clock::time_point                    _lastAnswerTime{};
 
     /**
      * \brief Variable used to keep server IP address.
@@ -290,30 +428,264 @@ protected:
      */
     danila::TrajectoryManager                          _trajectoryManager;
 
+    /**
+     * \brief Parse state of stream received from layer or server.
+     */
+    protocol::Framer                                   _framer;
+
+    /**
+     * \brief Format which client asks server to use after connection.
+     */
+    protocol::WireFormat                               _wireFormat = protocol::WireFormat::TEXT;
+
+    /**
+     * \brief Format which client currently writes messages in (used only in network thread).
+     */
+    protocol::WireFormat                               _sendingFormat = protocol::WireFormat::TEXT;
+
+    /**
+     * \brief Binary handshake was sent but not confirmed yet, messages are kept in buffer until
+     *        confirmation (used only in network thread).
+     */
+    bool                                               _isAwaitingHandshake = false;
+
+    /**
+     * \brief Number of the next sent message.
+     */
+    mutable std::atomic<std::uint32_t>                 _sequence{};
+
+    /**
+     * \brief Current state of link to layer or server.
+     */
+    State                                              _state = State::DISCONNECTED;
+
+    /**
+     * \brief Delays between connection attempts.
+     */
+    utils::Backoff                                     _backoff;
+
+    /**
+     * \brief Timer used to start next connection attempt.
+     */
+    std::unique_ptr<QTimer>                            _reconnectTimer;
+
+    /**
+     * \brief Timer used to abort connection attempt which takes too long.
+     */
+    std::unique_ptr<QTimer>                            _connectionTimer;
+
+    /**
+     * \brief Timer used to send pings.
+     */
+    std::unique_ptr<QTimer>                            _heartbeatTimer;
+
+    /**
+     * \brief Timer used to stop waiting for answer of unterminated robot.
+     */
+    std::unique_ptr<QTimer>                            _rawAnswerTimer;
 
     /**
-     * \brief                        Establishe a connection to a specified socket.
-     * \param[in] port               Port for connection.
-     * \param[in] ip                 IP address for connection.
-     * \param[out] socketToConnect   A descriptor identifying an unconnected socket.
-     * \param[in] isNeedToSendSystem Flag specifies whether to send the coordinate system.
-     * \param[in] msecs              Time which Qt waits until the socket is connected. If this
-     *                               parameter is -1, function will not time out.
-     * \return                       If no error occurs, connect returns true, false otherwise.
+     * \brief Robot connected directly terminates text messages by delimiter.
      */
-    bool        tryConnect(const int port, const std::string& ip, QTcpSocket* const socketToConnect,
-                           const bool isNeedToSendSystem = false, const int msecs = 3000) const;
+    bool                                               _isLineFramed = false;
 
     /**
-     * \brief Try to establish a connection to server again.
+     * \brief Point written to unterminated robot waits for answer.
      */
-    void        tryReconnect();
+    bool                                               _isAwaitingAnswer = false;
 
     /**
-     * \brief          Send data on a connected socket.
-     * \param[in] data A buffer containing the data to be transmitted.
+     * \brief Messages which wait until unterminated robot answers previous point.
      */
-    void        sendData(const std::string& data) const;
+    std::deque<protocol::Message>                      _rawMessages;
+
+    /**
+     * \brief Pings which peer has to answer and their round-trip times.
+     */
+    protocol::Heartbeat                                _heartbeat;
+
+    /**
+     * \brief Array of stages which are traced for every sent point.
+     */
+    enum TraceStage : std::size_t
+    {
+        SEND,
+        ACK
+    };
+
+    /**
+     * \brief Sent point which waits for answer.
+     */
+    struct PendingPoint
+    {
+        /**
+         * \brief Trace of point (identifier is sequence number).
+         */
+        stats::Trace                                trace;
+
+        /**
+         * \brief Sent point (used to find point which layer rejected).
+         */
+        RobotData                                   point;
+
+        /**
+         * \brief Promise which resolves handle given to sender.
+         */
+        std::promise<std::optional<RobotData>>      completion;
+    };
+
+    /**
+     * \brief Sent points which wait for answer in order of sending.
+     */
+    std::deque<PendingPoint>                           _pendingPoints;
+
+    /**
+     * \brief Mutex used to share pending points between input loop and network thread.
+     */
+    std::mutex                                         _pendingMutex;
+
+    /**
+     * \brief Traces of answered points.
+     */
+    stats::TraceRecorder                               _traces;
+
+    /**
+     * \brief Messages which were sent while link was down (the oldest is dropped when full).
+     */
+    std::deque<protocol::Message>                      _pendingMessages;
+
+
+    /**
+     * \brief Connect sockets and timers used to establish connection.
+     */
+    void        initConnectionHandling();
+
+    /**
+     * \brief  Get sockets used in current work mode with ports they connect to.
+     * \return Pairs of socket and port.
+     */
+    std::vector<std::pair<QTcpSocket*, int>> getSockets() const;
+
+    /**
+     * \brief Close sockets and start connecting to layer or server.
+     */
+    void        startConnecting();
+
+    /**
+     * \brief Plan next connection attempt with growing delay.
+     */
+    void        scheduleReconnect();
+
+    /**
+     * \brief Send coordinate system and handshake after connection, buffered messages are sent
+     *        at once in text format or after handshake is confirmed in binary format.
+     */
+    void        onConnected();
+
+    /**
+     * \brief Send messages which were buffered while link was down or handshake wasn't
+     *        confirmed.
+     */
+    void        writePendingMessages();
+
+    /**
+     * \brief              Write messages to socket or keep them until connection is restored.
+     * \param[out] socket  Socket to write.
+     * \param[in] messages Messages to be send.
+     */
+    void        writeOrBuffer(QTcpSocket* const socket,
+                              const std::vector<protocol::Message>& messages);
+
+    /**
+     * \brief              Serialize messages in current format and write them to socket.
+     * \param[out] socket  Connected socket.
+     * \param[in] messages Messages to be send.
+     */
+    void        writeMessages(QTcpSocket* const socket,
+                              const std::vector<protocol::Message>& messages);
+
+    /**
+     * \brief  Check if client talks to unterminated robot directly.
+     * \return True for direct text link without line framing.
+     */
+    bool        isRawTextLink() const noexcept;
+
+    /**
+     * \brief   Write waiting messages to unterminated robot until point is written.
+     * \details Every message is written separately without delimiter, point is followed only
+     *          after its answer or timeout.
+     */
+    void        writeRawMessages();
+
+    /**
+     * \brief             Send message in current format with next sequence number.
+     * \param[in] message Message to send.
+     * \return            Sequence number of sent message.
+     */
+    std::uint32_t sendMessage(protocol::Message message) const;
+
+    /**
+     * \brief             Send point and start its trace.
+     * \param[in] message Message with point.
+     * \return            Handle resolved when robot answers this point.
+     */
+    PointFuture sendPoint(const protocol::Message& message);
+
+    /**
+     * \brief            Send many points with as few writes as possible.
+     * \details          Points are serialized into one buffer which is written in chunks of
+     *                   network frame size, message is never split between chunks. Batch is
+     *                   logged once.
+     * \param[in] points Points to send.
+     * \param[in] size   Number of points.
+     * \return           Handles resolved when robot answers points, in order of points.
+     */
+    std::vector<PointFuture> sendBatch(const RobotData* points, const std::size_t size);
+
+    /**
+     * \brief            Wait until robot answers point or answer timeout expires.
+     * \param[in] future Handle of sent point.
+     */
+    void        waitForAnswer(PointFuture& future) const;
+
+    /**
+     * \brief          Print information about sent data.
+     * \param[in] data Sent data.
+     */
+    void        printSentData(const QByteArray& data) const;
+
+    /**
+     * \brief  Check if peer answers pings: layer always does, server only in binary format.
+     * \return True if heartbeat can be used.
+     */
+    bool        isHeartbeatSupported() const noexcept;
+
+    /**
+     * \brief             Process heartbeat and flow control messages from peer.
+     * \param[in] message Received message.
+     * \return            True if message belongs to heartbeat and shouldn't be shown.
+     */
+    bool        processServiceMessage(const protocol::Message& message);
+
+    /**
+     * \brief  Extract next complete message from received data and process handshake and
+     *         heartbeat.
+     * \return Decoded message (TEXT one in text format) or std::nullopt if there is no complete
+     *         message.
+     */
+    std::optional<protocol::Message> nextReceivedMessage();
+
+    /**
+     * \brief             Finish trace of point which answer was received and resolve its handle.
+     * \details           Binary answer is matched by sequence number, text answer belongs to the
+     *                    oldest point. Points sent before answered one are never answered, their
+     *                    handles get std::nullopt. Rejected points are matched by coordinates and
+     *                    get std::nullopt when rejection comes.
+     * \param[in] message Received message.
+     * \return            Time from sending point to answer or std::nullopt if message is not
+     *                    an answer.
+     */
+    std::optional<std::chrono::microseconds> completePoint(const protocol::Message& message);
 
     /**
      * \brief Main infinite working loop. Network logic to interacte with server are placed here.
@@ -321,20 +693,17 @@ protected:
     void        waitLoop();
 
     /**
-     * \brief          Check connection to robot every time.
-     * \param[in] time Period time to check.       
-     * \code
-     * Example of usage:
-     * constexpr long long kTime = 2000;
-     * std::thread checkThread(&Client::checkConnection, this, std::cref(kTime));
-     * checkThread.detach();
-     * \endcode
+     * \brief               Add segment from the last reached point to the new one to statistics.
+     * \details             Robot starts moving to point when it is sent or when previous point
+     *                      is reached, whichever is later.
+     * \param[in] robotData Reached point.
+     * \param[in] trace     Finished trace of point.
      */
-    void        checkConnection(const long long time);
-
-    void updateVertices(const double time, const vasily::RobotData& robotData);
+    void        updateVertices(const vasily::RobotData& robotData, const stats::Trace& trace);
 };
 
 } // namespace vasily
 
+Q_DECLARE_METATYPE(std::vector<protocol::Message>)
+
 #endif // CLIENT_H
@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "LoadGenerator.h"
+
+
+namespace vasily
+{
+
+namespace
+{
+
+/**
+ * \brief Names of coordinates in order of RobotData.
+ */
+constexpr std::string_view kAxisNames = "XYZWPR";
+
+/**
+ * \brief            Convert whole text to value.
+ * \param[in]  text  Text of option value.
+ * \param[out] value Converted value (unchanged if text is incorrect).
+ * \return           False if text is not a value of required type.
+ */
+template <class T>
+bool parseValue(const std::string& text, T& value)
+{
+    std::istringstream stream(text);
+    T result;
+    stream >> result;
+    if (stream.fail() || !(stream >> std::ws).eof())
+    {
+        return false;
+    }
+    value = result;
+    return true;
+}
+
+/**
+ * \brief               Read replay points, one point per line.
+ * \param[in]  fileName Name of file.
+ * \param[out] points   Read points.
+ * \return              False if file is not opened, empty or any line is not a point.
+ */
+bool readReplayPoints(const std::string& fileName, std::vector<RobotData>& points)
+{
+    std::ifstream file(fileName);
+    if (!file)
+    {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+        {
+            continue;
+        }
+
+        bool isCorrect;
+        points.push_back(utils::fromString<RobotData>(line, isCorrect));
+        if (!isCorrect)
+        {
+            return false;
+        }
+    }
+    return !points.empty();
+}
+
+} // anonymous namespace
+
+
+std::optional<LoadProfile> parseLoadProfile(const std::vector<std::string>& arguments)
+{
+    auto& printer = printer::Printer::getInstance();
+
+    LoadProfile profile;
+    std::string fileName;
+    for (std::size_t i = 0; i < arguments.size(); i += 2)
+    {
+        const std::string& name = arguments[i];
+        if (i + 1 == arguments.size())
+        {
+            printer.writeLine(std::cout, "ERROR 11: Load option", name, "has no value!");
+            printer.writeLine(std::cout, LOAD_USAGE);
+            return std::nullopt;
+        }
+
+        const std::string& value = arguments[i + 1];
+        bool isCorrect = true;
+        if (name == "--pattern")
+        {
+            if (value == "sweep")
+            {
+                profile.pattern = LoadProfile::Pattern::SWEEP;
+            }
+            else if (value == "zigzag")
+            {
+                profile.pattern = LoadProfile::Pattern::ZIGZAG;
+            }
+            else if (value == "random")
+            {
+                profile.pattern = LoadProfile::Pattern::RANDOM_WALK;
+            }
+            else if (value == "replay")
+            {
+                profile.pattern = LoadProfile::Pattern::REPLAY;
+            }
+            else
+            {
+                isCorrect = false;
+            }
+        }
+        else if (name == "--axes")
+        {
+            profile.axes.reset();
+            for (const char axis : value)
+            {
+                const std::size_t index = kAxisNames.find(static_cast<char>(::toupper(axis)));
+                isCorrect = isCorrect && index != std::string_view::npos;
+                if (isCorrect)
+                {
+                    profile.axes.set(index);
+                }
+            }
+            isCorrect = isCorrect && profile.axes.any();
+        }
+        else if (name == "--amplitude")
+        {
+            isCorrect = parseValue(value, profile.amplitude) && profile.amplitude > 0;
+        }
+        else if (name == "--step")
+        {
+            isCorrect = parseValue(value, profile.step) && profile.step > 0;
+        }
+        else if (name == "--rate")
+        {
+            isCorrect = parseValue(value, profile.rate) && profile.rate >= 0.0;
+        }
+        else if (name == "--window")
+        {
+            isCorrect = parseValue(value, profile.window);
+        }
+        else if (name == "--count")
+        {
+            isCorrect = parseValue(value, profile.count);
+        }
+        else if (name == "--duration")
+        {
+            long long duration = 0;
+            isCorrect = parseValue(value, duration) && duration >= 0;
+            profile.duration = std::chrono::milliseconds(duration);
+        }
+        else if (name == "--seed")
+        {
+            isCorrect = parseValue(value, profile.seed);
+        }
+        else if (name == "--file")
+        {
+            fileName = value;
+        }
+        else
+        {
+            printer.writeLine(std::cout, "ERROR 11: Unknown load option " + name + '!');
+            printer.writeLine(std::cout, LOAD_USAGE);
+            return std::nullopt;
+        }
+
+        if (!isCorrect)
+        {
+            printer.writeLine(std::cout, "ERROR 11: Load option", name,
+                              "has incorrect value " + value + '!');
+            return std::nullopt;
+        }
+    }
+
+    if (profile.count == 0 && profile.duration.count() == 0)
+    {
+        printer.writeLine(std::cout, "ERROR 11: Load has to be limited by count or duration!");
+        return std::nullopt;
+    }
+
+    if (profile.pattern == LoadProfile::Pattern::REPLAY
+        && !readReplayPoints(fileName, profile.replayPoints))
+    {
+        printer.writeLine(std::cout, "ERROR 12: Replay file", fileName, "has no correct points!");
+        return std::nullopt;
+    }
+
+    return profile;
+}
+
+PointGenerator::PointGenerator(const LoadProfile& profile, const RobotData& center)
+    : _profile(profile),
+      _center(center),
+      _offsets{},
+      _index(0),
+      _generator(profile.seed)
+{
+}
+
+RobotData PointGenerator::next()
+{
+    if (_profile.pattern == LoadProfile::Pattern::REPLAY)
+    {
+        return _profile.replayPoints[_index++ % _profile.replayPoints.size()];
+    }
+
+    RobotData point = _center;
+    const int offset = getPeriodicOffset();
+    std::bernoulli_distribution isForward;
+    for (std::size_t axis = 0; axis < RobotData::NUMBER_OF_COORDINATES; ++axis)
+    {
+        if (!_profile.axes.test(axis))
+        {
+            continue;
+        }
+
+        if (_profile.pattern == LoadProfile::Pattern::RANDOM_WALK)
+        {
+            // Walk is kept inside of amplitude, so it can't drift out of workspace.
+            const int shift = isForward(_generator) ? _profile.step : -_profile.step;
+            _offsets[axis] = std::clamp(_offsets[axis] + shift, -_profile.amplitude,
+                                        _profile.amplitude);
+            point.coordinates[axis] += _offsets[axis];
+        }
+        else
+        {
+            point.coordinates[axis] += offset;
+        }
+    }
+
+    ++_index;
+    return point;
+}
+
+int PointGenerator::getPeriodicOffset() const noexcept
+{
+    const long long step = _profile.step;
+    const long long amplitude = std::max<long long>(_profile.amplitude, step);
+
+    if (_profile.pattern == LoadProfile::Pattern::SWEEP)
+    {
+        // Triangle wave: 0 -> amplitude -> -amplitude -> 0.
+        const long long phase = static_cast<long long>((_index + 1) * step % (4 * amplitude));
+        if (phase <= amplitude)
+        {
+            return static_cast<int>(phase);
+        }
+        if (phase <= 3 * amplitude)
+        {
+            return static_cast<int>(2 * amplitude - phase);
+        }
+        return static_cast<int>(phase - 4 * amplitude);
+    }
+
+    // Zigzag: -step, step, -2 * step, 2 * step, ... and again from step after amplitude.
+    const long long levels = amplitude / step;
+    const long long level = static_cast<long long>(_index / 2 % levels) + 1;
+    return static_cast<int>(_index % 2 == 0 ? -level * step : level * step);
+}
+
+} // namespace vasily
@@ -0,0 +1,167 @@
+#ifndef LOAD_GENERATOR_H
+#define LOAD_GENERATOR_H
+
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Utilities.h"
+
+
+namespace vasily
+{
+
+/**
+ * \brief Command which starts load generator from console.
+ */
+inline constexpr std::string_view LOAD_COMMAND = "load";
+
+/**
+ * \brief Description of load generator options.
+ */
+inline constexpr std::string_view LOAD_USAGE =
+    "load [--pattern sweep|zigzag|random|replay] [--axes XYZWPR] [--amplitude N] [--step N] "
+    "[--rate points/s] [--window N] [--count N] [--duration ms] [--seed N] [--file name]";
+
+/**
+ * \brief Parameters of generated load.
+ */
+struct LoadProfile
+{
+    /**
+     * \brief Array of ways to move along selected axes.
+     */
+    enum class Pattern
+    {
+        SWEEP,
+        ZIGZAG,
+        RANDOM_WALK,
+        REPLAY
+    };
+
+
+    /**
+     * \brief Way to move.
+     */
+    Pattern                                         pattern = Pattern::ZIGZAG;
+
+    /**
+     * \brief Coordinates which are changed in order X, Y, Z, W, P, R (Y by default).
+     */
+    std::bitset<RobotData::NUMBER_OF_COORDINATES>   axes{ 1u << 1 };
+
+    /**
+     * \brief Maximum deviation from start point.
+     */
+    int                                             amplitude = 100'000;
+
+    /**
+     * \brief Change of coordinate between two points.
+     */
+    int                                             step = 100;
+
+    /**
+     * \brief Points per second, 0 sends as fast as window allows.
+     */
+    double                                          rate = 0.0;
+
+    /**
+     * \brief Maximum number of unanswered points, 0 doesn't wait for answers.
+     */
+    std::size_t                                     window = 8;
+
+    /**
+     * \brief Number of points, 0 means no limit.
+     */
+    std::size_t                                     count = 2'000;
+
+    /**
+     * \brief Time of sending, 0 means no limit.
+     */
+    std::chrono::milliseconds                       duration{ 0 };
+
+    /**
+     * \brief Seed of random walk, same seed gives same points.
+     */
+    std::uint32_t                                   seed = 1;
+
+    /**
+     * \brief Points of replay pattern (read from file by parser).
+     */
+    std::vector<RobotData>                          replayPoints;
+};
+
+/**
+ * \brief               Make load profile from command line options.
+ * \details             Every option is followed by its value, missing options keep defaults.
+ *                      Replay file contains one point per line in format of input file.
+ * \param[in] arguments Options without command.
+ * \return              Profile or std::nullopt if options are incorrect (error is printed).
+ */
+std::optional<LoadProfile> parseLoadProfile(const std::vector<std::string>& arguments);
+
+/**
+ * \brief   Class used to make points of load profile one by one.
+ * \details Points don't depend on time of sending, so same profile always gives same sequence.
+ */
+class PointGenerator
+{
+public:
+    /**
+     * \brief             Constructor which sets profile and point to move around.
+     * \param[in] profile Parameters of load.
+     * \param[in] center  Point which deviations are counted from.
+     */
+                                PointGenerator(const LoadProfile& profile,
+                                               const RobotData& center);
+
+    /**
+     * \brief  Make next point.
+     * \return Point to send.
+     */
+    RobotData                   next();
+
+
+private:
+    /**
+     * \brief Parameters of load.
+     */
+    LoadProfile                 _profile;
+
+    /**
+     * \brief Point which deviations are counted from.
+     */
+    RobotData                   _center;
+
+    /**
+     * \brief Current deviations used by random walk.
+     */
+    std::array<int, RobotData::NUMBER_OF_COORDINATES> _offsets;
+
+    /**
+     * \brief Number of made points.
+     */
+    std::uint64_t               _index;
+
+    /**
+     * \brief Generator used by random walk.
+     */
+    std::mt19937                _generator;
+
+
+    /**
+     * \brief  Calculate deviation of periodic patterns for current point.
+     * \return Deviation from center.
+     */
+    int                         getPeriodicOffset() const noexcept;
+};
+
+} // namespace vasily
+
+#endif // LOAD_GENERATOR_H
@@ -1,8 +1,13 @@
+#include <cstring>
 #include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <QtCore/QCoreApplication>
 
 #include "Client.h"
+#include "Replayer.h"
 
 
 int main(int argc, char *argv[])
@@ -17,13 +22,70 @@ int main(int argc, char *argv[])
     constexpr int  kServerSendingPort = 9999;
     constexpr char kServerIP[] = "192.168.0.101";
 
+    // Replay mode: Client --replay <capture file> [--fast] [layer IP].
+    if (argc >= 3 && std::strcmp(argv[1], "--replay") == 0)
+    {
+        const bool isFast = argc >= 4 && std::strcmp(argv[3], "--fast") == 0;
+        const int ipIndex = isFast ? 4 : 3;
+        vasily::Replayer replayer(argv[2], argc > ipIndex ? argv[ipIndex] : "127.0.0.1",
+                                  !isFast);
+        QObject::connect(&replayer, &vasily::Replayer::signalFinished, &a,
+                         &QCoreApplication::quit);
+        if (!replayer.launch())
+        {
+            return 1;
+        }
+        return a.exec();
+    }
+
+    // Load mode: Client --load [load options] [--ip <layer IP>], client quits after report.
+    if (argc >= 2 && std::strcmp(argv[1], "--load") == 0)
+    {
+        std::string layerIP = "127.0.0.1";
+        std::vector<std::string> arguments;
+        for (int i = 2; i < argc; ++i)
+        {
+            if (std::strcmp(argv[i], "--ip") == 0 && i + 1 < argc)
+            {
+                layerIP = argv[++i];
+            }
+            else
+            {
+                arguments.emplace_back(argv[i]);
+            }
+        }
+
+        const auto profile = vasily::parseLoadProfile(arguments);
+        if (!profile.has_value())
+        {
+            return 1;
+        }
+
+        vasily::Client client(kServerPort, layerIP);
+        client.setWireFormat(protocol::WireFormat::BINARY);
+        client.launch();
+
+        std::thread loadThread([&client, &profile, &a]()
+        {
+            client.runLoad(*profile);
+            QMetaObject::invokeMethod(&a, "quit", Qt::QueuedConnection);
+        });
+        const int result = a.exec();
+        loadThread.join();
+        return result;
+    }
+
     // Make sure that you use right client: 1 - debug, 2 - for layer, 3 - for robot.
+    // Client for robot writes unterminated text, call setLineFramed(true) for text imitator.
     ///vasily::Client client(kServerReceivingPort, kServerSendingPort, kServerIP);
 
     vasily::Client client(kServerPort, kServerIP);
 
     ///vasily::Client client{};
 
+    // Layer and imitator understand binary format, real robot works only with text one.
+    client.setWireFormat(protocol::WireFormat::BINARY);
+
     client.launch();
     client.run();
 
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include "MotionStatistics.h"
+
+
+namespace vasily
+{
+
+MotionStatistics::MotionStatistics(const std::size_t capacity)
+    : _segments(),
+      _capacity(std::max<std::size_t>(1, capacity)),
+      _next(0),
+      _distance(),
+      _velocity(),
+      _time(),
+      _velocityHistogram(),
+      _timeHistogram()
+{
+    _segments.reserve(_capacity);
+}
+
+void MotionStatistics::record(const double distance, const std::chrono::microseconds time)
+{
+    const double seconds = std::chrono::duration<double>(time).count();
+    const double velocity = seconds > 0.0 ? distance / seconds : 0.0;
+
+    // Storage is allocated once, the oldest segment is overwritten afterwards.
+    const Segment segment{ distance, velocity, time };
+    if (_segments.size() < _capacity)
+    {
+        _segments.push_back(segment);
+    }
+    else
+    {
+        _segments[_next] = segment;
+    }
+    _next = (_next + 1) % _capacity;
+
+    _distance.record(distance);
+    if (seconds <= 0.0)
+    {
+        return;
+    }
+    _velocity.record(velocity);
+    _time.record(static_cast<double>(time.count()));
+    _velocityHistogram.record(static_cast<std::uint64_t>(std::llround(std::max(0.0, velocity))));
+    _timeHistogram.record(time);
+}
+
+void MotionStatistics::reset()
+{
+    *this = MotionStatistics(_capacity);
+}
+
+std::vector<MotionStatistics::Segment> MotionStatistics::getLatestSegments() const
+{
+    if (_segments.size() < _capacity)
+    {
+        return _segments;
+    }
+
+    std::vector<Segment> result;
+    result.reserve(_segments.size());
+    result.insert(result.end(), _segments.begin() + static_cast<std::ptrdiff_t>(_next),
+                  _segments.end());
+    result.insert(result.end(), _segments.begin(),
+                  _segments.begin() + static_cast<std::ptrdiff_t>(_next));
+    return result;
+}
+
+const stats::RunningStatistics& MotionStatistics::getDistance() const noexcept
+{
+    return _distance;
+}
+
+const stats::RunningStatistics& MotionStatistics::getVelocity() const noexcept
+{
+    return _velocity;
+}
+
+const stats::RunningStatistics& MotionStatistics::getTime() const noexcept
+{
+    return _time;
+}
+
+const stats::Histogram& MotionStatistics::getVelocityHistogram() const noexcept
+{
+    return _velocityHistogram;
+}
+
+const stats::Histogram& MotionStatistics::getTimeHistogram() const noexcept
+{
+    return _timeHistogram;
+}
+
+std::string MotionStatistics::getSummary() const
+{
+    std::ostringstream summary;
+    summary << "segments " << _distance.getCount()
+            << " distance mean " << _distance.getMean()
+            << " max " << _distance.getMax()
+            << " velocity mean " << _velocity.getMean()
+            << " sd " << _velocity.getStandardDeviation()
+            << " min " << _velocity.getMin()
+            << " p50 " << _velocityHistogram.getPercentileValue(0.5)
+            << " p99 " << _velocityHistogram.getPercentileValue(0.99)
+            << " max " << _velocity.getMax()
+            << " time (us) mean " << _time.getMean()
+            << " sd " << _time.getStandardDeviation()
+            << " p50 " << _timeHistogram.getPercentile(0.5).count()
+            << " p99 " << _timeHistogram.getPercentile(0.99).count()
+            << " max " << _time.getMax();
+    return summary.str();
+}
+
+} // namespace vasily
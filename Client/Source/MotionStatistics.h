@@ -0,0 +1,153 @@
+#ifndef MOTION_STATISTICS_H
+#define MOTION_STATISTICS_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Utilities.h"
+
+
+namespace vasily
+{
+
+/**
+ * \brief   Class used to describe quality of robot motion over endless session.
+ * \details Only the latest segments are kept as they are, for the whole session there are
+ *          online aggregates and histograms, so memory doesn't depend on number of points.
+ */
+class MotionStatistics
+{
+public:
+    /**
+     * \brief Segment of motion between two answered points.
+     */
+    struct Segment
+    {
+        /**
+         * \brief Distance between points.
+         */
+        double                      distance;
+
+        /**
+         * \brief Distance per second.
+         */
+        double                      velocity;
+
+        /**
+         * \brief Time of motion.
+         */
+        std::chrono::microseconds   time;
+    };
+
+
+    /**
+     * \brief              Constructor which allocates storage of the latest segments.
+     * \param[in] capacity Number of the latest segments to keep.
+     */
+    explicit                    MotionStatistics(const std::size_t capacity);
+
+    /**
+     * \brief              Add segment of motion.
+     * \details            Segment which took no time has no velocity and is counted only in
+     *                     distance.
+     * \param[in] distance Distance between points.
+     * \param[in] time     Time of motion.
+     */
+    void                        record(const double distance,
+                                       const std::chrono::microseconds time);
+
+    /**
+     * \brief Remove all segments and aggregates.
+     */
+    void                        reset();
+
+    /**
+     * \brief  Get the latest segments.
+     * \return Segments from the oldest to the newest.
+     */
+    std::vector<Segment>        getLatestSegments() const;
+
+    /**
+     * \brief  Get aggregates of distances of all segments.
+     * \return Distance statistics.
+     */
+    const stats::RunningStatistics& getDistance() const noexcept;
+
+    /**
+     * \brief  Get aggregates of velocities of all segments.
+     * \return Velocity statistics.
+     */
+    const stats::RunningStatistics& getVelocity() const noexcept;
+
+    /**
+     * \brief  Get aggregates of times of all segments in microseconds.
+     * \return Time statistics.
+     */
+    const stats::RunningStatistics& getTime() const noexcept;
+
+    /**
+     * \brief  Get distribution of velocities rounded to integer.
+     * \return Velocity histogram.
+     */
+    const stats::Histogram&     getVelocityHistogram() const noexcept;
+
+    /**
+     * \brief  Get distribution of times of segments.
+     * \return Time histogram.
+     */
+    const stats::Histogram&     getTimeHistogram() const noexcept;
+
+    /**
+     * \brief  Make one line with aggregates and percentiles of all segments.
+     * \return Summary used for log.
+     */
+    std::string                 getSummary() const;
+
+
+private:
+    /**
+     * \brief Ring of the latest segments.
+     */
+    std::vector<Segment>        _segments;
+
+    /**
+     * \brief Maximum number of kept segments.
+     */
+    std::size_t                 _capacity;
+
+    /**
+     * \brief Index where the next segment is written when ring is full.
+     */
+    std::size_t                 _next;
+
+    /**
+     * \brief Aggregates of distances.
+     */
+    stats::RunningStatistics    _distance;
+
+    /**
+     * \brief Aggregates of velocities.
+     */
+    stats::RunningStatistics    _velocity;
+
+    /**
+     * \brief Aggregates of times.
+     */
+    stats::RunningStatistics    _time;
+
+    /**
+     * \brief Distribution of velocities.
+     */
+    stats::Histogram            _velocityHistogram;
+
+    /**
+     * \brief Distribution of times.
+     */
+    stats::Histogram            _timeHistogram;
+};
+
+} // namespace vasily
+
+#endif // MOTION_STATISTICS_H
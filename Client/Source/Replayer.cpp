@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include "Replayer.h"
+
+
+namespace vasily
+{
+
+namespace
+{
+
+/**
+ * \brief Time without answers from layer after which replay is finished, ms.
+ */
+constexpr int kDrainTimeout = 3000;
+
+} // anonymous namespace
+
+Replayer::Replayer(const std::string& fileName, const std::string& layerIP,
+                   const bool isRealTime, QObject* parent)
+    : QObject(parent),
+      _fileName(fileName),
+      _layerIP(layerIP),
+      _isRealTime(isRealTime),
+      _records(),
+      _nextRecord(0),
+      _capturedAnswerBytes(0),
+      _sentBytes(0),
+      _sessions(),
+      _start(),
+      _lastActivity(),
+      _drainTimer(std::make_unique<QTimer>(this))
+{
+    _drainTimer->setSingleShot(true);
+    _drainTimer->setInterval(kDrainTimeout);
+    connect(_drainTimer.get(), &QTimer::timeout, this, &Replayer::slotFinish);
+}
+
+bool Replayer::launch()
+{
+    capture::CaptureReader reader(_fileName);
+    if (!reader.isValid())
+    {
+        _printer.writeLine(std::cout, "ERROR 08: Capture file", _fileName, "is not opened!");
+        return false;
+    }
+
+    // Robot side is played by RobotImitator, only clients are replayed.
+    std::size_t clientEvents = 0;
+    while (auto record = reader.next())
+    {
+        switch (record->event)
+        {
+            case capture::Event::CLIENT_CONNECTED:
+                [[fallthrough]];
+            case capture::Event::CLIENT_DISCONNECTED:
+                [[fallthrough]];
+            case capture::Event::FROM_CLIENT:
+                ++clientEvents;
+                _records.emplace_back(std::move(*record));
+                break;
+
+            case capture::Event::RUN_STARTED:
+                _records.emplace_back(std::move(*record));
+                break;
+
+            case capture::Event::TO_CLIENT:
+                _capturedAnswerBytes += record->data.size();
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    if (clientEvents == 0)
+    {
+        _printer.writeLine(std::cout, "Capture file", _fileName, "has no traffic of clients!");
+        return false;
+    }
+
+    // Layer could be restarted hours later, replay doesn't wait for it.
+    capture::collapseRuns(_records);
+
+    _printer.writeLine(std::cout, "Replaying", clientEvents, "events from", _fileName,
+                       _isRealTime ? "at original timing..." : "as fast as possible...");
+    _start = std::chrono::steady_clock::now();
+    _lastActivity = _start;
+    slotReplayNext();
+    return true;
+}
+
+void Replayer::slotReplayNext()
+{
+    const auto captureStart = _records.front().time;
+    const auto elapsed = std::chrono::steady_clock::now() - _start;
+
+    // Everything which is late is sent at once, so replay catches up after slow iteration.
+    while (_nextRecord < _records.size()
+           && (!_isRealTime || _records[_nextRecord].time - captureStart <= elapsed))
+    {
+        replay(_records[_nextRecord++]);
+
+        // Fast replay still returns to event loop, so connections are established and answers
+        // are read between messages.
+        if (!_isRealTime)
+        {
+            break;
+        }
+    }
+
+    if (_nextRecord == _records.size())
+    {
+        _drainTimer->start();
+        return;
+    }
+
+    const auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+        _records[_nextRecord].time - captureStart - (std::chrono::steady_clock::now() - _start));
+    QTimer::singleShot(_isRealTime ? static_cast<int>(std::max<long long>(0, delay.count())) : 0,
+                       Qt::PreciseTimer, this, &Replayer::slotReplayNext);
+}
+
+void Replayer::slotFinish()
+{
+    const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        _lastActivity - _start);
+    const auto capturedDuration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        _records.back().time - _records.front().time);
+
+    std::uint64_t receivedBytes = 0;
+    for (const auto& [sessionId, session] : _sessions)
+    {
+        receivedBytes += session.receivedBytes;
+    }
+
+    _printer.writeLine(std::cout, "\nReplay finished: sent", _sentBytes, "bytes in",
+                       duration.count(), "ms (captured", capturedDuration.count(), "ms), received",
+                       receivedBytes, "bytes (captured", _capturedAnswerBytes, "bytes).");
+    emit signalFinished();
+}
+
+void Replayer::replay(const capture::Record& record)
+{
+    switch (record.event)
+    {
+        case capture::Event::CLIENT_CONNECTED:
+            openSession(record.sessionId, std::atoi(record.data.c_str()));
+            break;
+
+        case capture::Event::CLIENT_DISCONNECTED:
+            closeSession(record.sessionId);
+            break;
+
+        case capture::Event::RUN_STARTED:
+            // Clients of previous run lost their layer, so their connections are closed.
+            for (const auto& [sessionId, session] : _sessions)
+            {
+                closeSession(sessionId);
+            }
+            break;
+
+        case capture::Event::FROM_CLIENT:
+        {
+            const auto it = _sessions.find(record.sessionId);
+            if (it == _sessions.end())
+            {
+                // Capture was started while client was already connected.
+                break;
+            }
+
+            const QByteArray data(record.data.data(), static_cast<int>(record.data.size()));
+            Session& session = it->second;
+            if (session.socket->state() == QAbstractSocket::ConnectedState)
+            {
+                session.socket->write(data);
+            }
+            else
+            {
+                session.pendingData.append(data);
+            }
+            _sentBytes += record.data.size();
+            _lastActivity = std::chrono::steady_clock::now();
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+void Replayer::openSession(const std::uint32_t sessionId, const int layerPort)
+{
+    // Several runs of layer in one file reuse identifiers of sessions.
+    _sessions.erase(sessionId);
+
+    Session& session = _sessions[sessionId];
+    session.socket        = std::make_unique<QTcpSocket>(this);
+    session.isClosing     = false;
+    session.receivedBytes = 0;
+
+    QTcpSocket* socket = session.socket.get();
+    connect(socket, &QTcpSocket::connected, this,
+            [this, sessionId, socket]()
+            {
+                Session& connected = _sessions.at(sessionId);
+                socket->write(connected.pendingData);
+                connected.pendingData.clear();
+                if (connected.isClosing)
+                {
+                    socket->disconnectFromHost();
+                }
+            });
+    connect(socket, &QTcpSocket::readyRead, this,
+            [this, sessionId, socket]()
+            {
+                _sessions.at(sessionId).receivedBytes +=
+                    static_cast<std::uint64_t>(socket->readAll().size());
+                _lastActivity = std::chrono::steady_clock::now();
+                if (_drainTimer->isActive())
+                {
+                    _drainTimer->start();
+                }
+            });
+
+    socket->connectToHost(_layerIP.c_str(), layerPort);
+}
+
+void Replayer::closeSession(const std::uint32_t sessionId)
+{
+    const auto it = _sessions.find(sessionId);
+    if (it == _sessions.end())
+    {
+        return;
+    }
+
+    // Socket which is still connecting is closed right after pending data is written.
+    Session& session = it->second;
+    session.isClosing = true;
+    if (session.socket->state() == QAbstractSocket::ConnectedState)
+    {
+        session.socket->disconnectFromHost();
+    }
+}
+
+} // namespace vasily
@@ -0,0 +1,196 @@
+#ifndef REPLAYER_H
+#define REPLAYER_H
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <QObject>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include "Utilities.h"
+
+
+namespace vasily
+{
+
+/**
+ * \brief   Class used to feed traffic of clients from capture file back into layer.
+ * \details Every captured session gets its own connection to the same layer port and receives
+ *          exactly the captured bytes, either at original timing or as fast as possible. Layer
+ *          works with RobotImitator instead of real robot, so performance problem seen in field
+ *          can be repeated on any computer.
+ */
+class Replayer : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * \brief                Constructor that sets replay parameters.
+     * \param[in] fileName   Capture file to replay.
+     * \param[in] layerIP    IP address of layer.
+     * \param[in] isRealTime Keep original intervals between messages or send them at once.
+     * \param[in] parent     The necessary data for Qt.
+     */
+                Replayer(const std::string& fileName, const std::string& layerIP,
+                         const bool isRealTime, QObject* parent = nullptr);
+
+    /**
+     * \brief Default destructor.
+     */
+    virtual     ~Replayer() = default;
+
+    /**
+     * \brief           Deleted copy constructor.
+     * \param[in] other Other object.
+     */
+                Replayer(const Replayer& other) = delete;
+
+    /**
+     * \brief           Deleted copy assignment operator.
+     * \param[in] other Other object.
+     * \return          Returns nothing because it's deleted.
+     */
+    Replayer&   operator=(const Replayer& other) = delete;
+
+    /**
+     * \brief  Read capture file and start replay.
+     * \return False if capture file is absent, broken or has no traffic of clients.
+     */
+    bool        launch();
+
+
+signals:
+    /**
+     * \brief Notify that all captured messages were sent and layer stopped answering.
+     */
+    void signalFinished() const;
+
+
+private slots:
+    /**
+     * \brief Send messages which time has come and plan the next ones.
+     */
+    void slotReplayNext();
+
+    /**
+     * \brief Print results of replay.
+     */
+    void slotFinish();
+
+
+private:
+    /**
+     * \brief Structure which keeps replayed connection of one captured session.
+     */
+    struct Session
+    {
+        /**
+         * \brief Socket connected to layer.
+         */
+        std::unique_ptr<QTcpSocket> socket;
+
+        /**
+         * \brief Data which was replayed before socket connected.
+         */
+        QByteArray                  pendingData;
+
+        /**
+         * \brief Session was closed in capture, socket is closed after pending data is sent.
+         */
+        bool                        isClosing;
+
+        /**
+         * \brief Number of bytes received from layer.
+         */
+        std::uint64_t               receivedBytes;
+    };
+
+    /**
+     * \brief Implementation of type-safe output printer.
+     */
+    printer::Printer&                       _printer = printer::Printer::getInstance();
+
+    /**
+     * \brief Capture file to replay.
+     */
+    std::string                             _fileName;
+
+    /**
+     * \brief IP address of layer.
+     */
+    std::string                             _layerIP;
+
+    /**
+     * \brief Keep original intervals between messages.
+     */
+    bool                                    _isRealTime;
+
+    /**
+     * \brief Captured events of clients in order of capture.
+     */
+    std::vector<capture::Record>            _records;
+
+    /**
+     * \brief Index of the next record to replay.
+     */
+    std::size_t                             _nextRecord;
+
+    /**
+     * \brief Number of bytes which layer sent to clients in capture.
+     */
+    std::uint64_t                           _capturedAnswerBytes;
+
+    /**
+     * \brief Number of replayed bytes.
+     */
+    std::uint64_t                           _sentBytes;
+
+    /**
+     * \brief Replayed connections by captured session identifier.
+     */
+    std::map<std::uint32_t, Session>        _sessions;
+
+    /**
+     * \brief Time when replay started.
+     */
+    std::chrono::steady_clock::time_point   _start;
+
+    /**
+     * \brief Time when the last message was sent or received.
+     */
+    std::chrono::steady_clock::time_point   _lastActivity;
+
+    /**
+     * \brief Timer used to finish replay when layer stops answering.
+     */
+    std::unique_ptr<QTimer>                 _drainTimer;
+
+
+    /**
+     * \brief            Process one captured event.
+     * \param[in] record Event to replay.
+     */
+    void replay(const capture::Record& record);
+
+    /**
+     * \brief               Open connection instead of captured one.
+     * \param[in] sessionId Captured session.
+     * \param[in] layerPort Layer port which captured client was connected to.
+     */
+    void openSession(const std::uint32_t sessionId, const int layerPort);
+
+    /**
+     * \brief               Close connection after its pending data is sent.
+     * \param[in] sessionId Captured session.
+     */
+    void closeSession(const std::uint32_t sessionId);
+};
+
+} // namespace vasily
+
+#endif // REPLAYER_H
@@ -1,4 +1,4 @@
-#include <thread>
+#include <algorithm>
 #include <iostream>
 
 #include "RobotImitator.h"
@@ -7,10 +7,11 @@
 namespace vasily
 {
 
-inline const config::Config<std::string, std::string> RobotImitator::CONFIG
+inline const config::Config<std::string, std::string, std::string> RobotImitator::CONFIG
 {
     { "in.txt" },
-    { "out.txt" }
+    { "out.txt" },
+    { "imitator_trace.txt" }
 };
 
 RobotImitator::RobotImitator(const int recivingPort, const int sendingPort,
@@ -22,8 +23,15 @@ RobotImitator::RobotImitator(const int recivingPort, const int sendingPort,
       _sendingPort(sendingPort),
       _sendingSocket(std::make_unique<QTcpServer>(this)),
       _clientReceivingSocket(nullptr),
+      _sendingFormat(protocol::WireFormat::TEXT),
+      _sequence(0),
       _logger(CONFIG.get<Param::DEFAULT_IN_FILE_NAME>(),
-              CONFIG.get<Param::DEFAULT_OUT_FILE_NAME>())
+              CONFIG.get<Param::DEFAULT_OUT_FILE_NAME>()),
+      _movementEnd(std::chrono::steady_clock::now()),
+      _connectionNumber(0),
+      _readTime(),
+      _textPoints(0),
+      _traces({ "receive", "answer" }, CONFIG.get<Param::TRACE_FILE_NAME>())
 {
     _printer.writeLine(std::cout, "Receiving Port:", recivingPort, "Sending Port:", sendingPort);
 
@@ -54,7 +62,8 @@ void RobotImitator::slotNewConnectionOnSend()
 
     _clientReceivingSocket = _sendingSocket->nextPendingConnection();
 
-    _clientReceivingSocket->write("Test message from Imitator::SendingSocket.");
+    _clientReceivingSocket->write(
+        protocol::Framer::frame("Test message from Imitator::SendingSocket.").c_str());
 
     connect(_clientReceivingSocket, &QTcpSocket::disconnected, this,
             &RobotImitator::slotClientDisconnectedOnSend);
@@ -65,33 +74,144 @@ void RobotImitator::slotReadFromClient()
     if (_clientSendingSocket->bytesAvailable() > 0)
     {
         QByteArray array = _clientSendingSocket->readAll();
+        _readTime = stats::Trace::Clock::now();
         ///qDebug() << array << '\n';
 
-        const std::string receivedData = array.toStdString();
-
-        if (const auto[value, check] = utils::parseCoordinateSystem(receivedData); check)
+        // Coordinate system and points may come in one piece, so answer them one by one.
+        _framer.append({ array.constData(), static_cast<std::size_t>(array.size()) });
+        while (const auto message = _framer.nextMessage())
         {
-            const std::string coordSystemStr = receivedData.substr(0, 1);
-            _printer.writeLine(std::cout, coordSystemStr);
-            _coorninateSystem.emplace(value);
+            processMessage(*message);
         }
+    }
+}
 
-        _logger.writeLine(_clientSendingSocket->localPort(), '-', receivedData); // messageWithIP
-        std::string toSending = utils::parseFullData(receivedData);
-
-        bool flag;
-        const auto robotData = utils::fromString<RobotData>(receivedData, flag);
-        if (flag)
+void RobotImitator::processMessage(const std::string& receivedData)
+{
+    if (_framer.getFormat() == protocol::WireFormat::BINARY)
+    {
+        if (const auto message = protocol::decode(receivedData); message.has_value())
         {
-            std::this_thread::sleep_for(calculateDuration(robotData));
+            processBinaryMessage(*message);
         }
+        else
+        {
+            _printer.writeLine(std::cout, "ERROR 07: Incorrect binary message received!");
+        }
+        return;
+    }
+
+    if (receivedData == protocol::HANDSHAKE_BINARY)
+    {
+        // Client writes binary right after handshake, confirmation is the last text message.
+        _framer.setFormat(protocol::WireFormat::BINARY);
+        sendMessage(protocol::makeText(receivedData));
+        _sendingFormat = protocol::WireFormat::BINARY;
+        return;
+    }
 
-        if (!toSending.empty())
+    if (const auto heartbeat = protocol::parseHeartbeat(receivedData);
+        heartbeat.has_value() && heartbeat->type == protocol::MessageType::PING)
+    {
+        sendMessage(protocol::makePong(heartbeat->sequence), true);
+        return;
+    }
+
+    if (const auto[value, check] = utils::parseCoordinateSystem(receivedData); check)
+    {
+        const std::string coordSystemStr = receivedData.substr(0, 1);
+        _printer.writeLine(std::cout, coordSystemStr);
+        _coorninateSystem.emplace(value);
+    }
+
+    _logger.writeLine(_clientSendingSocket->localPort(), '-', receivedData); // messageWithIP
+    std::string toSending = utils::parseFullData(receivedData);
+
+    bool flag;
+    const auto robotData = utils::fromString<RobotData>(receivedData, flag);
+    const auto duration = flag ? calculateDuration(robotData) : std::chrono::milliseconds(0);
+
+    if (!toSending.empty())
+    {
+        answerAfterMovement(protocol::makeText(toSending), false, duration,
+                            startTrace(_textPoints++));
+        _printer.writeLine(std::cout, receivedData);
+    }
+}
+
+void RobotImitator::processBinaryMessage(const protocol::Message& message)
+{
+    // Heartbeat is answered at once and isn't logged, so it doesn't flood log.
+    if (message.type == protocol::MessageType::PING)
+    {
+        sendMessage(protocol::makePong(message.sequence), true);
+        return;
+    }
+
+    _logger.writeLine(_clientSendingSocket->localPort(), '-', protocol::toText(message));
+
+    switch (message.type)
+    {
+        case protocol::MessageType::COORDINATE_SYSTEM:
+            _printer.writeLine(std::cout, static_cast<int>(message.coordinateSystem));
+            _coorninateSystem.emplace(message.coordinateSystem);
+            break;
+
+        case protocol::MessageType::POINT:
         {
-            _clientReceivingSocket->write(toSending.c_str());
-            _printer.writeLine(std::cout, receivedData);
+            // Answer carries number of point, so client knows which point is reached.
+            protocol::Message answer = protocol::makeAnswer(message.robotData);
+            answer.sequence = message.sequence;
+            answerAfterMovement(answer, true, calculateDuration(message.robotData),
+                                startTrace(message.sequence));
+            _printer.writeLine(std::cout, message.robotData);
+            break;
         }
+
+        default:
+            _printer.writeLine(std::cout, "Unexpected message:", protocol::toText(message));
+            break;
+    }
+}
+
+void RobotImitator::sendMessage(protocol::Message message, const bool isReply)
+{
+    if (!isReply)
+    {
+        message.sequence = _sequence++;
     }
+    _clientReceivingSocket->write(QByteArray::fromStdString(
+        protocol::serialize(message, _sendingFormat)));
+}
+
+stats::Trace RobotImitator::startTrace(const std::uint64_t id) const
+{
+    stats::Trace trace;
+    trace.id = id;
+    trace.mark(TraceStage::RECEIVE, _readTime);
+    return trace;
+}
+
+void RobotImitator::answerAfterMovement(const protocol::Message& answer, const bool isReply,
+                                        const std::chrono::milliseconds duration,
+                                        stats::Trace trace)
+{
+    // Robot starts movement only after finishing previous ones.
+    const auto now = std::chrono::steady_clock::now();
+    _movementEnd = std::max(_movementEnd, now) + duration;
+
+    const auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(_movementEnd - now);
+    const std::size_t connectionNumber = _connectionNumber;
+    QTimer::singleShot(static_cast<int>(delay.count()), Qt::PreciseTimer, this,
+                       [this, answer, isReply, connectionNumber, trace]() mutable
+                       {
+                           if (connectionNumber == _connectionNumber)
+                           {
+                               sendMessage(answer, isReply);
+                               trace.mark(TraceStage::ANSWER);
+                               _traces.record(trace);
+                           }
+                       });
 }
 
 void RobotImitator::slotClientDisconnectedOnReceive()
@@ -99,6 +219,19 @@ void RobotImitator::slotClientDisconnectedOnReceive()
     _printer.writeLine(std::cout, "Client disconnected from receiving port!");
     _clientSendingSocket->close();
     _coorninateSystem.reset();
+
+    if (_traces.getCount() > 0)
+    {
+        _logger.writeLine("Latencies:", _traces.getSummary());
+    }
+
+    // Robot stops, answers for previous client are never sent.
+    ++_connectionNumber;
+    _movementEnd = std::chrono::steady_clock::now();
+
+    // Next client starts in text format until handshake.
+    _framer.reset();
+    _sendingFormat = protocol::WireFormat::TEXT;
 }
 
 void RobotImitator::slotClientDisconnectedOnSend() const
@@ -9,6 +9,7 @@
 #include <QObject>
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QTimer>
 
 #include "Utilities.h"
 
@@ -29,7 +30,8 @@ public:
     enum Param : std::size_t
     {
         DEFAULT_IN_FILE_NAME,
-        DEFAULT_OUT_FILE_NAME
+        DEFAULT_OUT_FILE_NAME,
+        TRACE_FILE_NAME
     };
 
     /**
@@ -37,7 +39,7 @@ public:
      * \details Using std::string instead of std::string_view because Logger constructor needs only
      *          std::string because of std::istream and std::ostream.
      */
-    static const config::Config<std::string, std::string> CONFIG;
+    static const config::Config<std::string, std::string, std::string> CONFIG;
 
     /**
      * \brief                  Constructor which initializes sockets and bindes ports to
@@ -149,6 +151,16 @@ protected:
      */
     QTcpSocket*                     _clientReceivingSocket;
 
+    /**
+     * \brief Format which imitator currently writes messages in.
+     */
+    protocol::WireFormat            _sendingFormat;
+
+    /**
+     * \brief Number of the next message sent to client.
+     */
+    std::uint32_t                   _sequence;
+
     /**
      * \brief Variable used to keep coordinate type from client.
      */
@@ -164,10 +176,88 @@ protected:
      */
     RobotData                       _lastReceivedData;
 
+    /**
+     * \brief Parse state of stream received from client.
+     */
+    protocol::Framer                _framer;
+
+    /**
+     * \brief Time when robot finishes the last received movement.
+     */
+    std::chrono::steady_clock::time_point _movementEnd;
+
+    /**
+     * \brief Number of current client connection, answers for previous client are dropped.
+     */
+    std::size_t                     _connectionNumber;
+
+    /**
+     * \brief Array of stages which are traced for every point.
+     */
+    enum TraceStage : std::size_t
+    {
+        RECEIVE,
+        ANSWER
+    };
+
+    /**
+     * \brief Time when data was last read from client.
+     */
+    stats::Trace::Clock::time_point _readTime;
+
+    /**
+     * \brief Number of points received in text format (identifier of their traces).
+     */
+    std::uint64_t                   _textPoints;
+
+    /**
+     * \brief Traces of answered points: receiving and answering after movement.
+     */
+    stats::TraceRecorder            _traces;
+
+
+    /**
+     * \brief                  Process one complete message from client and answer it.
+     * \param[in] receivedData Message without delimiter (text format) or with header (binary
+     *                         one).
+     */
+    void processMessage(const std::string& receivedData);
+
+    /**
+     * \brief             Process message received in binary format and answer it.
+     * \param[in] message Decoded message.
+     */
+    void processBinaryMessage(const protocol::Message& message);
+
+    /**
+     * \brief             Send message to client in current format with next sequence number.
+     * \param[in] message Message to send.
+     * \param[in] isReply Reply keeps sequence number of message it answers.
+     */
+    void sendMessage(protocol::Message message, const bool isReply = false);
+
+    /**
+     * \brief              Send answer when robot finishes movement, without blocking thread.
+     * \details            Movements are executed one after another, so pings can be answered
+     *                     while robot moves.
+     * \param[in] answer   Answer to send.
+     * \param[in] isReply  Reply keeps sequence number of message it answers.
+     * \param[in] duration Duration of movement.
+     * \param[in] trace    Trace of point which is finished when answer is sent.
+     */
+    void answerAfterMovement(const protocol::Message& answer, const bool isReply,
+                             const std::chrono::milliseconds duration, stats::Trace trace);
+
+    /**
+     * \brief        Create trace of point received with the last read data.
+     * \param[in] id Identifier of point.
+     * \return       Trace with receiving time.
+     */
+    stats::Trace startTrace(const std::uint64_t id) const;
 
     /**
     * \brief               Calculate duration for currrent movement section.
-    * \details             Used to calculate duration for sleeping before sending answer to client.
+    * \details             Used to calculate delay before sending answer to client.
     * \param[in] robotData New point of movement.
     * \return              Approximately duration in milliseconds.
     */
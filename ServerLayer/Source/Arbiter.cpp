@@ -0,0 +1,120 @@
+#include <cassert>
+
+#include "Arbiter.h"
+
+
+namespace vasily
+{
+
+std::optional<Arbiter::Policy> Arbiter::parsePolicy(const std::string_view name) noexcept
+{
+    if (name == "fifo")
+    {
+        return Policy::FIFO;
+    }
+    if (name == "round-robin")
+    {
+        return Policy::ROUND_ROBIN;
+    }
+    if (name == "exclusive")
+    {
+        return Policy::EXCLUSIVE;
+    }
+    return std::nullopt;
+}
+
+Arbiter::Arbiter(const Policy policy) noexcept
+    : _policy(policy),
+      _lastSessionId(0)
+{
+}
+
+Arbiter::Policy Arbiter::getPolicy() const noexcept
+{
+    return _policy;
+}
+
+void Arbiter::setPolicy(const Policy policy) noexcept
+{
+    _policy = policy;
+    _owner.reset();
+}
+
+std::optional<std::size_t> Arbiter::selectSession(
+    const std::map<std::size_t, ClientSession>& sessions)
+{
+    switch (_policy)
+    {
+        case Policy::FIFO:
+            return selectEarliest(sessions);
+
+        case Policy::ROUND_ROBIN:
+        {
+            // Search next session after the last chosen one, wrap around if necessary.
+            for (auto it = sessions.upper_bound(_lastSessionId); it != sessions.end(); ++it)
+            {
+                if (!it->second.inputQueue.empty())
+                {
+                    _lastSessionId = it->first;
+                    return it->first;
+                }
+            }
+            for (auto it = sessions.begin();
+                 it != sessions.end() && it->first <= _lastSessionId; ++it)
+            {
+                if (!it->second.inputQueue.empty())
+                {
+                    _lastSessionId = it->first;
+                    return it->first;
+                }
+            }
+            return std::nullopt;
+        }
+
+        case Policy::EXCLUSIVE:
+        {
+            if (_owner.has_value())
+            {
+                if (const auto it = sessions.find(*_owner);
+                    it != sessions.end() && !it->second.inputQueue.empty())
+                {
+                    return _owner;
+                }
+            }
+
+            _owner = selectEarliest(sessions);
+            return _owner;
+        }
+
+        default:
+            assert(false);
+            return std::nullopt;
+    }
+}
+
+void Arbiter::releaseSession(const std::size_t sessionId) noexcept
+{
+    if (_owner == sessionId)
+    {
+        _owner.reset();
+    }
+}
+
+std::optional<std::size_t> Arbiter::selectEarliest(
+    const std::map<std::size_t, ClientSession>& sessions)
+{
+    std::optional<std::size_t> result;
+    std::uint64_t earliest = 0;
+    for (const auto& [id, session] : sessions)
+    {
+        if (!session.inputQueue.empty()
+            && (!result.has_value() || session.inputQueue.front().arrivalNumber < earliest))
+        {
+            result   = id;
+            earliest = session.inputQueue.front().arrivalNumber;
+        }
+    }
+    return result;
+}
+
+} // namespace vasily
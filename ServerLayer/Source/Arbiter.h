@@ -0,0 +1,101 @@
+#ifndef ARBITER_H
+#define ARBITER_H
+
+#include <map>
+#include <optional>
+#include <string_view>
+
+#include "ClientSession.h"
+
+
+namespace vasily
+{
+
+/**
+ * \brief Class used to decide which client's point goes to robot next.
+ */
+class Arbiter
+{
+public:
+    /**
+     * \brief Array of policies to merge clients queues into robot queue.
+     */
+    enum class Policy
+    {
+        // Points are sent in order of arrival to layer regardless of client.
+        FIFO,
+        // Clients take turns, one point from each client which has something to send.
+        ROUND_ROBIN,
+        // Client which started sending owns robot until its queue is drained.
+        EXCLUSIVE
+    };
+
+
+    /**
+     * \brief          Convert name of policy from config or command line.
+     * \param[in] name One of "fifo", "round-robin" or "exclusive".
+     * \return         Policy or std::nullopt if name is unknown.
+     */
+    static std::optional<Policy> parsePolicy(const std::string_view name) noexcept;
+
+    /**
+     * \brief            Constructor which sets policy.
+     * \param[in] policy Policy used to merge queues.
+     */
+    explicit                    Arbiter(const Policy policy = Policy::FIFO) noexcept;
+
+    /**
+     * \brief  Get current policy.
+     * \return Policy used to merge queues.
+     */
+    Policy                      getPolicy() const noexcept;
+
+    /**
+     * \brief            Set policy.
+     * \param[in] policy New value to set.
+     */
+    void                        setPolicy(const Policy policy) noexcept;
+
+    /**
+     * \brief              Choose session whose point should be sent to robot next.
+     * \param[in] sessions Table of all connected sessions.
+     * \return             Identifier of chosen session or nothing if all queues are empty.
+     */
+    std::optional<std::size_t>  selectSession(const std::map<std::size_t, ClientSession>& sessions);
+
+    /**
+     * \brief               Forget all information about session (e.g. after disconnection).
+     * \param[in] sessionId Identifier of session to forget.
+     */
+    void                        releaseSession(const std::size_t sessionId) noexcept;
+
+
+private:
+    /**
+     * \brief Policy used to merge queues.
+     */
+    Policy                      _policy;
+
+    /**
+     * \brief Last session which was chosen (used by round robin policy).
+     */
+    std::size_t                 _lastSessionId;
+
+    /**
+     * \brief Session which owns robot (used by exclusive policy).
+     */
+    std::optional<std::size_t>  _owner;
+
+
+    /**
+     * \brief              Choose session which has point with the least arrival number.
+     * \param[in] sessions Table of all connected sessions.
+     * \return             Identifier of chosen session or nothing if all queues are empty.
+     */
+    static std::optional<std::size_t> selectEarliest(
+        const std::map<std::size_t, ClientSession>& sessions);
+};
+
+} // namespace vasily
+
+#endif // ARBITER_H
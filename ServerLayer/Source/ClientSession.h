@@ -0,0 +1,155 @@
+#ifndef CLIENT_SESSION_H
+#define CLIENT_SESSION_H
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+
+#include <QTcpSocket>
+
+#include "Utilities.h"
+
+
+namespace vasily
+{
+
+/**
+ * \brief Point received from client with information about its origin.
+ */
+struct Command
+{
+    /**
+     * \brief Array of stages which are traced for every point.
+     */
+    enum Stage : std::size_t
+    {
+        RECEIVE,
+        ENQUEUE,
+        DISPATCH,
+        ROBOT_ACK,
+        NUMBER_OF_STAGES
+    };
+
+    /**
+     * \brief Point to send to robot.
+     */
+    RobotData       robotData;
+
+    /**
+     * \brief Identifier of session which sent this point.
+     */
+    std::size_t     sessionId;
+
+    /**
+     * \brief Global number of point in order of arrival to layer.
+     */
+    std::uint64_t   arrivalNumber;
+
+    /**
+     * \brief Coordinate type which session worked in when point was received.
+     */
+    std::optional<CoordinateSystem> coordinateSystem;
+
+    /**
+     * \brief Number of point in stream of client, answer from robot is sent back with it.
+     */
+    std::uint32_t   sequence;
+
+    /**
+     * \brief   Original message from client which is forwarded to robot as is.
+     * \details Empty if point has to be encoded. Text point in pass-through mode is not parsed,
+     *          so robotData is not filled for it.
+     */
+    std::string     rawFrame;
+
+    /**
+     * \brief Time when point passed stages in layer, identifier is arrival number.
+     */
+    stats::Trace    trace;
+};
+
+/**
+ * \brief Structure which keeps state of one client connected to layer.
+ */
+struct ClientSession
+{
+    /**
+     * \brief Special identifier used to address all sessions, never given to any client.
+     */
+    static constexpr std::size_t    BROADCAST = 0;
+
+    /**
+     * \brief Unique identifier of session, never reused while layer is working.
+     */
+    std::size_t                     id;
+
+    /**
+     * \brief Index of robot which this client works with.
+     */
+    std::size_t                     robotId;
+
+    /**
+     * \brief Pointer to socket used to work with this client.
+     */
+    QTcpSocket*                     socket;
+
+    /**
+     * \brief Coordinate type which this client works in.
+     */
+    std::optional<CoordinateSystem> coordinateSystem;
+
+    /**
+     * \brief Points received from this client and not yet merged into robot queue.
+     */
+    std::deque<Command>             inputQueue;
+
+    /**
+     * \brief Parse state of stream received from this client.
+     */
+    protocol::Framer                framer;
+
+    /**
+     * \brief Format which client negotiated for messages sent to it.
+     */
+    protocol::WireFormat            wireFormat;
+
+    /**
+     * \brief Number of the next message sent to this client.
+     */
+    std::uint32_t                   sequence;
+
+    /**
+     * \brief Layer stopped reading from client because its queue is full.
+     */
+    bool                            isPaused;
+
+    /**
+     * \brief The largest number of points which were in queue of this client.
+     */
+    std::size_t                     inputHighWaterMark;
+
+    /**
+     * \brief Time when data was last read from socket of this client.
+     */
+    stats::Trace::Clock::time_point readTime;
+
+    /**
+     * \brief Stage which removes redundant points of this client before they are queued.
+     */
+    utils::PathSimplifier<Command>  simplifier;
+
+    /**
+     * \brief Predicted durations of points in queue of this client, tagged by their sequence.
+     */
+    utils::Timeline                 timeline;
+
+    /**
+     * \brief The last point put in queue of this client, the next movement starts from it.
+     */
+    RobotData                       lastQueuedPoint;
+};
+
+} // namespace vasily
+
+#endif // CLIENT_SESSION_H
@@ -1,76 +1,543 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <sstream>
+
 #include "DelayManager.h"
 
 
 namespace vasily
 {
 
-DelayManager::DelayManager(printer::Printer& printer, logger::Logger& logger)
-    : _printer(printer)
+namespace
 {
-    _hasReadTable = readDataTable(logger);
-}
 
-bool DelayManager::readDataTable(logger::Logger& logger)
+/**
+ * \brief Table keeps time in milliseconds, lookup returns microseconds.
+ */
+constexpr double kMicrosecondsPerUnit = 1000.0;
+
+/**
+ * \brief Number of observations used only to estimate usual error.
+ */
+constexpr std::size_t kWarmUpObservations = 20;
+
+/**
+ * \brief Observation is rejected if its error is bigger than usual one so many times.
+ */
+constexpr double kOutlierFactor = 4.0;
+
+/**
+ * \brief The smallest error which is never rejected (robot answers with jitter of network).
+ */
+constexpr double kMinRejectedError = 2000.0;
+
+/**
+ * \brief Weight of the last error in mean error.
+ */
+constexpr double kErrorSmoothing = 0.05;
+
+/**
+ * \brief Full turn in thousandths of degree.
+ */
+constexpr double kFullTurn = 360'000.0;
+
+/**
+ * \brief Distance from wrist center to flange of Fanuc M20ia in units of RobotData.
+ */
+constexpr double kFlangeLength = 100'000.0;
+
+/**
+ * \brief Travel of flange (in units of RobotData) when tool turns by thousandth of degree.
+ */
+constexpr double kFlangeTravelPerAngle = kFlangeLength * 3.14159265358979323846 / 180'000.0;
+
+/**
+ * \brief Number of angular columns added to table which has only translational distances.
+ */
+constexpr std::size_t kSeededColumns = 16;
+
+/**
+ * \brief Magic of binary table.
+ */
+constexpr char kTableMagic[4] = { 'V', 'D', 'L', 'Y' };
+
+/**
+ * \brief Version of binary table format.
+ */
+constexpr std::uint32_t kTableVersion = 1;
+
+/**
+ * \brief Header of binary table.
+ */
+struct TableHeader
+{
+    char            magic[4];
+    std::uint32_t   version;
+    std::uint32_t   numberOfModels;
+    std::uint32_t   reserved;
+};
+
+/**
+ * \brief Entry of one type of movement in binary table.
+ */
+struct ModelHeader
 {
-    while (!logger.inFile.eof())
+    std::int32_t    motionType;
+    std::uint32_t   numberOfRows;
+    std::uint32_t   numberOfColumns;
+    std::uint32_t   reserved;
+    std::uint64_t   offset;
+};
+
+static_assert(sizeof(TableHeader) == 16 && sizeof(ModelHeader) == 24,
+              "Binary table layout must not depend on compiler");
+
+/**
+ * \brief               Check that arguments can be used for interpolation.
+ * \param[in] arguments Arguments.
+ * \param[in] size      Number of arguments.
+ * \return              True if arguments strictly increase.
+ */
+bool isStrictlyIncreasing(const double* arguments, const std::size_t size)
+{
+    for (std::size_t i = 1; i < size; ++i)
     {
-        if (logger.hasAnyInputErrors())
+        if (!(arguments[i - 1] < arguments[i]))
         {
-            _printer.writeLine(std::cout, "Failed to read data table from file!");
             return false;
         }
+    }
+    return true;
+}
+
+/**
+ * \brief Measured duration: translational distance, angular distance and time.
+ */
+using Sample = std::array<double, 3>;
+
+/**
+ * \brief             Put measurements of one type of movement on rectangular grid.
+ * \details           Missing cells are interpolated along translational distance. Table
+ *                    without angles gets angular columns where turn takes as long as
+ *                    translation by the same travel of flange, until calibration corrects it.
+ * \param[in] samples Measurements.
+ * \return            Grid of durations.
+ */
+utils::InterpolationGrid makeGrid(const std::vector<Sample>& samples)
+{
+    std::vector<double> rows;
+    std::vector<double> columns;
+    for (const Sample& sample : samples)
+    {
+        rows.push_back(sample[0]);
+        columns.push_back(sample[1]);
+    }
+    for (auto* arguments : { &rows, &columns })
+    {
+        std::sort(arguments->begin(), arguments->end());
+        arguments->erase(std::unique(arguments->begin(), arguments->end()), arguments->end());
+    }
+
+    std::vector<double> values(rows.size() * columns.size());
+    if (columns.size() == 1 && columns.front() == 0.0)
+    {
+        std::vector<std::pair<double, double>> points;
+        for (const Sample& sample : samples)
+        {
+            points.emplace_back(sample[0], sample[2]);
+        }
+        const utils::InterpolationTable table(std::move(points),
+                                              utils::InterpolationTable::Method::LINEAR);
+
+        // Turns are spread evenly up to the one which is as long as the longest translation.
+        const double maxAngle = rows.back() / kFlangeTravelPerAngle;
+        for (std::size_t j = 1; j <= kSeededColumns && maxAngle > 0.0; ++j)
+        {
+            columns.push_back(maxAngle * static_cast<double>(j) / kSeededColumns);
+        }
+
+        values.resize(rows.size() * columns.size());
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+            for (std::size_t j = 0; j < columns.size(); ++j)
+            {
+                values[i * columns.size() + j] =
+                    table.evaluate(std::max(rows[i], columns[j] * kFlangeTravelPerAngle));
+            }
+        }
+        return utils::InterpolationGrid(std::move(rows), std::move(columns), std::move(values));
+    }
+
+    for (std::size_t j = 0; j < columns.size(); ++j)
+    {
+        std::vector<std::pair<double, double>> points;
+        for (const Sample& sample : samples)
+        {
+            if (sample[1] == columns[j])
+            {
+                points.emplace_back(sample[0], sample[2]);
+            }
+        }
+        const utils::InterpolationTable table(std::move(points),
+                                              utils::InterpolationTable::Method::LINEAR);
 
-        const auto distance = logger.read<long long>();
-        const auto time     = logger.read<long long>();
-        _distanceToTimeTable.emplace_hint(_distanceToTimeTable.end(), distance, time);
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+            values[i * columns.size() + j] = table.evaluate(rows[i]);
+        }
+    }
+    return utils::InterpolationGrid(std::move(rows), std::move(columns), std::move(values));
+}
+
+} // anonymous namespace
+
+DelayManager::DelayManager(printer::Printer& printer, const std::string& fileName,
+                           const bool isLogging)
+    : _printer(printer),
+      _isLogging(isLogging),
+      _learningRate(0.0),
+      _meanAbsoluteError(0.0),
+      _observations(0),
+      _hasUnsavedChanges(false)
+{
+    if (!loadDataTable(fileName, true))
+    {
+        _printer.writeLine(std::cout, "Not read data table!");
+    }
+}
+
+DelayManager::Movement DelayManager::describeMovement(const RobotData& firstPoint,
+                                                      const RobotData& secondPoint)
+{
+    Movement movement{};
+    movement.distance = utils::distance(firstPoint.coordinates.begin(),
+                                        firstPoint.coordinates.begin() + 3,
+                                        secondPoint.coordinates.begin(), 0.0, 1.0);
+
+    // Turn by 350 degrees is turn by -10 degrees.
+    double sumOfSquares = 0.0;
+    for (std::size_t i = 3; i < RobotData::NUMBER_OF_COORDINATES; ++i)
+    {
+        const double turn = std::remainder(
+            static_cast<double>(secondPoint.coordinates[i] - firstPoint.coordinates[i]),
+            kFullTurn);
+        sumOfSquares += turn * turn;
     }
+    movement.angle = std::sqrt(sumOfSquares);
 
-    return !_distanceToTimeTable.empty();
+    movement.segmentTime = secondPoint.parameters[0];
+    movement.motionType = secondPoint.parameters[1];
+    return movement;
 }
 
-std::chrono::milliseconds DelayManager::calculateDuration(const RobotData& firstPoint,
+std::chrono::microseconds DelayManager::calculateDuration(const RobotData& firstPoint,
                                                           const RobotData& secondPooint) const
 {
-    if (!_hasReadTable)
+    return calculateDuration(describeMovement(firstPoint, secondPooint));
+}
+
+std::chrono::microseconds DelayManager::calculateDuration(const Movement& movement) const
+{
+    // Empty table gives zero, so points are sent without waiting.
+    const Model* model = findModel(movement.motionType);
+    if (model == nullptr)
     {
-        _printer.writeLine(std::cout, "Not read data table!");
-        return std::chrono::milliseconds(0LL);
+        return std::chrono::microseconds(0LL);
     }
 
-    // Calculate distance between two points, which contains only first 3 coordinates.
-    const long long distance    = utils::distance(firstPoint.coordinates.begin(),
-                                                  firstPoint.coordinates.begin() + 2,
-                                                  secondPooint.coordinates.begin(), 0LL, 1LL);
+    const double time = std::max(model->grid.evaluate(movement.distance, movement.angle),
+                                 movement.segmentTime * kMicrosecondsPerUnit);
+    const std::chrono::microseconds duration(std::llround(time));
 
-    // "low" is not less than (i.e. greater or equal to) "distance",
-    // or last if no such element is found.
-    const auto low = _distanceToTimeTable.lower_bound(distance);
-    
-    if (low == _distanceToTimeTable.end())
+    if (_isLogging)
     {
-        const auto it = --_distanceToTimeTable.end();
-        _printer.writeLine(std::cout, "Distance:", it->first, " Duration:", it->second.count());
-        return it->second;
+        _printer.writeLine(std::cout, "Distance:", movement.distance, "Angle:", movement.angle,
+                           "Type:", movement.motionType, " Duration:", duration.count());
     }
-    if (low == _distanceToTimeTable.begin())
+    return duration;
+}
+
+bool DelayManager::hasDataTable() const noexcept
+{
+    return !_models.empty();
+}
+
+void DelayManager::setLearningRate(const double learningRate) noexcept
+{
+    _learningRate = std::clamp(learningRate, 0.0, 1.0);
+}
+
+bool DelayManager::isCalibrating() const noexcept
+{
+    return _learningRate > 0.0 && !_models.empty();
+}
+
+DelayManager::Calibration DelayManager::calibrate(const Movement& movement,
+                                                  const std::chrono::microseconds duration)
+{
+    if (!isCalibrating())
     {
-        _printer.writeLine(std::cout, "Distance:", low->first, " Duration:", low->second.count());
-        return low->second;
+        return Calibration::SKIPPED;
     }
-    
-    auto prev = low;
-    --prev;
 
-    // "prev" is less or equal to distance. 
-    if (distance - prev->first < low->first - distance)
+    // Movement limited by segtime says nothing about table.
+    const double predicted = findModel(movement.motionType)->grid.evaluate(movement.distance,
+                                                                            movement.angle);
+    if (movement.segmentTime * kMicrosecondsPerUnit >= predicted)
     {
-        _printer.writeLine(std::cout, "Distance:", prev->first,
-                           " Duration:", prev->second.count());
-        return prev->second;
+        return Calibration::SKIPPED;
     }
 
-    _printer.writeLine(std::cout, "Distance:", low->first, " Duration:", low->second.count());
-    return low->second;
+    const double observed = static_cast<double>(duration.count());
+    const double error = std::abs(observed - predicted);
+    const double threshold = kOutlierFactor * std::max(_meanAbsoluteError, kMinRejectedError);
+    const bool isOutlier = _observations >= kWarmUpObservations && error > threshold;
+
+    // Mean error uses even rejected observations, otherwise lasting change is never accepted.
+    _meanAbsoluteError = _observations == 0
+                       ? error
+                       : _meanAbsoluteError + kErrorSmoothing * (error - _meanAbsoluteError);
+    ++_observations;
+
+    if (isOutlier)
+    {
+        return Calibration::REJECTED;
+    }
+    if (_observations <= kWarmUpObservations)
+    {
+        return Calibration::SKIPPED;
+    }
+
+    auto it = std::find_if(_models.begin(), _models.end(), [&movement](const Model& model)
+    {
+        return model.motionType == movement.motionType;
+    });
+    if (it == _models.end())
+    {
+        _models.push_back({ movement.motionType, findModel(movement.motionType)->grid });
+        it = std::prev(_models.end());
+    }
+
+    it->grid.adapt(movement.distance, movement.angle, observed, _learningRate);
+    _hasUnsavedChanges = true;
+    return Calibration::ACCEPTED;
+}
+
+double DelayManager::getMeanAbsoluteError() const noexcept
+{
+    return _meanAbsoluteError;
+}
+
+bool DelayManager::hasUnsavedChanges() const noexcept
+{
+    return _hasUnsavedChanges;
+}
+
+bool DelayManager::loadDataTable(const std::string& fileName, const bool isMapped)
+{
+    std::ifstream input(fileName, std::ios::binary);
+    if (!input.is_open())
+    {
+        return false;
+    }
+
+    char magic[sizeof(kTableMagic)] = {};
+    input.read(magic, sizeof(magic));
+    if (input.gcount() == sizeof(magic) && std::memcmp(magic, kTableMagic, sizeof(magic)) == 0)
+    {
+        input.close();
+        return readBinaryTable(fileName, isMapped);
+    }
+
+    input.clear();
+    input.seekg(0);
+    return readDataTable(input);
+}
+
+bool DelayManager::saveDataTable(const std::string& fileName)
+{
+    std::ofstream output(fileName, std::ios::binary | std::ios::trunc);
+    if (!output.is_open() || _models.empty())
+    {
+        return false;
+    }
+
+    TableHeader header{};
+    std::memcpy(header.magic, kTableMagic, sizeof(kTableMagic));
+    header.version = kTableVersion;
+    header.numberOfModels = static_cast<std::uint32_t>(_models.size());
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // All sizes are multiples of 8, so every array of doubles is aligned in mapped file.
+    std::uint64_t offset = sizeof(TableHeader) + _models.size() * sizeof(ModelHeader);
+    for (const Model& model : _models)
+    {
+        const std::size_t rows = model.grid.getNumberOfRows();
+        const std::size_t columns = model.grid.getNumberOfColumns();
+
+        ModelHeader entry{};
+        entry.motionType = model.motionType;
+        entry.numberOfRows = static_cast<std::uint32_t>(rows);
+        entry.numberOfColumns = static_cast<std::uint32_t>(columns);
+        entry.offset = offset;
+        output.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+
+        offset += (rows + columns + rows * columns) * sizeof(double);
+    }
+
+    for (const Model& model : _models)
+    {
+        const std::size_t rows = model.grid.getNumberOfRows();
+        const std::size_t columns = model.grid.getNumberOfColumns();
+        output.write(reinterpret_cast<const char*>(model.grid.getRows()),
+                     static_cast<std::streamsize>(rows * sizeof(double)));
+        output.write(reinterpret_cast<const char*>(model.grid.getColumns()),
+                     static_cast<std::streamsize>(columns * sizeof(double)));
+        output.write(reinterpret_cast<const char*>(model.grid.getValues()),
+                     static_cast<std::streamsize>(rows * columns * sizeof(double)));
+    }
+
+    _hasUnsavedChanges = !output.good();
+    return output.good();
+}
+
+const DelayManager::Model* DelayManager::findModel(const int motionType) const noexcept
+{
+    // There are only few types of movement, linear search is the fastest one.
+    const Model* result = _models.empty() ? nullptr : &_models.front();
+    for (const Model& model : _models)
+    {
+        if (model.motionType == motionType)
+        {
+            return &model;
+        }
+        if (model.motionType == ANY_MOTION_TYPE)
+        {
+            result = &model;
+        }
+    }
+    return result;
+}
+
+bool DelayManager::readBinaryTable(const std::string& fileName, const bool isMapped)
+{
+    auto file = std::make_shared<QFile>(QString::fromStdString(fileName));
+    if (!file->open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    const auto size = static_cast<std::uint64_t>(file->size());
+    const uchar* data = size >= sizeof(TableHeader) ? file->map(0, file->size()) : nullptr;
+    if (data == nullptr)
+    {
+        _printer.writeLine(std::cout, "Failed to map data table", fileName);
+        return false;
+    }
+
+    TableHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.version != kTableVersion || header.numberOfModels == 0
+        || sizeof(TableHeader) + header.numberOfModels * sizeof(ModelHeader) > size)
+    {
+        _printer.writeLine(std::cout, "Unsupported data table", fileName, "version",
+                           header.version);
+        return false;
+    }
+
+    std::vector<Model> models;
+    for (std::uint32_t i = 0; i < header.numberOfModels; ++i)
+    {
+        ModelHeader entry;
+        std::memcpy(&entry, data + sizeof(TableHeader) + i * sizeof(ModelHeader),
+                    sizeof(entry));
+
+        // Every check is done once here, so lookup trusts mapped memory.
+        const std::uint64_t rows = entry.numberOfRows;
+        const std::uint64_t columns = entry.numberOfColumns;
+        if (rows == 0 || columns == 0 || rows * columns > size / sizeof(double)
+            || entry.offset % alignof(double) != 0 || entry.offset > size
+            || (rows + columns + rows * columns) * sizeof(double) > size - entry.offset)
+        {
+            _printer.writeLine(std::cout, "Failed to read data table from file!");
+            return false;
+        }
+
+        const auto* arguments = reinterpret_cast<const double*>(data + entry.offset);
+        const double* values = arguments + rows + columns;
+        if (!isStrictlyIncreasing(arguments, rows)
+            || !isStrictlyIncreasing(arguments + rows, columns))
+        {
+            _printer.writeLine(std::cout, "Failed to read data table from file!");
+            return false;
+        }
+
+        models.push_back({ entry.motionType, isMapped
+            ? utils::InterpolationGrid(arguments, rows, arguments + rows, columns, values)
+            : utils::InterpolationGrid(std::vector<double>(arguments, arguments + rows),
+                                       std::vector<double>(arguments + rows, values),
+                                       std::vector<double>(values, values + rows * columns)) });
+    }
+
+    _models = std::move(models);
+    _mappedFile = isMapped ? std::move(file) : nullptr;
+    return true;
+}
+
+bool DelayManager::readDataTable(std::istream& input)
+{
+    std::map<int, std::vector<Sample>> samples;
+    std::string line;
+    while (std::getline(input, line))
+    {
+        std::istringstream stream(line);
+        std::vector<double> numbers;
+        for (double number; stream >> number;)
+        {
+            numbers.push_back(number);
+        }
+
+        if (numbers.empty() && stream.eof())
+        {
+            continue;
+        }
+        if (numbers.size() == 2 && stream.eof())
+        {
+            samples[ANY_MOTION_TYPE].push_back(
+                { numbers[0], 0.0, numbers[1] * kMicrosecondsPerUnit });
+            continue;
+        }
+        if (numbers.size() == 4 && stream.eof())
+        {
+            samples[static_cast<int>(numbers[0])].push_back(
+                { numbers[1], numbers[2], numbers[3] * kMicrosecondsPerUnit });
+            continue;
+        }
+
+        _printer.writeLine(std::cout, "Failed to read data table from file!");
+        return false;
+    }
+
+    if (samples.empty())
+    {
+        _printer.writeLine(std::cout, "Failed to read data table from file!");
+        return false;
+    }
+
+    _models.clear();
+    _mappedFile.reset();
+    for (const auto& [motionType, typeSamples] : samples)
+    {
+        _models.push_back({ motionType, makeGrid(typeSamples) });
+    }
+    return true;
 }
 
 } // namespace vasily
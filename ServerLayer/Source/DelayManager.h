@@ -2,7 +2,12 @@
 #define DELAY_MANAGER_H
 
 #include <chrono>
-#include <map>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <QFile>
 
 #include "Utilities.h"
 
@@ -11,52 +16,240 @@ namespace vasily
 {
 
 /**
- * \brief Class used to calculate delays which are based on real experiments.
+ * \brief   Class used to calculate delays which are based on real experiments.
+ * \details Duration depends on translational and angular distance of movement (bilinear
+ *          interpolation in table), every type of movement has its own table. Table measured
+ *          once is only a starting point: durations observed on robot correct it, so pacing
+ *          follows current payload and speed override. Every robot connection keeps its own
+ *          copy, so no locking is needed.
+ *
+ *          Binary table is memory-mapped and used without parsing, all copies share mapping
+ *          until they correct table. Binary format (native byte order):
+ *          header      - magic "VDLY", version, number of tables, reserved (4 x 4 bytes);
+ *          table entry - type of movement, number of rows, number of columns, reserved
+ *                        (4 x 4 bytes), offset of data from the beginning of file (8 bytes);
+ *          table data  - rows, columns and values row by row (doubles, time in microseconds).
  */
 class DelayManager
 {
 public:
     /**
-     * \brief             Constructor which copies printer reference and using logger reference
-     *                    reads data in dictionary (std::map).
-     * \param[in] printer Reference to single instance of Printer.
-     * \param[out] logger Reference to instance which could read data table.
+     * \brief Array of results of correcting table with observed duration.
+     */
+    enum class Calibration
+    {
+        SKIPPED,
+        ACCEPTED,
+        REJECTED
+    };
+
+    /**
+     * \brief Structure which keeps everything duration of movement depends on.
+     */
+    struct Movement
+    {
+        /**
+         * \brief Translational distance in units of RobotData.
+         */
+        double  distance;
+
+        /**
+         * \brief Angular distance of orientation in thousandths of degree.
+         */
+        double  angle;
+
+        /**
+         * \brief Segtime of point in milliseconds (movement is never faster).
+         */
+        int     segmentTime;
+
+        /**
+         * \brief Type of movement (0 - FINE, 2 - NOVAR+NODECEL).
+         */
+        int     motionType;
+    };
+
+    /**
+     * \brief Type of movement of table which is used if type has no own table.
+     */
+    static constexpr int ANY_MOTION_TYPE = -1;
+
+
+    /**
+     * \brief               Constructor which copies printer reference and reads table.
+     * \param[in] printer   Reference to single instance of Printer.
+     * \param[in] fileName  Name of file with binary (mapped) or text table.
+     * \param[in] isLogging Flag used to print every calculated duration.
      */
-    DelayManager(printer::Printer& printer, logger::Logger& logger);
+    DelayManager(printer::Printer& printer, const std::string& fileName,
+                 const bool isLogging = false);
+
+    /**
+     * \brief             Get everything duration of movement depends on.
+     * \param firstPoint  First point of movement.
+     * \param secondPoint Second point of movement (its parameters are used).
+     * \return            Description of movement.
+     */
+    static Movement describeMovement(const RobotData& firstPoint, const RobotData& secondPoint);
 
     /**
      * \brief              Calculate duration for currrent movement section between two points.
      * \param firstPoint   Fiirst point of movement.
      * \param secondPooint Second point of movement.
-     * \return             Approximately duration in milliseconds.
+     * \return             Approximately duration in microseconds.
      */
-    std::chrono::milliseconds calculateDuration(const RobotData& firstPoint,
+    std::chrono::microseconds calculateDuration(const RobotData& firstPoint,
                                                 const RobotData& secondPooint) const;
 
+    /**
+     * \brief              Calculate duration of movement.
+     * \param[in] movement Movement calculated by describeMovement.
+     * \return             Approximately duration in microseconds.
+     */
+    std::chrono::microseconds calculateDuration(const Movement& movement) const;
+
+    /**
+     * \brief  Check if any table was read.
+     * \return True if durations are predicted.
+     */
+    bool hasDataTable() const noexcept;
+
+    /**
+     * \brief                  Set weight of observed durations.
+     * \param[in] learningRate Weight in range [0, 1], zero turns calibration off.
+     */
+    void setLearningRate(const double learningRate) noexcept;
+
+    /**
+     * \brief  Check if observed durations correct table.
+     * \return True if learning rate is not zero and table is not empty.
+     */
+    bool isCalibrating() const noexcept;
+
+    /**
+     * \brief              Correct table with duration observed on robot.
+     * \details            Observation which differs from prediction much more than usual is
+     *                     rejected (e.g. robot waited for operator), but it still raises usual
+     *                     error, so lasting change of robot speed is accepted after a while.
+     *                     Type of movement without own table gets copy of common one.
+     * \param[in] movement Movement calculated by describeMovement.
+     * \param[in] duration Observed duration of movement.
+     * \return             SKIPPED if calibration is off, usual error is being estimated yet or
+     *                     duration was limited by segtime.
+     */
+    Calibration calibrate(const Movement& movement, const std::chrono::microseconds duration);
+
+    /**
+     * \brief  Get smoothed absolute difference between observed and predicted durations.
+     * \return Mean error in microseconds.
+     */
+    double getMeanAbsoluteError() const noexcept;
+
+    /**
+     * \brief  Check if table was corrected after the last saving.
+     * \return True if table has to be saved.
+     */
+    bool hasUnsavedChanges() const noexcept;
+
+    /**
+     * \brief              Read table from binary or text file (format is found by magic).
+     * \param[in] fileName Name of file.
+     * \param[in] isMapped Flag used to map binary file instead of copying it (mapped file
+     *                     can't be overwritten while it's used).
+     * \return             True if file had correct non-empty table.
+     */
+    bool loadDataTable(const std::string& fileName, const bool isMapped = false);
+
+    /**
+     * \brief              Write table to binary file.
+     * \param[in] fileName Name of file.
+     * \return             True if writing was successful.
+     */
+    bool saveDataTable(const std::string& fileName);
+
 
 private:
+    /**
+     * \brief Table of durations for one type of movement.
+     */
+    struct Model
+    {
+        /**
+         * \brief Type of movement or ANY_MOTION_TYPE.
+         */
+        int                         motionType;
+
+        /**
+         * \brief Durations in microseconds by translational (rows) and angular (columns)
+         *        distances.
+         */
+        utils::InterpolationGrid    grid;
+    };
+
     /**
      * \brief Implementation of type-safe output printer.
      */
     printer::Printer& _printer;
 
     /**
-     * \brief Flag used to know if data table successful read or not.
+     * \brief Flag used to print every calculated duration.
+     */
+    bool        _isLogging;
+
+    /**
+     * \brief Tables of all types of movement.
+     */
+    std::vector<Model> _models;
+
+    /**
+     * \brief Mapped binary file which tables use (nullptr if tables own their data).
+     */
+    std::shared_ptr<QFile> _mappedFile;
+
+    /**
+     * \brief Weight of observed durations.
      */
-    bool        _hasReadTable;
+    double      _learningRate;
 
     /**
-     * \brief Data table which keeps compliance with distance and time.
+     * \brief Smoothed absolute error of prediction in microseconds.
      */
-    std::map<long long, std::chrono::milliseconds> _distanceToTimeTable;
+    double      _meanAbsoluteError;
 
+    /**
+     * \brief Number of observed durations.
+     */
+    std::size_t _observations;
+
+    /**
+     * \brief Flag used to know if table was corrected after the last saving.
+     */
+    bool        _hasUnsavedChanges;
+
+
+    /**
+     * \brief                Find table for type of movement.
+     * \param[in] motionType Type of movement.
+     * \return               Own table of type, common table or nullptr if there are no tables.
+     */
+    const Model* findModel(const int motionType) const noexcept;
+
+    /**
+     * \brief              Read binary table.
+     * \param[in] fileName Name of file.
+     * \param[in] isMapped Flag used to map file instead of copying it.
+     * \return             True if file had correct non-empty table.
+     */
+    bool readBinaryTable(const std::string& fileName, const bool isMapped);
 
     /**
-     * \brief            Read data from file into container.
-     * \param[in] logger Instance of logger which used to read data from file.
-     * \return           True if reading was successful, false otherwise.
+     * \brief           Read data from stream into container.
+     * \details         Line is "distance time" (common table of old format) or
+     *                  "type distance angle time", time is in milliseconds.
+     * \param[in] input Stream with table.
+     * \return          True if reading was successful, false otherwise.
      */
-    bool readDataTable(logger::Logger& logger);
+    bool readDataTable(std::istream& input);
 };
 
 } // namespace vasily
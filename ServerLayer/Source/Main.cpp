@@ -1,4 +1,8 @@
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
 
 #include <QtCore/QCoreApplication>
 
@@ -12,16 +16,62 @@ int main(int argc, char *argv[])
     auto& printer = printer::Printer::getInstance();
     printer(std::cout, "Server layer for connecting from client to Fanuc M-20iA v 0.1\n\n");
 
+    // Converter mode: ServerLayer --convert-delays <text table> <binary table>.
+    if (argc >= 4 && std::strcmp(argv[1], "--convert-delays") == 0)
+    {
+        vasily::DelayManager delayManager(printer, argv[2]);
+        if (!delayManager.hasDataTable() || !delayManager.saveDataTable(argv[3]))
+        {
+            printer.writeLine(std::cout, "ERROR 10: Delay table", argv[2], "is not converted!");
+            return 1;
+        }
+        printer.writeLine(std::cout, "Delay table", argv[2], "converted to", argv[3]);
+        return 0;
+    }
+
     constexpr int  kServerReceivingPort = 9998;
     constexpr int  kServerSendingPort = 9999;
     constexpr char kServerIP[] = "192.168.0.101";
     constexpr int  kLayerPort = 8888;
 
-    vasily::ServerLayer serverLayer(kServerReceivingPort, kServerSendingPort, kServerIP, kLayerPort);
+    // Arbitration policy: ServerLayer [--arbitration fifo|round-robin|exclusive].
+    std::string_view policyName =
+        vasily::ServerLayer::CONFIG.get<vasily::ServerLayer::Param::ARBITRATION_POLICY>();
+    if (argc >= 3 && std::strcmp(argv[1], "--arbitration") == 0)
+    {
+        policyName = argv[2];
+    }
+    const auto arbitration = vasily::Arbiter::parsePolicy(policyName);
+    if (!arbitration.has_value())
+    {
+        printer.writeLine(std::cout, "ERROR 13: Unknown arbitration policy",
+                          std::string(policyName) + '!');
+        return 1;
+    }
+
+    // Robots list from file takes precedence over single robot parameters.
+    const auto endpoints = vasily::RobotConnection::readEndpoints(
+        vasily::ServerLayer::CONFIG.get<vasily::ServerLayer::Param::DEFAULT_ROBOTS_FILE_NAME>());
+
+    std::unique_ptr<vasily::ServerLayer> serverLayer;
+    if (endpoints.empty())
+    {
+        serverLayer = std::make_unique<vasily::ServerLayer>(kServerReceivingPort,
+                                                            kServerSendingPort, kServerIP,
+                                                            kLayerPort,
+                                                            vasily::ServerLayer::WorkMode::SAFE,
+                                                            *arbitration);
+    }
+    else
+    {
+        serverLayer = std::make_unique<vasily::ServerLayer>(endpoints,
+                                                            vasily::ServerLayer::WorkMode::SAFE,
+                                                            *arbitration);
+    }
 
     ///vasily::ServerLayer serverLayer{};
 
-    serverLayer.launch();
+    serverLayer->launch();
 
     return a.exec();
 }
@@ -0,0 +1,916 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <utility>
+
+#include "ServerLayer.h"
+
+#include "RobotConnection.h"
+
+
+namespace vasily
+{
+
+RobotConnection::RobotConnection(const std::size_t robotId, const Endpoint& endpoint,
+                                 const DelayManager& delayManager, logger::Logger& logger,
+                                 capture::CaptureWriter* capture, QObject* parent)
+    : QObject(parent),
+      _robotId(robotId),
+      _endpoint(endpoint),
+      _receivingSocket(std::make_unique<QTcpSocket>(this)),
+      _sendingSocket(std::make_unique<QTcpSocket>(this)),
+      _fallbackTimer(std::make_unique<QTimer>(this)),
+      _reconnectTimer(std::make_unique<QTimer>(this)),
+      _connectionTimer(std::make_unique<QTimer>(this)),
+      _heartbeatTimer(std::make_unique<QTimer>(this)),
+      _delayTableTimer(std::make_unique<QTimer>(this)),
+      _state(State::DISCONNECTED),
+      _backoff(std::chrono::milliseconds(
+                   ServerLayer::CONFIG.get<ServerLayer::Param::RECONNECTION_DELAY>()),
+               std::chrono::milliseconds(
+                   ServerLayer::CONFIG.get<ServerLayer::Param::MAX_RECONNECTION_DELAY>())),
+      _heartbeat(ServerLayer::CONFIG.get<ServerLayer::Param::MAX_MISSED_HEARTBEATS>()),
+      _messagesStorage(ServerLayer::CONFIG.get<ServerLayer::Param::MAX_MERGED_COMMANDS>()),
+      _inFlightPoints(ServerLayer::CONFIG.get<ServerLayer::Param::ACK_WINDOW>(),
+                      ServerLayer::CONFIG.get<ServerLayer::Param::ACK_WINDOW>()),
+      _sendingFormat(protocol::WireFormat::TEXT),
+      _sequence(0),
+      _logger(logger),
+      _delayManager(delayManager),
+      _delayTableFileName(ServerLayer::CONFIG.get<ServerLayer::Param::DELAY_TABLE_FILE_PREFIX>()
+                          + std::to_string(robotId) + ".bin"),
+      _capture(capture),
+      _traces({ "receive", "enqueue", "dispatch", "robot ack" },
+              ServerLayer::CONFIG.get<ServerLayer::Param::TRACE_FILE_PREFIX>()
+              + std::to_string(robotId) + ".txt"),
+      _statistics(),
+      _lastAnswerTime(),
+      _idleTime(0),
+      _priorityLatencies()
+{
+    _printer.writeLine(std::cout, "Robot", robotId, "Server Receiving Port:",
+                       endpoint.serverReceivingPort, "Server Sending Port:",
+                       endpoint.serverSendingPort, "Server IP:", endpoint.serverIP,
+                       "Layer Port:", endpoint.layerPort);
+
+    connect(_receivingSocket.get(), &QTcpSocket::readyRead, this,
+            &RobotConnection::slotReadFromServer);
+
+    // Connection is established and lost through events only, so thread never blocks.
+    for (QTcpSocket* socket : { _receivingSocket.get(), _sendingSocket.get() })
+    {
+        connect(socket, &QTcpSocket::connected, this, &RobotConnection::slotSocketConnected);
+        connect(socket, &QTcpSocket::stateChanged, this,
+                &RobotConnection::slotSocketStateChanged);
+    }
+
+    connect(this, &RobotConnection::signalToSendToServer, this,
+            &RobotConnection::slotSendDataToServer);
+
+    // Unterminated robot can't separate points, so only one of them waits for answer.
+    _inFlightPoints.setUnterminated(isRawTextLink());
+
+    _fallbackTimer->setSingleShot(true);
+    _fallbackTimer->setTimerType(Qt::PreciseTimer);
+    connect(_fallbackTimer.get(), &QTimer::timeout, this, &RobotConnection::slotAnswerTimedOut);
+
+    _reconnectTimer->setSingleShot(true);
+    connect(_reconnectTimer.get(), &QTimer::timeout, this, &RobotConnection::startConnecting);
+
+    _connectionTimer->setSingleShot(true);
+    connect(_connectionTimer.get(), &QTimer::timeout, this,
+            &RobotConnection::slotConnectionTimedOut);
+
+    _heartbeatTimer->setInterval(static_cast<int>(
+        ServerLayer::CONFIG.get<ServerLayer::Param::HEARTBEAT_INTERVAL>()));
+    connect(_heartbeatTimer.get(), &QTimer::timeout, this, &RobotConnection::slotHeartbeat);
+
+    // Table corrected on previous launch is closer to this robot than measured one.
+    if (_delayManager.loadDataTable(_delayTableFileName))
+    {
+        _printer.writeLine(std::cout, "Robot", robotId, "uses delay table", _delayTableFileName);
+    }
+    _delayManager.setLearningRate(
+        ServerLayer::CONFIG.get<ServerLayer::Param::DELAY_LEARNING_RATE>());
+
+    _delayTableTimer->setInterval(static_cast<int>(
+        ServerLayer::CONFIG.get<ServerLayer::Param::DELAY_SAVE_PERIOD>()));
+    connect(_delayTableTimer.get(), &QTimer::timeout, this,
+            &RobotConnection::slotSaveDelayTable);
+}
+
+std::size_t RobotConnection::getRobotId() const noexcept
+{
+    return _robotId;
+}
+
+const RobotConnection::Endpoint& RobotConnection::getEndpoint() const noexcept
+{
+    return _endpoint;
+}
+
+RobotStatistics& RobotConnection::getStatistics() noexcept
+{
+    return _statistics;
+}
+
+std::size_t RobotConnection::getQueueSize() const noexcept
+{
+    return _messagesStorage.size();
+}
+
+std::chrono::steady_clock::time_point RobotConnection::getIdleTime() const noexcept
+{
+    return std::chrono::steady_clock::time_point(std::chrono::duration_cast<
+        std::chrono::steady_clock::duration>(std::chrono::microseconds(
+            _idleTime.load(std::memory_order_relaxed))));
+}
+
+bool RobotConnection::pushCommand(Command command)
+{
+    return _messagesStorage.tryPush(std::move(command));
+}
+
+void RobotConnection::dropSessionCommands(const std::size_t sessionId)
+{
+    dropSessionPoints(sessionId, std::numeric_limits<std::uint64_t>::max());
+    dispatchPoints();
+}
+
+std::vector<RobotConnection::Endpoint> RobotConnection::readEndpoints(const std::string& fileName)
+{
+    std::ifstream file(fileName);
+    std::vector<Endpoint> result;
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty())
+        {
+            continue;
+        }
+
+        std::stringstream lineStream(line);
+        Endpoint endpoint{};
+        if (!(lineStream >> endpoint.serverIP >> endpoint.serverReceivingPort
+                         >> endpoint.serverSendingPort >> endpoint.layerPort))
+        {
+            printer::Printer::getInstance().writeLine(std::cout, "ERROR 06: Incorrect robot "
+                                                      "description in file:", line);
+            return {};
+        }
+
+        // Wire format and framing are optional, robots work in unterminated text by default.
+        std::string wireFormat;
+        if (!(lineStream >> wireFormat))
+        {
+            wireFormat = "text";
+        }
+        std::string framing;
+        if (!(lineStream >> framing))
+        {
+            framing = "raw";
+        }
+        if (wireFormat == "binary")
+        {
+            endpoint.wireFormat = protocol::WireFormat::BINARY;
+        }
+        endpoint.isLineFramed = framing == "lines" || wireFormat == "binary";
+        if ((wireFormat != "text" && wireFormat != "binary")
+            || (framing != "raw" && framing != "lines"))
+        {
+            printer::Printer::getInstance().writeLine(std::cout, "ERROR 06: Incorrect robot "
+                                                      "description in file:", line);
+            return {};
+        }
+
+        result.emplace_back(std::move(endpoint));
+    }
+
+    return result;
+}
+
+void RobotConnection::launch()
+{
+    // Table of this robot may differ from default one which layer starts with.
+    emit signalDelayTableChanged(_robotId, std::make_shared<const DelayManager>(_delayManager));
+
+    if (_delayManager.isCalibrating() && _delayTableTimer->interval() > 0)
+    {
+        _delayTableTimer->start();
+    }
+    startConnecting();
+}
+
+void RobotConnection::slotSocketConnected()
+{
+    if (_state == State::CONNECTING
+        && _sendingSocket->state() == QAbstractSocket::ConnectedState
+        && _receivingSocket->state() == QAbstractSocket::ConnectedState)
+    {
+        onConnected();
+    }
+}
+
+void RobotConnection::slotSocketStateChanged(const QAbstractSocket::SocketState state)
+{
+    if (state != QAbstractSocket::UnconnectedState)
+    {
+        return;
+    }
+
+    switch (_state)
+    {
+        case State::CONNECTING:
+            _printer.writeLine(std::cout, "Not connected to robot", _robotId, '!');
+            scheduleReconnect();
+            break;
+
+        case State::CONNECTED:
+            onConnectionLost();
+            break;
+
+        case State::DISCONNECTED:
+            // Sockets are closed by connection itself.
+            break;
+
+        default:
+            assert(false);
+            break;
+    }
+}
+
+void RobotConnection::slotConnectionTimedOut()
+{
+    if (_state == State::CONNECTING)
+    {
+        _printer.writeLine(std::cout, "Connection to robot", _robotId, "timed out!");
+        scheduleReconnect();
+    }
+}
+
+void RobotConnection::slotReadFromServer()
+{
+    if (_receivingSocket->bytesAvailable() > 0)
+    {
+        const QByteArray array = _receivingSocket->readAll();
+        const auto readTime = std::chrono::steady_clock::now();
+        _statistics.add(RobotStatistics::BYTES_FROM_ROBOT,
+                        static_cast<std::uint64_t>(array.size()));
+        if (_capture != nullptr)
+        {
+            _capture->write(capture::Event::FROM_ROBOT, _robotId, 0,
+                            { array.constData(), static_cast<std::size_t>(array.size()) });
+        }
+
+        // Unterminated robot has only one unanswered point, so piece holds one answer.
+        const bool isRawText = isRawTextLink();
+        std::optional<std::string> rawFrame;
+        if (isRawText)
+        {
+            std::string_view chunk(array.constData(), static_cast<std::size_t>(array.size()));
+            while (!chunk.empty() && (chunk.back() == '\n' || chunk.back() == '\r'))
+            {
+                chunk.remove_suffix(1);
+            }
+            rawFrame = std::string(chunk);
+        }
+        else
+        {
+            // Several answers may come in one piece, every one of them belongs to its own point.
+            _framer.append({ array.constData(), static_cast<std::size_t>(array.size()) });
+        }
+        auto nextFrame = [this, isRawText, &rawFrame]()
+        {
+            return isRawText ? std::exchange(rawFrame, std::nullopt) : _framer.nextMessage();
+        };
+
+        while (const auto frame = nextFrame())
+        {
+            std::optional<protocol::Message> message;
+            if (_framer.getFormat() == protocol::WireFormat::BINARY)
+            {
+                message = protocol::decode(*frame);
+                if (!message.has_value())
+                {
+                    _printer.writeLine(std::cout, "ERROR 07: Incorrect binary message received!");
+                    continue;
+                }
+            }
+            else if (*frame == protocol::HANDSHAKE_BINARY)
+            {
+                // Robot confirmed binary format, everything after confirmation is binary.
+                _framer.setFormat(protocol::WireFormat::BINARY);
+                continue;
+            }
+            else
+            {
+                message = protocol::parseHeartbeat(*frame);
+                if (!message.has_value())
+                {
+                    message = protocol::makeText(*frame);
+                }
+            }
+
+            // Pongs belong to connection itself and are never shown to clients.
+            if (message->type == protocol::MessageType::PONG)
+            {
+                if (const auto roundTrip = _heartbeat.receivePong(*message))
+                {
+                    _logger.writeLine("Robot", _robotId, "round-trip time",
+                                      roundTrip->count(), "us");
+                }
+                continue;
+            }
+
+            // Answers which don't match any sent point (e.g. greetings) are sent to everyone.
+            std::size_t sessionId = ClientSession::BROADCAST;
+            if (auto completion = completeInFlightPoint(*message); completion.has_value())
+            {
+                InFlightPoint& point = completion->value;
+                sessionId         = point.command.sessionId;
+                message->sequence = point.command.sequence;
+                recordTrace(point);
+                // Late answer shows stop of robot (e.g. feed hold), not duration of movement.
+                if (!completion->isOverdue)
+                {
+                    recordPrediction(point, readTime);
+                }
+            }
+            _statistics.add(RobotStatistics::ANSWERS);
+            emit signalAnswerReceived(_robotId, sessionId, *message);
+
+            _logger.writeLine(_receivingSocket->localPort(), '-', protocol::toText(*message));
+        }
+
+        // Answers freed places in window, so robot buffer can be filled again.
+        releaseLostPoints();
+        dispatchPoints();
+    }
+}
+
+void RobotConnection::slotSendDataToServer(const QByteArray& data)
+{
+    writeToServer(data);
+    if (_sendingFormat == protocol::WireFormat::BINARY)
+    {
+        _printer.writeLine(std::cout, "Sent", data.size(), "bytes to robot", _robotId,
+                           "successfully.\n");
+    }
+    else
+    {
+        _printer.writeLine(std::cout, "Sent data to robot", _robotId, ':', data.toStdString(),
+                           "successfully.\n");
+    }
+}
+
+void RobotConnection::writeToServer(QByteArray data)
+{
+    // Legacy controller doesn't expect delimiter, it reads whole piece as one message.
+    if (isRawTextLink() && data.endsWith(protocol::Framer::DELIMITER))
+    {
+        data.chop(1);
+    }
+
+    _sendingSocket->write(data);
+    _statistics.add(RobotStatistics::BYTES_TO_ROBOT, static_cast<std::uint64_t>(data.size()));
+    if (_capture != nullptr)
+    {
+        _capture->write(capture::Event::TO_ROBOT, _robotId, 0,
+                        { data.constData(), static_cast<std::size_t>(data.size()) });
+    }
+}
+
+bool RobotConnection::isRawTextLink() const noexcept
+{
+    return _endpoint.wireFormat == protocol::WireFormat::TEXT && !_endpoint.isLineFramed;
+}
+
+void RobotConnection::slotAnswerTimedOut()
+{
+    static const std::chrono::milliseconds kAckTimeout(
+        ServerLayer::CONFIG.get<ServerLayer::Param::ACK_TIMEOUT>());
+
+    // Late answer is waited for one more timeout, then point is given up.
+    const auto now = std::chrono::steady_clock::now();
+    _inFlightPoints.expireOverdue(now);
+
+    if (!_inFlightPoints.empty() && _inFlightPoints.front().expectedFinish.has_value()
+        && *_inFlightPoints.front().expectedFinish + kAckTimeout <= now)
+    {
+        // Robot didn't answer in time predicted by DelayManager, don't let lost answer stall
+        // queue.
+        const InFlightPoint& point = _inFlightPoints.front();
+        _printer.writeLine(std::cout, "Warning: answer from robot", _robotId, "for point",
+                           point.sequence, "timed out!");
+        _logger.writeLine("Answer from robot", _robotId, "for point", point.sequence,
+                          "timed out at", utils::getCurrentSystemTime());
+
+        // Binary answer finds its point by number, text one would be given to the next point.
+        _inFlightPoints.timeOut(_framer.getFormat() == protocol::WireFormat::TEXT,
+                                now + kAckTimeout);
+        _statistics.add(RobotStatistics::TIMED_OUT_ANSWERS);
+    }
+
+    releaseLostPoints();
+    dispatchPoints();
+}
+
+void RobotConnection::releaseLostPoints()
+{
+    for (const InFlightPoint& point : _inFlightPoints.takeLost())
+    {
+        _logger.writeLine("Answer from robot", _robotId, "for point", point.sequence,
+                          "is lost at", utils::getCurrentSystemTime());
+        _statistics.add(RobotStatistics::LOST_ANSWERS);
+    }
+}
+
+void RobotConnection::slotHeartbeat()
+{
+    if (_state != State::CONNECTED)
+    {
+        _heartbeatTimer->stop();
+        return;
+    }
+
+    const protocol::Message ping = _heartbeat.makeNextPing();
+    if (!_heartbeat.isAlive())
+    {
+        // Socket may stay connected for minutes after robot controller hangs or cable is cut.
+        _printer.writeLine(std::cout, "Robot", _robotId, "didn't answer",
+                           _heartbeat.getMissedPongs(), "pings!");
+        onConnectionLost();
+        return;
+    }
+
+    // Ping keeps its own number for matching pong and isn't printed as regular data.
+    writeToServer(QByteArray::fromStdString(protocol::serialize(ping, _sendingFormat)));
+}
+
+void RobotConnection::slotSaveDelayTable()
+{
+    if (!_delayManager.hasUnsavedChanges())
+    {
+        return;
+    }
+    emit signalDelayTableChanged(_robotId, std::make_shared<const DelayManager>(_delayManager));
+
+    if (!_delayManager.saveDataTable(_delayTableFileName))
+    {
+        _printer.writeLine(std::cout, "ERROR 09: Delay table", _delayTableFileName,
+                           "is not saved!");
+        return;
+    }
+    _logger.writeLine("Robot", _robotId, "delay table saved, mean prediction error (us):",
+                      _delayManager.getMeanAbsoluteError());
+}
+
+void RobotConnection::dispatchPoints()
+{
+    // Points of disconnected sessions don't take place in window.
+    while (!_droppedSessions.empty())
+    {
+        const Command* front = _messagesStorage.front();
+        if (front == nullptr && _retryCommands.empty())
+        {
+            // Session is removed from layer before dropping, so its points never come again,
+            // points which arrive after flush of session are newer than its bound.
+            _droppedSessions.clear();
+            break;
+        }
+        if (front == nullptr || !isDropped(*front))
+        {
+            break;
+        }
+        _messagesStorage.tryPop();
+        emit signalCommandsReleased(_robotId, 1);
+    }
+
+    // Points wait in queue while link is down, they are sent after reconnection.
+    if (_state != State::CONNECTED)
+    {
+        return;
+    }
+
+    // Keep several points in robot buffer, so it doesn't stop between segments.
+    while (_inFlightPoints.hasPlace())
+    {
+        auto next = takeNextCommand();
+        if (!next.has_value())
+        {
+            break;
+        }
+        sendCommand(std::move(*next));
+    }
+    _statistics.setInFlight(_inFlightPoints.size());
+    updateIdleTime();
+
+    restartFallbackTimer();
+}
+
+void RobotConnection::dispatchPriorityCommand(const Command& command, const PriorityFlush flush)
+{
+    switch (flush)
+    {
+        case PriorityFlush::NONE:
+            break;
+
+        case PriorityFlush::SESSION:
+        {
+            // Points of session in queue are skipped later, others keep their order.
+            const std::size_t flushed = dropSessionPoints(command.sessionId,
+                                                          command.arrivalNumber);
+            _statistics.add(RobotStatistics::FLUSHED_POINTS, flushed);
+            _printer.writeLine(std::cout, "Priority point for robot", _robotId,
+                               "dropped queued points of session", command.sessionId);
+            break;
+        }
+
+        case PriorityFlush::ALL:
+        {
+            const std::size_t flushed = flushQueue();
+            _statistics.add(RobotStatistics::FLUSHED_POINTS, flushed);
+            _printer.writeLine(std::cout, "Priority point for robot", _robotId, "dropped",
+                               flushed, "queued points.");
+            break;
+        }
+    }
+
+    // Control point goes first after reconnection or answer of unterminated robot, queued
+    // points wait for it.
+    if (_state != State::CONNECTED || (isRawTextLink() && !_inFlightPoints.hasPlace()))
+    {
+        _retryCommands.push_front(command);
+        return;
+    }
+
+    // Points already sent to robot are in its buffer and can't be recalled, so control point
+    // follows them and doesn't wait for place in window.
+    sendCommand(command);
+    _sendingSocket->flush();
+    _statistics.setInFlight(_inFlightPoints.size());
+    updateIdleTime();
+    restartFallbackTimer();
+
+    const stats::Trace& trace = _inFlightPoints.back().command.trace;
+    const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+        trace.stamps[Command::Stage::DISPATCH] - trace.stamps[Command::Stage::RECEIVE]);
+    _priorityLatencies.record(latency);
+    _statistics.add(RobotStatistics::PRIORITY_COMMANDS);
+    _statistics.add(RobotStatistics::PRIORITY_DISPATCH_MICROSECONDS,
+                    static_cast<std::uint64_t>(std::max<long long>(0, latency.count())));
+    _logger.writeLine("Priority point for robot", _robotId, "dispatched in", latency.count(),
+                      "us, p99", _priorityLatencies.getPercentile(0.99).count(), "us");
+}
+
+void RobotConnection::sendCommand(Command command)
+{
+    // Robot works in one coordinate system for all, so switch it if client needs another.
+    if (command.coordinateSystem.has_value()
+        && command.coordinateSystem != _coorninateSystem)
+    {
+        _coorninateSystem = command.coordinateSystem;
+        sendMessage(protocol::makeCoordinateSystem(*_coorninateSystem));
+    }
+
+    // Text point forwarded without parsing has no coordinates, so it can't be predicted.
+    const bool isPredictable = command.rawFrame.empty()
+                            || _sendingFormat == protocol::WireFormat::BINARY;
+    const std::uint32_t sequence = command.rawFrame.empty()
+                                 ? sendMessage(protocol::makePoint(command.robotData))
+                                 : sendRawFrame(command.rawFrame);
+
+    std::optional<std::chrono::steady_clock::time_point> expectedFinish;
+    std::chrono::microseconds predictedDuration(0);
+    DelayManager::Movement movement{};
+    if (isPredictable)
+    {
+        // Robot starts this movement only after finishing previous ones.
+        auto start = std::chrono::steady_clock::now();
+        if (!_inFlightPoints.empty() && _inFlightPoints.back().expectedFinish.has_value())
+        {
+            start = std::max(start, *_inFlightPoints.back().expectedFinish);
+        }
+        movement = DelayManager::describeMovement(_lastReceivedPoint, command.robotData);
+        predictedDuration = _delayManager.calculateDuration(movement);
+        expectedFinish = start + predictedDuration;
+        _lastReceivedPoint = command.robotData;
+    }
+
+    // Text answer is checked against coordinates, forwarded frame has none.
+    std::optional<RobotData> point;
+    if (command.rawFrame.empty())
+    {
+        point = command.robotData;
+    }
+
+    command.trace.mark(Command::Stage::DISPATCH);
+    _inFlightPoints.push({ sequence, std::move(command), expectedFinish, predictedDuration,
+                           movement }, sequence, point);
+    _statistics.add(RobotStatistics::POINTS_OUT);
+}
+
+void RobotConnection::recordTrace(InFlightPoint& point)
+{
+    constexpr std::uint64_t kSummaryPeriod = 1000;
+
+    // Client finds its point by session and its own sequence number.
+    point.command.trace.mark(Command::Stage::ROBOT_ACK);
+    _traces.record(point.command.trace, std::to_string(point.command.sessionId) + ' '
+                                        + std::to_string(point.command.sequence));
+
+    if (_traces.getCount() % kSummaryPeriod == 0)
+    {
+        _logger.writeLine("Robot", _robotId, "latencies:", _traces.getSummary());
+    }
+}
+
+void RobotConnection::updateIdleTime() noexcept
+{
+    // Robot which has no predicted points in its buffer is idle already.
+    long long idleTime = 0;
+    if (!_inFlightPoints.empty() && _inFlightPoints.back().expectedFinish.has_value())
+    {
+        idleTime = std::chrono::duration_cast<std::chrono::microseconds>(
+            _inFlightPoints.back().expectedFinish->time_since_epoch()).count();
+    }
+    _idleTime.store(idleTime, std::memory_order_relaxed);
+}
+
+void RobotConnection::recordPrediction(const InFlightPoint& point,
+                                       const std::chrono::steady_clock::time_point now)
+{
+    const auto previousAnswerTime = _lastAnswerTime;
+    _lastAnswerTime = now;
+    if (point.predictedDuration.count() == 0
+        || !point.command.trace.isMarked(Command::Stage::DISPATCH))
+    {
+        return;
+    }
+
+    // Robot starts movement when it receives point or when it finishes previous one.
+    const auto start = std::max(point.command.trace.stamps[Command::Stage::DISPATCH],
+                                previousAnswerTime);
+    const auto actual = std::chrono::duration_cast<std::chrono::microseconds>(now - start);
+    const auto error = actual - point.predictedDuration;
+
+    _statistics.add(RobotStatistics::PREDICTIONS);
+    _statistics.add(RobotStatistics::PREDICTED_MICROSECONDS,
+                    static_cast<std::uint64_t>(point.predictedDuration.count()));
+    _statistics.add(RobotStatistics::ACTUAL_MICROSECONDS,
+                    static_cast<std::uint64_t>(std::max<long long>(0, actual.count())));
+    _statistics.add(RobotStatistics::PREDICTION_ERROR_MICROSECONDS,
+                    static_cast<std::uint64_t>(std::abs(error.count())));
+
+    switch (_delayManager.calibrate(point.movement, actual))
+    {
+        case DelayManager::Calibration::ACCEPTED:
+            _statistics.add(RobotStatistics::CALIBRATIONS);
+            break;
+        case DelayManager::Calibration::REJECTED:
+            _statistics.add(RobotStatistics::REJECTED_CALIBRATIONS);
+            break;
+        case DelayManager::Calibration::SKIPPED:
+            break;
+    }
+}
+
+void RobotConnection::restartFallbackTimer()
+{
+    static const std::chrono::milliseconds kAckTimeout(
+        ServerLayer::CONFIG.get<ServerLayer::Param::ACK_TIMEOUT>());
+
+    // Point without prediction waits for its answer as long as it takes.
+    auto deadline = _inFlightPoints.getOverdueDeadline();
+    if (!_inFlightPoints.empty() && _inFlightPoints.front().expectedFinish.has_value())
+    {
+        const auto answerDeadline = *_inFlightPoints.front().expectedFinish + kAckTimeout;
+        deadline = deadline.has_value() ? std::min(*deadline, answerDeadline) : answerDeadline;
+    }
+    if (!deadline.has_value())
+    {
+        _fallbackTimer->stop();
+        return;
+    }
+
+    // Timer must not fire before deadline, otherwise nothing is released.
+    const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(
+        *deadline - std::chrono::steady_clock::now());
+    _fallbackTimer->start(static_cast<int>(std::max<long long>(0, remaining.count())));
+}
+
+std::optional<protocol::AnswerWindow<RobotConnection::InFlightPoint>::Completion>
+RobotConnection::completeInFlightPoint(const protocol::Message& answer)
+{
+    // Text answers have no sequence number, robot answers points in order of sending.
+    if (_framer.getFormat() == protocol::WireFormat::TEXT)
+    {
+        return _inFlightPoints.completeText(protocol::toText(answer));
+    }
+
+    if (answer.type != protocol::MessageType::ANSWER)
+    {
+        return std::nullopt;
+    }
+    return _inFlightPoints.completeBinary(answer.sequence);
+}
+
+std::uint32_t RobotConnection::sendMessage(protocol::Message message)
+{
+    message.sequence = _sequence++;
+    emit signalToSendToServer(QByteArray::fromStdString(
+        protocol::serialize(message, _sendingFormat)));
+    return message.sequence;
+}
+
+std::uint32_t RobotConnection::sendRawFrame(std::string frame)
+{
+    const std::uint32_t sequence = _sequence++;
+    if (_sendingFormat == protocol::WireFormat::BINARY)
+    {
+        // Answer is matched by our sequence, client's one is kept in window.
+        protocol::setSequence(frame, sequence);
+    }
+    emit signalToSendToServer(QByteArray::fromStdString(frame));
+    return sequence;
+}
+
+std::size_t RobotConnection::flushQueue()
+{
+    std::size_t released = 0;
+    while (_messagesStorage.tryPop().has_value())
+    {
+        ++released;
+    }
+    if (released > 0)
+    {
+        emit signalCommandsReleased(_robotId, released);
+    }
+
+    const std::size_t flushed = released + _retryCommands.size();
+    _retryCommands.clear();
+    _droppedSessions.clear();
+    return flushed;
+}
+
+std::size_t RobotConnection::dropSessionPoints(const std::size_t sessionId,
+                                               const std::uint64_t bound)
+{
+    const auto it = std::remove_if(_retryCommands.begin(), _retryCommands.end(),
+                                   [sessionId, bound](const Command& command)
+                                   {
+                                       return command.sessionId == sessionId
+                                           && command.arrivalNumber < bound;
+                                   });
+    const auto dropped = static_cast<std::size_t>(std::distance(it, _retryCommands.end()));
+    _retryCommands.erase(it, _retryCommands.end());
+
+    // Ring can't remove points from the middle, they are skipped when reach its beginning.
+    if (!_messagesStorage.empty())
+    {
+        std::uint64_t& sessionBound = _droppedSessions[sessionId];
+        sessionBound = std::max(sessionBound, bound);
+    }
+    return dropped;
+}
+
+bool RobotConnection::isDropped(const Command& command) const
+{
+    const auto it = _droppedSessions.find(command.sessionId);
+    return it != _droppedSessions.end() && command.arrivalNumber < it->second;
+}
+
+std::optional<Command> RobotConnection::takeNextCommand()
+{
+    while (!_retryCommands.empty())
+    {
+        // These points were already released from queue before reconnection.
+        Command command = std::move(_retryCommands.front());
+        _retryCommands.pop_front();
+        if (!isDropped(command))
+        {
+            return command;
+        }
+    }
+
+    while (auto command = _messagesStorage.tryPop())
+    {
+        emit signalCommandsReleased(_robotId, 1);
+        if (!isDropped(*command))
+        {
+            return command;
+        }
+    }
+
+    return std::nullopt;
+}
+
+void RobotConnection::startConnecting()
+{
+    static const int kConnectionTimeout = static_cast<int>(
+        ServerLayer::CONFIG.get<ServerLayer::Param::CONNECTION_TIMEOUT>());
+
+    // Remember that sending socket should be connect to server receiving port
+    // and receiving socket should be connect to server sending port!
+    _state = State::DISCONNECTED;
+    _sendingSocket->abort();
+    _receivingSocket->abort();
+
+    _state = State::CONNECTING;
+    _sendingSocket->connectToHost(_endpoint.serverIP.c_str(), _endpoint.serverReceivingPort);
+    _receivingSocket->connectToHost(_endpoint.serverIP.c_str(), _endpoint.serverSendingPort);
+    _connectionTimer->start(kConnectionTimeout);
+}
+
+void RobotConnection::scheduleReconnect()
+{
+    _state = State::DISCONNECTED;
+    _connectionTimer->stop();
+    _heartbeatTimer->stop();
+    _sendingSocket->abort();
+    _receivingSocket->abort();
+
+    // Robot controller restarts take a while, don't flood it with attempts meanwhile.
+    const auto delay = _backoff.nextDelay();
+    _logger.writeLine("Reconnection to robot", _robotId, "attempt", _backoff.getAttempts(),
+                      "in", delay.count(), "ms");
+    _reconnectTimer->start(static_cast<int>(delay.count()));
+}
+
+void RobotConnection::onConnected()
+{
+    _state = State::CONNECTED;
+    _connectionTimer->stop();
+    _backoff.reset();
+    _printer.writeLine(std::cout, "Connected to robot", _robotId, '!');
+
+    // Every new connection starts in text format until handshake.
+    _sendingFormat = protocol::WireFormat::TEXT;
+    _framer.reset();
+    if (_endpoint.wireFormat == protocol::WireFormat::BINARY)
+    {
+        emit signalToSendToServer(protocol::Framer::frame(protocol::HANDSHAKE_BINARY).c_str());
+        _sendingFormat = protocol::WireFormat::BINARY;
+    }
+
+    // Real robot knows only points in text format, pings are sent only to robots which
+    // speak binary protocol.
+    _heartbeat.reset();
+    if (_endpoint.wireFormat == protocol::WireFormat::BINARY && _heartbeatTimer->interval() > 0)
+    {
+        _heartbeatTimer->start();
+    }
+
+    _printer.writeLine(std::cout, "\nConnection to robot", _robotId, "launched...\n");
+    _logger.writeLine("\nConnection to robot", _robotId, "launched at",
+                      utils::getCurrentSystemTime());
+
+    // Continue from the last answered point, everything after it is sent again.
+    dispatchPoints();
+}
+
+void RobotConnection::onConnectionLost()
+{
+    _printer.writeLine(std::cout, "\nRobot", _robotId, "disconnected! Queue high-water mark:",
+                       _messagesStorage.getHighWaterMark());
+    _logger.writeLine("Robot", _robotId, "disconnected at", utils::getCurrentSystemTime(),
+                      "with", _inFlightPoints.size(), "unanswered points");
+
+    if (_traces.getCount() > 0)
+    {
+        _logger.writeLine("Robot", _robotId, "latencies:", _traces.getSummary());
+    }
+    slotSaveDelayTable();
+
+    const stats::Histogram& latencies = _heartbeat.getLatencies();
+    if (latencies.getCount() > 0)
+    {
+        _logger.writeLine("Robot", _robotId, "round-trip time (us) of", latencies.getCount(),
+                          "pings: p50", latencies.getPercentile(0.5).count(), "p99",
+                          latencies.getPercentile(0.99).count(), "max",
+                          latencies.getMax().count());
+    }
+
+    // Answers for sent points will never come, so points are sent again in the same order.
+    // New link never brings late answers of old one, overdue points are forgotten.
+    std::deque<InFlightPoint> points = _inFlightPoints.takeAll();
+    for (auto it = points.rbegin(); it != points.rend(); ++it)
+    {
+        _retryCommands.push_front(std::move(it->command));
+    }
+    _fallbackTimer->stop();
+    _statistics.setInFlight(0);
+    updateIdleTime();
+    _statistics.add(RobotStatistics::RECONNECTIONS);
+
+    // Robot has to receive coordinate system again.
+    _coorninateSystem.reset();
+    scheduleReconnect();
+}
+
+} // namespace vasily
@@ -0,0 +1,624 @@
+#ifndef ROBOT_CONNECTION_H
+#define ROBOT_CONNECTION_H
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <QObject>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include "Utilities.h"
+#include "ClientSession.h"
+#include "DelayManager.h"
+#include "RobotStatistics.h"
+
+
+namespace vasily
+{
+
+/**
+ * \brief Class used to work with one robot: keeps its queue, keeps window of points in robot
+ *        buffer and reconnects.
+ * \details Object is supposed to be moved to its own thread, all methods except constructor
+ *          have to be called from this thread.
+ */
+class RobotConnection : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * \brief Structure which describes where robot is and which layer port serves its clients.
+     */
+    struct Endpoint
+    {
+        /**
+         * \brief Robot IP address.
+         */
+        std::string             serverIP;
+
+        /**
+         * \brief Robot port to receive.
+         */
+        int                     serverReceivingPort;
+
+        /**
+         * \brief Robot port to send.
+         */
+        int                     serverSendingPort;
+
+        /**
+         * \brief Layer port for clients which want to work with this robot.
+         */
+        int                     layerPort;
+
+        /**
+         * \brief Format which layer asks robot to use (real robot knows only text one).
+         */
+        protocol::WireFormat    wireFormat = protocol::WireFormat::TEXT;
+
+        /**
+         * \brief   Text messages to and from robot are terminated by newline.
+         * \details Real controller reads and writes unterminated text, so every read chunk is
+         *          one answer. RobotImitator needs newline in text format. Binary link always
+         *          uses newline for handshake and sizes from headers afterwards.
+         */
+        bool                    isLineFramed = false;
+    };
+
+    /**
+     * \brief Array of queued points which are dropped before priority point.
+     */
+    enum class PriorityFlush
+    {
+        NONE,
+        SESSION,
+        ALL
+    };
+
+
+    /**
+     * \brief                  Constructor that initializes sockets and timer.
+     * \param[in] robotId      Index of robot in layer.
+     * \param[in] endpoint     Robot address and ports.
+     * \param[in] delayManager Class used to calculate delays (will be copied).
+     * \param[out] logger      Logger used to write received data to file.
+     * \param[out] capture     Capture of traffic or nullptr if capture is turned off.
+     * \param[in] parent       The necessary data for Qt.
+     */
+                        RobotConnection(const std::size_t robotId, const Endpoint& endpoint,
+                                        const DelayManager& delayManager, logger::Logger& logger,
+                                        capture::CaptureWriter* capture = nullptr,
+                                        QObject* parent = nullptr);
+
+    /**
+     * \brief Default destructor.
+     */
+    virtual             ~RobotConnection() = default;
+
+    /**
+     * \brief           Deleted copy constructor.
+     * \param[in] other Other object.
+     */
+                        RobotConnection(const RobotConnection& other) = delete;
+
+    /**
+     * \brief           Deleted copy assignment operator.
+     * \param[in] other Other object.
+     * \return          Returns nothing because it's deleted.
+     */
+    RobotConnection&    operator=(const RobotConnection& other) = delete;
+
+    /**
+     * \brief           Deleted move constructor.
+     * \param[in] other Other object.
+     */
+                        RobotConnection(RobotConnection&& other) = delete;
+
+    /**
+     * \brief           Deleted move assignment operator.
+     * \param[in] other Other object.
+     * \return          Returns nothing because it's deleted.
+     */
+    RobotConnection&    operator=(RobotConnection&& other) = delete;
+
+    /**
+     * \brief  Get index of robot in layer.
+     * \return Robot index.
+     */
+    std::size_t         getRobotId() const noexcept;
+
+    /**
+     * \brief  Get robot address and ports.
+     * \return Robot endpoint.
+     */
+    const Endpoint&     getEndpoint() const noexcept;
+
+    /**
+     * \brief  Get counters of robot (can be used from any thread).
+     * \return Robot statistics.
+     */
+    RobotStatistics&    getStatistics() noexcept;
+
+    /**
+     * \brief  Get number of points in queue (can be used from any thread).
+     * \return Queue size.
+     */
+    std::size_t         getQueueSize() const noexcept;
+
+    /**
+     * \brief  Get time when robot is predicted to finish points sent to it (can be used from any
+     *         thread).
+     * \return Predicted time or epoch of clock if robot has no predicted points.
+     */
+    std::chrono::steady_clock::time_point getIdleTime() const noexcept;
+
+    /**
+     * \brief             Add point merged by layer to robot queue.
+     * \details           The only method which is called from layer thread. Layer has to call
+     *                    dispatchPoints() in connection thread afterwards.
+     * \param[in] command Point to add.
+     * \return            False if queue is full and point was not added.
+     */
+    bool                pushCommand(Command command);
+
+    /**
+     * \brief Send points from queue to robot while there is place in window.
+     */
+    void                dispatchPoints();
+
+    /**
+     * \brief             Send control point (stop, return home) to robot at once: it doesn't
+     *                    wait for place in window and for queued points.
+     * \param[in] command Point to send.
+     * \param[in] flush   Queued points which robot didn't receive yet and which are dropped:
+     *                    none, points of session which sent control point or points of all
+     *                    sessions.
+     */
+    void                dispatchPriorityCommand(const Command& command, const PriorityFlush flush);
+
+    /**
+     * \brief               Remove all queued points of session (e.g. after its disconnection).
+     * \param[in] sessionId Session which points should be removed.
+     */
+    void                dropSessionCommands(const std::size_t sessionId);
+
+    /**
+     * \brief              Read robots list from file.
+     * \details            Each line contains: IP, receiving port, sending port, layer port,
+     *                     optional wire format ("text" or "binary") and optional text framing
+     *                     ("raw" by default or "lines").
+     * \param[in] fileName File to read.
+     * \return             Read endpoints or empty container if file is absent or incorrect.
+     */
+    static std::vector<Endpoint> readEndpoints(const std::string& fileName);
+
+
+public slots:
+    /**
+     * \brief Start connecting to robot, doesn't wait for result.
+     */
+    void launch();
+
+
+signals:
+    /**
+     * \brief               Notify layer that answer from robot was received.
+     * \param[in] robotId   Index of robot.
+     * \param[in] sessionId Session which sent point this answer belongs to or
+     *                      ClientSession::BROADCAST if answer doesn't belong to any point.
+     * \param[in] answer    Received answer.
+     */
+    void signalAnswerReceived(const std::size_t robotId, const std::size_t sessionId,
+                              const protocol::Message& answer) const;
+
+    /**
+     * \brief             Notify layer that points left robot queue (sent or dropped).
+     * \param[in] robotId Index of robot.
+     * \param[in] count   Number of points.
+     */
+    void signalCommandsReleased(const std::size_t robotId, const std::size_t count) const;
+
+    /**
+     * \brief                  Notify layer that delay table of robot was corrected, so layer
+     *                         predicts queued points in the same way.
+     * \param[in] robotId      Index of robot.
+     * \param[in] delayManager Copy of delay table which is not changed anymore.
+     */
+    void signalDelayTableChanged(const std::size_t robotId,
+                                 std::shared_ptr<const DelayManager> delayManager) const;
+
+    /**
+     * \brief          Notify connection to send data to robot.
+     * \param[in] data Data to be send.
+     */
+    void signalToSendToServer(const QByteArray& data) const;
+
+
+private slots:
+    /**
+     * \brief Check if both sockets are connected to robot.
+     */
+    void slotSocketConnected();
+
+    /**
+     * \brief           Process failed connection attempt or robot disconnection.
+     * \param[in] state New state of socket.
+     */
+    void slotSocketStateChanged(const QAbstractSocket::SocketState state);
+
+    /**
+     * \brief Abort connection attempt which took too long.
+     */
+    void slotConnectionTimedOut();
+
+    /**
+     * \brief Receive data from robot.
+     */
+    void slotReadFromServer();
+
+    /**
+     * \brief          Send data to robot after notifying from signal.
+     * \param[in] data Data to be send.
+     */
+    void slotSendDataToServer(const QByteArray& data);
+
+    /**
+     * \brief Release the oldest sent point which robot didn't answer in predicted time.
+     */
+    void slotAnswerTimedOut();
+
+    /**
+     * \brief Send ping to robot or drop link if robot stopped answering pings.
+     */
+    void slotHeartbeat();
+
+    /**
+     * \brief Save table corrected by observed durations, so next launch starts with it.
+     */
+    void slotSaveDelayTable();
+
+
+protected:
+    /**
+     * \brief Array of states of link to robot.
+     */
+    enum class State
+    {
+        DISCONNECTED,
+        CONNECTING,
+        CONNECTED
+    };
+
+    /**
+     * \brief Point which was sent to robot and waits for answer.
+     */
+    struct InFlightPoint
+    {
+        /**
+         * \brief Number of message with point in stream to robot.
+         */
+        std::uint32_t                           sequence;
+
+        /**
+         * \brief Sent point, it is sent again if link is lost before answer.
+         */
+        Command                                 command;
+
+        /**
+         * \brief Time when robot should finish movement according to DelayManager or
+         *        std::nullopt if point was forwarded without parsing and can't be predicted.
+         */
+        std::optional<std::chrono::steady_clock::time_point> expectedFinish;
+
+        /**
+         * \brief Duration of movement predicted by DelayManager (zero if it wasn't predicted).
+         */
+        std::chrono::microseconds               predictedDuration;
+
+        /**
+         * \brief Movement which duration was predicted for.
+         */
+        DelayManager::Movement                  movement;
+    };
+
+    /**
+     * \brief Implementation of type-safe output printer.
+     */
+    printer::Printer&               _printer = printer::Printer::getInstance();
+
+    /**
+     * \brief Index of robot in layer.
+     */
+    std::size_t                     _robotId;
+
+    /**
+     * \brief Robot address and ports.
+     */
+    Endpoint                        _endpoint;
+
+    /**
+     * \brief Connected to robot socket used to receive data.
+     */
+    std::unique_ptr<QTcpSocket>     _receivingSocket;
+
+    /**
+     * \brief Connected to robot socket used to send data.
+     */
+    std::unique_ptr<QTcpSocket>     _sendingSocket;
+
+    /**
+     * \brief Timer used to release point if robot didn't answer in time predicted by
+     *        DelayManager.
+     */
+    std::unique_ptr<QTimer>         _fallbackTimer;
+
+    /**
+     * \brief Timer used to start next connection attempt.
+     */
+    std::unique_ptr<QTimer>         _reconnectTimer;
+
+    /**
+     * \brief Timer used to abort connection attempt which takes too long.
+     */
+    std::unique_ptr<QTimer>         _connectionTimer;
+
+    /**
+     * \brief Timer used to send pings to robot.
+     */
+    std::unique_ptr<QTimer>         _heartbeatTimer;
+
+    /**
+     * \brief Timer used to save corrected delay table.
+     */
+    std::unique_ptr<QTimer>         _delayTableTimer;
+
+    /**
+     * \brief Current state of link to robot.
+     */
+    State                           _state;
+
+    /**
+     * \brief Delays between connection attempts.
+     */
+    utils::Backoff                  _backoff;
+
+    /**
+     * \brief Pings which robot has to answer and their round-trip times.
+     */
+    protocol::Heartbeat             _heartbeat;
+
+    /**
+     * \brief Variable used to keep coordinate type which was last sent to robot.
+     */
+    std::optional<CoordinateSystem>	_coorninateSystem;
+
+    /**
+     * \brief Last sent point to robot.
+     */
+    RobotData                       _lastReceivedPoint;
+
+    /**
+     * \brief Queue used to keeps messages from clients which were merged by layer (layer thread
+     *        pushes, connection thread pops).
+     */
+    container::RingBuffer<Command>  _messagesStorage;
+
+    /**
+     * \brief   Sessions which points are skipped when they leave queue.
+     * \details Point is skipped if it arrived before bound: all points of disconnected session,
+     *          points sent before priority point of session which queue was flushed.
+     */
+    std::map<std::size_t, std::uint64_t> _droppedSessions;
+
+    /**
+     * \brief Points which robot didn't answer before link was lost, they are sent first after
+     *        reconnection.
+     */
+    std::deque<Command>             _retryCommands;
+
+    /**
+     * \brief Points which were sent to robot and wait for answer (in sending order) and text
+     *        points which answer timed out but still may come.
+     */
+    protocol::AnswerWindow<InFlightPoint> _inFlightPoints;
+
+    /**
+     * \brief Parse state of stream received from robot.
+     */
+    protocol::Framer                _framer;
+
+    /**
+     * \brief Format which connection currently writes messages in.
+     */
+    protocol::WireFormat            _sendingFormat;
+
+    /**
+     * \brief Number of the next message sent to robot.
+     */
+    std::uint32_t                   _sequence;
+
+    /**
+     * \brief Logger used to write received data to file.
+     */
+    logger::Logger&                 _logger;
+
+    /**
+     * \brief Class used to calculate delays.
+     */
+    DelayManager                    _delayManager;
+
+    /**
+     * \brief Name of file with delay table corrected for this robot.
+     */
+    std::string                     _delayTableFileName;
+
+    /**
+     * \brief Capture of traffic or nullptr if capture is turned off.
+     */
+    capture::CaptureWriter*         _capture;
+
+    /**
+     * \brief Traces of points answered by robot (file name ends with robot index).
+     */
+    stats::TraceRecorder            _traces;
+
+    /**
+     * \brief Counters read by layer for statistics report.
+     */
+    RobotStatistics                 _statistics;
+
+    /**
+     * \brief Time when the last answer was received from robot.
+     */
+    std::chrono::steady_clock::time_point _lastAnswerTime;
+
+    /**
+     * \brief Predicted finish of the last point sent to robot in microseconds of steady clock
+     *        (written by connection thread, read by layer).
+     */
+    std::atomic<long long>          _idleTime;
+
+    /**
+     * \brief Time from reading control point from client to sending it to robot.
+     */
+    stats::Histogram                _priorityLatencies;
+
+
+    /**
+     * \brief           Finish trace of point answered by robot.
+     * \param[in] point Answered point.
+     */
+    void recordTrace(InFlightPoint& point);
+
+    /**
+     * \brief Publish predicted finish of points sent to robot after window was changed.
+     */
+    void updateIdleTime() noexcept;
+
+    /**
+     * \brief           Compare duration predicted by DelayManager with real one.
+     * \param[in] point Answered point.
+     * \param[in] now   Time when answer was received.
+     */
+    void recordPrediction(const InFlightPoint& point,
+                          const std::chrono::steady_clock::time_point now);
+
+    /**
+     * \brief Start timer for the nearest deadline of sent or overdue point or stop it if nothing
+     *        waits for answer.
+     */
+    void restartFallbackTimer();
+
+    /**
+     * \brief            Find sent point which answer belongs to and remove it from window.
+     * \details          Text answer goes to overdue point only if it contains coordinates of
+     *                   this point.
+     * \param[in] answer Answer from robot.
+     * \return           Answered point or std::nullopt if answer doesn't match any point.
+     */
+    std::optional<protocol::AnswerWindow<InFlightPoint>::Completion> completeInFlightPoint(
+        const protocol::Message& answer);
+
+    /**
+     * \brief Count and log points which answers will never be matched.
+     */
+    void releaseLostPoints();
+
+    /**
+     * \brief  Check if robot exchanges unterminated text messages.
+     * \return True for text robot without line framing.
+     */
+    bool isRawTextLink() const noexcept;
+
+    /**
+     * \brief          Write data to robot, count and capture it.
+     * \details        Delimiter of text message is removed for unterminated robot.
+     * \param[in] data Data to be send.
+     */
+    void writeToServer(QByteArray data);
+
+    /**
+     * \brief             Send message to robot in current format with next sequence number.
+     * \param[in] message Message to send.
+     * \return            Sequence number of sent message.
+     */
+    std::uint32_t sendMessage(protocol::Message message);
+
+    /**
+     * \brief           Send message from client to robot as is, only sequence number is changed
+     *                  in binary format.
+     * \param[in] frame Message in current format.
+     * \return          Sequence number of sent message.
+     */
+    std::uint32_t sendRawFrame(std::string frame);
+
+    /**
+     * \brief             Send point to robot and add it to window.
+     * \param[in] command Point to send.
+     */
+    void sendCommand(Command command);
+
+    /**
+     * \brief  Drop all points which robot didn't receive yet.
+     * \return Number of dropped points.
+     */
+    std::size_t flushQueue();
+
+    /**
+     * \brief               Drop points of session which robot didn't receive yet and which
+     *                      arrived before bound.
+     * \details             Points in queue are skipped when they reach its beginning.
+     * \param[in] sessionId Session which points should be removed.
+     * \param[in] bound     Arrival number of the first point which is kept.
+     * \return              Number of points dropped at once (points in queue aren't counted).
+     */
+    std::size_t dropSessionPoints(const std::size_t sessionId, const std::uint64_t bound);
+
+    /**
+     * \brief             Check if point belongs to dropped points of session.
+     * \param[in] command Point to check.
+     * \return            True if point has to be skipped.
+     */
+    bool isDropped(const Command& command) const;
+
+    /**
+     * \brief  Take next point to send: points which were not answered before reconnection go
+     *         first, then points from queue.
+     * \return Point or std::nullopt if there is nothing to send.
+     */
+    std::optional<Command> takeNextCommand();
+
+    /**
+     * \brief Close sockets and start connecting to robot.
+     */
+    void startConnecting();
+
+    /**
+     * \brief Plan next connection attempt with growing delay.
+     */
+    void scheduleReconnect();
+
+    /**
+     * \brief Prepare link to work after both sockets are connected.
+     */
+    void onConnected();
+
+    /**
+     * \brief Keep unanswered points and start reconnecting after link was lost.
+     */
+    void onConnectionLost();
+};
+
+} // namespace vasily
+
+Q_DECLARE_METATYPE(protocol::Message)
+Q_DECLARE_METATYPE(std::shared_ptr<const vasily::DelayManager>)
+
+#endif // ROBOT_CONNECTION_H
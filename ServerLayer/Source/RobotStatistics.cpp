@@ -0,0 +1,118 @@
+#include <cassert>
+
+#include "RobotStatistics.h"
+
+
+namespace vasily
+{
+
+RobotStatistics::RobotStatistics() noexcept
+    : _counters(),
+      _inFlight(0),
+      _sampledValues{},
+      _rates{},
+      _sampleTime(),
+      _isSampled(false)
+{
+    for (auto& counter : _counters)
+    {
+        counter.store(0, std::memory_order_relaxed);
+    }
+}
+
+void RobotStatistics::add(const Counter counter, const std::uint64_t value) noexcept
+{
+    _counters[counter].fetch_add(value, std::memory_order_relaxed);
+}
+
+std::uint64_t RobotStatistics::get(const Counter counter) const noexcept
+{
+    return _counters[counter].load(std::memory_order_relaxed);
+}
+
+void RobotStatistics::setInFlight(const std::size_t value) noexcept
+{
+    _inFlight.store(value, std::memory_order_relaxed);
+}
+
+std::size_t RobotStatistics::getInFlight() const noexcept
+{
+    return _inFlight.load(std::memory_order_relaxed);
+}
+
+void RobotStatistics::sample(const std::chrono::steady_clock::time_point now)
+{
+    const double seconds = std::chrono::duration<double>(now - _sampleTime).count();
+    for (std::size_t i = 0; i < NUMBER_OF_COUNTERS; ++i)
+    {
+        const std::uint64_t value = _counters[i].load(std::memory_order_relaxed);
+        if (_isSampled && seconds > 0.0)
+        {
+            _rates[i] = static_cast<double>(value - _sampledValues[i]) / seconds;
+        }
+        _sampledValues[i] = value;
+    }
+
+    _sampleTime = now;
+    _isSampled  = true;
+}
+
+double RobotStatistics::getRate(const Counter counter) const noexcept
+{
+    return _rates[counter];
+}
+
+std::string_view RobotStatistics::getName(const Counter counter) noexcept
+{
+    switch (counter)
+    {
+        case Counter::POINTS_IN:
+            return "points_in";
+        case Counter::POINTS_OUT:
+            return "points_out";
+        case Counter::ANSWERS:
+            return "answers";
+        case Counter::BYTES_FROM_CLIENTS:
+            return "bytes_from_clients";
+        case Counter::BYTES_TO_CLIENTS:
+            return "bytes_to_clients";
+        case Counter::BYTES_FROM_ROBOT:
+            return "bytes_from_robot";
+        case Counter::BYTES_TO_ROBOT:
+            return "bytes_to_robot";
+        case Counter::RECONNECTIONS:
+            return "reconnections";
+        case Counter::REJECTED_POINTS:
+            return "rejected_points";
+        case Counter::TIMED_OUT_ANSWERS:
+            return "timed_out_answers";
+        case Counter::LOST_ANSWERS:
+            return "lost_answers";
+        case Counter::SIMPLIFIED_POINTS:
+            return "simplified_points";
+        case Counter::PRIORITY_COMMANDS:
+            return "priority_commands";
+        case Counter::PRIORITY_DISPATCH_MICROSECONDS:
+            return "priority_dispatch_microseconds";
+        case Counter::FLUSHED_POINTS:
+            return "flushed_points";
+        case Counter::PREDICTIONS:
+            return "predictions";
+        case Counter::PREDICTED_MICROSECONDS:
+            return "predicted_microseconds";
+        case Counter::ACTUAL_MICROSECONDS:
+            return "actual_microseconds";
+        case Counter::PREDICTION_ERROR_MICROSECONDS:
+            return "prediction_error_microseconds";
+        case Counter::CALIBRATIONS:
+            return "calibrations";
+        case Counter::REJECTED_CALIBRATIONS:
+            return "rejected_calibrations";
+
+        default:
+            assert(false);
+            return {};
+    }
+}
+
+} // namespace vasily
@@ -0,0 +1,138 @@
+#ifndef ROBOT_STATISTICS_H
+#define ROBOT_STATISTICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+
+namespace vasily
+{
+
+/**
+ * \brief   Class used to count events of one robot in layer thread and in connection thread.
+ * \details Counters are relaxed atomics, so counting costs one atomic addition and never blocks
+ *          network code. Rates are calculated by owner thread from periodic samples.
+ */
+class RobotStatistics
+{
+public:
+    /**
+     * \brief Array of counted events.
+     */
+    enum Counter : std::size_t
+    {
+        POINTS_IN,
+        POINTS_OUT,
+        ANSWERS,
+        BYTES_FROM_CLIENTS,
+        BYTES_TO_CLIENTS,
+        BYTES_FROM_ROBOT,
+        BYTES_TO_ROBOT,
+        RECONNECTIONS,
+        REJECTED_POINTS,
+        TIMED_OUT_ANSWERS,
+        LOST_ANSWERS,
+        SIMPLIFIED_POINTS,
+        PRIORITY_COMMANDS,
+        PRIORITY_DISPATCH_MICROSECONDS,
+        FLUSHED_POINTS,
+        PREDICTIONS,
+        PREDICTED_MICROSECONDS,
+        ACTUAL_MICROSECONDS,
+        PREDICTION_ERROR_MICROSECONDS,
+        CALIBRATIONS,
+        REJECTED_CALIBRATIONS,
+        NUMBER_OF_COUNTERS
+    };
+
+
+    /**
+     * \brief Default constructor.
+     */
+                        RobotStatistics() noexcept;
+
+    /**
+     * \brief             Increase counter (from any thread).
+     * \param[in] counter Counter to increase.
+     * \param[in] value   Value to add.
+     */
+    void                add(const Counter counter, const std::uint64_t value = 1) noexcept;
+
+    /**
+     * \brief             Get current value of counter (from any thread).
+     * \param[in] counter Counter to get.
+     * \return            Value of counter.
+     */
+    std::uint64_t       get(const Counter counter) const noexcept;
+
+    /**
+     * \brief           Set number of points which robot didn't answer yet (connection thread).
+     * \param[in] value Number of points in window.
+     */
+    void                setInFlight(const std::size_t value) noexcept;
+
+    /**
+     * \brief  Get number of points which robot didn't answer yet (from any thread).
+     * \return Number of points in window.
+     */
+    std::size_t         getInFlight() const noexcept;
+
+    /**
+     * \brief         Remember values of counters to calculate rates (one owner thread only).
+     * \param[in] now Time of sample.
+     */
+    void                sample(const std::chrono::steady_clock::time_point now);
+
+    /**
+     * \brief             Get speed of counter between the last two samples (owner thread only).
+     * \param[in] counter Counter to get.
+     * \return            Increase of counter per second.
+     */
+    double              getRate(const Counter counter) const noexcept;
+
+    /**
+     * \brief             Get name of counter used in reports.
+     * \param[in] counter Counter to get.
+     * \return            Name in snake case.
+     */
+    static std::string_view getName(const Counter counter) noexcept;
+
+
+private:
+    /**
+     * \brief Values of counters.
+     */
+    std::array<std::atomic<std::uint64_t>, NUMBER_OF_COUNTERS> _counters;
+
+    /**
+     * \brief Number of points which robot didn't answer yet.
+     */
+    std::atomic<std::size_t>                                   _inFlight;
+
+    /**
+     * \brief Values of counters in the last sample.
+     */
+    std::array<std::uint64_t, NUMBER_OF_COUNTERS>              _sampledValues;
+
+    /**
+     * \brief Speed of counters between the last two samples.
+     */
+    std::array<double, NUMBER_OF_COUNTERS>                     _rates;
+
+    /**
+     * \brief Time of the last sample.
+     */
+    std::chrono::steady_clock::time_point                      _sampleTime;
+
+    /**
+     * \brief Flag which shows that at least one sample was made.
+     */
+    bool                                                       _isSampled;
+};
+
+} // namespace vasily
+
+#endif // ROBOT_STATISTICS_H
@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <sstream>
+
 #include "ServerLayer.h"
 
 
@@ -5,7 +8,12 @@ namespace vasily
 {
 
 inline const config::Config<std::string, std::string, std::string_view, int, int, int,
-                            std::size_t, std::array<int, 3>, std::array<int, 3>, long long>
+                            std::size_t, std::array<int, 3>, std::array<int, 3>, long long,
+                            std::size_t, std::string, std::size_t, long long, std::size_t,
+                            std::size_t, long long, long long, long long, std::size_t,
+                            std::string, int, long long, std::array<int, 2>, std::size_t,
+                            bool, bool, std::string, bool, double, long long, std::string,
+                            std::string_view>
     ServerLayer::CONFIG
 {
     { "distance_to_time.txt" },
@@ -17,298 +25,1023 @@ inline const config::Config<std::string, std::string, std::string_view, int, int
     3,
     { 830'000,  -400'000, 539'000 },
     { 1'320'000, 400'000, 960'000 },
-    1000
+    1000,
+    8,
+    { "robots.txt" },
+    4,
+    500,
+    1024,
+    256,
+    30'000,
+    3000,
+    1000,
+    3,
+    { "layer_trace_" },
+    8889,
+    1000,
+    { 100, 100 },
+    0,
+    false,
+    false,
+    { "" },
+    false,
+    0.05,
+    60'000,
+    { "distance_to_time_robot_" },
+    { "fifo", 4 }
 };
 
+namespace
+{
+
+/**
+ * \brief               Make identifier of point in timeline of robot.
+ * \param[in] sessionId Session which sent point.
+ * \param[in] sequence  Number of point in stream of client.
+ * \return              Identifier unique for queued points of all sessions.
+ */
+std::uint64_t makeTimelineTag(const std::size_t sessionId, const std::uint32_t sequence) noexcept
+{
+    return (static_cast<std::uint64_t>(sessionId) << 32) | sequence;
+}
+
+} // anonymous namespace
+
 ServerLayer::ServerLayer(const int serverReceivingPort,  const int serverSendingPort,
                          const std::string_view serverIP, const int layerPort,
-                         const WorkMode workMode, QObject* parent)
+                         const WorkMode workMode, const Arbiter::Policy arbitration,
+                         QObject* parent)
+    : ServerLayer({ { std::string(serverIP), serverReceivingPort, serverSendingPort, layerPort } },
+                  workMode, arbitration, parent)
+{
+}
+
+ServerLayer::ServerLayer(const std::vector<RobotConnection::Endpoint>& endpoints,
+                         const WorkMode workMode, const Arbiter::Policy arbitration,
+                         QObject* parent)
     : QObject(parent),
-      _layerPort(layerPort),
-      _layerSocket(std::make_unique<QTcpServer>(this)),
-      _clientSocket(nullptr),
-      _serverReceivingPort(serverReceivingPort),
-      _receivingSocket(std::make_unique<QTcpSocket>(this)),
-      _serverSendingPort(serverSendingPort),
-      _sendingSocket(std::make_unique<QTcpSocket>(this)),
-      _serverIP(serverIP),
+      _nextSessionId(ClientSession::BROADCAST + 1),
+      _arrivalCounter(0),
       _workMode(workMode),
       _logger(CONFIG.get<Param::DEFAULT_IN_FILE_NAME>(),
               CONFIG.get<Param::DEFAULT_OUT_FILE_NAME>()),
-      _delayManager(_printer, _logger)
+      _delayManager(_printer, CONFIG.get<Param::DEFAULT_IN_FILE_NAME>(),
+                    CONFIG.get<Param::DELAY_LOGGING>()),
+      _workspaceValidator(makeWorkspaceLimits()),
+      _capture(),
+      _statisticsServer(std::make_unique<StatisticsServer>(
+          [this]() { return makeStatisticsReport(); }, this)),
+      _statisticsTimer(std::make_unique<QTimer>(this))
 {
-    _printer.writeLine(std::cout, "Server Receiving Port:", serverReceivingPort,
-                       "Server Sending Port:", serverSendingPort, "Server IP:", serverIP,
-                       "Layer Port:", layerPort);
+    // Robots connections live in other threads and notify layer through queued signals.
+    qRegisterMetaType<std::size_t>("std::size_t");
+    qRegisterMetaType<protocol::Message>();
+    qRegisterMetaType<std::shared_ptr<const DelayManager>>();
 
-    connect(_layerSocket.get(), &QTcpServer::newConnection, this,
-            &ServerLayer::slotNewClientConnection);
-    
     connect(this, &ServerLayer::signalToSendToClient, this, &ServerLayer::slotSendDataToClient);
 
-    connect(_receivingSocket.get(), &QTcpSocket::readyRead, this, &ServerLayer::slotReadFromServer);
-    connect(_receivingSocket.get(), &QTcpSocket::disconnected, this,
-            &ServerLayer::slotServerDisconnected, Qt::QueuedConnection);
+    // Empty file name turns capture off, so hot path checks only pointer.
+    if (const std::string& captureFileName = CONFIG.get<Param::CAPTURE_FILE_NAME>();
+        !captureFileName.empty())
+    {
+        _capture = std::make_unique<capture::CaptureWriter>(captureFileName);
+        if (!_capture->isOpen())
+        {
+            _printer.writeLine(std::cout, "ERROR 08: Capture file", captureFileName,
+                               "is not opened!");
+            _capture.reset();
+        }
+    }
 
-    connect(_sendingSocket.get(), &QTcpSocket::disconnected, this,
-            &ServerLayer::slotServerDisconnected, Qt::QueuedConnection);
+    _statisticsTimer->setInterval(static_cast<int>(CONFIG.get<Param::STATISTICS_PERIOD>()));
+    connect(_statisticsTimer.get(), &QTimer::timeout, this, &ServerLayer::slotSampleStatistics);
 
-    connect(this, &ServerLayer::signalToSendToServer, this, &ServerLayer::slotSendDataToServer);
+    _robots.reserve(endpoints.size());
+    for (const auto& endpoint : endpoints)
+    {
+        const std::size_t robotId = _robots.size();
 
-    connect(this, &ServerLayer::signalProcessMessagesStorage, this,
-            &ServerLayer::slotProcessMessagesStorage);
+        RobotContext robot
+        {
+            std::make_unique<QTcpServer>(this),
+            std::make_unique<RobotConnection>(robotId, endpoint, _delayManager, _logger,
+                                              _capture.get()),
+            std::make_unique<QThread>(),
+            {},
+            Arbiter(arbitration),
+            0,
+            {},
+            0,
+            std::make_shared<const DelayManager>(_delayManager),
+            {}
+        };
 
-    connect(this, &ServerLayer::signalProcessAnswersStorage, this,
-            &ServerLayer::slotProcessAnswersStorage);
-}
+        connect(robot.layerSocket.get(), &QTcpServer::newConnection, this,
+                [this, robotId]() { slotNewClientConnection(robotId); });
 
-void ServerLayer::slotNewClientConnection()
-{
-    _printer.writeLine(std::cout, "\nNew connection to layer port\n");
-    _logger.writeLine("\nNew connection to layer port at",
-                      utils::getCurrentSystemTime());
+        connect(robot.connection.get(), &RobotConnection::signalAnswerReceived, this,
+                &ServerLayer::slotAnswerReceived, Qt::QueuedConnection);
+        connect(robot.connection.get(), &RobotConnection::signalCommandsReleased, this,
+                &ServerLayer::slotCommandsReleased, Qt::QueuedConnection);
+        connect(robot.connection.get(), &RobotConnection::signalDelayTableChanged, this,
+                &ServerLayer::slotDelayTableChanged, Qt::QueuedConnection);
 
-    _clientSocket = _layerSocket->nextPendingConnection();
+        // Connection starts connecting to robot as soon as its thread is started.
+        robot.connection->moveToThread(robot.thread.get());
+        connect(robot.thread.get(), &QThread::started, robot.connection.get(),
+                &RobotConnection::launch);
 
-    _clientSocket->write("Test message from ServerLayer::LayerSocket.");
+        _robots.emplace_back(std::move(robot));
+    }
+}
 
-    connect(_clientSocket, &QTcpSocket::readyRead, this, &ServerLayer::slotReadFromClient);
-    connect(_clientSocket, &QTcpSocket::disconnected, this, &ServerLayer::slotClientDisconnected);
+ServerLayer::~ServerLayer()
+{
+    for (auto& robot : _robots)
+    {
+        robot.thread->quit();
+        robot.thread->wait();
+    }
 }
 
-void ServerLayer::slotClientDisconnected()
+void ServerLayer::slotNewClientConnection(const std::size_t robotId)
 {
-    _printer.writeLine(std::cout, "Client disconnected from layer port!");
-    _clientSocket->close();
-    _coorninateSystem.reset();
+    RobotContext& robot = _robots.at(robotId);
+    while (robot.layerSocket->hasPendingConnections())
+    {
+        static const std::array<int, 2> kTolerance = CONFIG.get<Param::SIMPLIFICATION_TOLERANCE>();
+        static const std::size_t kWindow = CONFIG.get<Param::SIMPLIFICATION_WINDOW>();
+
+        QTcpSocket* socket = robot.layerSocket->nextPendingConnection();
+        const std::size_t sessionId = _nextSessionId++;
+        robot.sessions.emplace(sessionId,
+                               ClientSession{ sessionId, robotId, socket, std::nullopt, {},
+                                              protocol::Framer(), protocol::WireFormat::TEXT,
+                                              0, false, 0, {},
+                                              utils::PathSimplifier<Command>(
+                                                  kTolerance[0], kTolerance[1], kWindow),
+                                              utils::Timeline(), RobotData{} });
+
+        // While session is paused unread data stays in kernel and TCP slows client down.
+        socket->setReadBufferSize(protocol::Framer::DEFAULT_MAX_MESSAGE_SIZE);
+
+        _printer.writeLine(std::cout, "\nNew connection to layer port of robot", robotId,
+                           "session", sessionId, '\n');
+        _logger.writeLine("\nNew connection to layer port of robot", robotId, "session",
+                          sessionId, "at", utils::getCurrentSystemTime());
+        if (_capture)
+        {
+            _capture->write(capture::Event::CLIENT_CONNECTED, robotId, sessionId,
+                            std::to_string(robot.layerSocket->serverPort()));
+        }
+
+        sendData("Test message from ServerLayer::LayerSocket.", sessionId);
+
+        connect(socket, &QTcpSocket::readyRead, this,
+                [this, robotId, sessionId]() { slotReadFromClient(robotId, sessionId); });
+        connect(socket, &QTcpSocket::disconnected, this,
+                [this, robotId, sessionId]() { slotClientDisconnected(robotId, sessionId); });
+    }
+
+    // Deliver answers which were received while no client was connected.
+    processAnswersStorage(robotId);
 }
 
-void ServerLayer::slotServerDisconnected()
+void ServerLayer::slotClientDisconnected(const std::size_t robotId, const std::size_t sessionId)
 {
-    _printer.writeLine(std::cout, "\nServer disconnected!");
-    tryReconnectToServer();
+    RobotContext& robot = _robots.at(robotId);
+    const auto it = robot.sessions.find(sessionId);
+    if (it == robot.sessions.end())
+    {
+        return;
+    }
+
+    if (_capture)
+    {
+        _capture->write(capture::Event::CLIENT_DISCONNECTED, robotId, sessionId, {});
+    }
+
+    _printer.writeLine(std::cout, "Client disconnected from layer port, session", sessionId,
+                       "queue high-water mark:", it->second.inputHighWaterMark,
+                       "simplified points:", it->second.simplifier.getRemoved());
+    it->second.socket->close();
+    it->second.socket->deleteLater();
+    robot.sessions.erase(it);
+    robot.arbiter.releaseSession(sessionId);
+
+    // Robot should not continue movement which nobody is waiting for.
+    RobotConnection* connection = robot.connection.get();
+    QMetaObject::invokeMethod(connection,
+                              [connection, sessionId]()
+                              {
+                                  connection->dropSessionCommands(sessionId);
+                              },
+                              Qt::QueuedConnection);
 }
 
-void ServerLayer::slotReadFromClient()
+void ServerLayer::slotReadFromClient(const std::size_t robotId, const std::size_t sessionId)
 {
-    if (_clientSocket->bytesAvailable() > 0)
+    RobotContext& robot = _robots.at(robotId);
+    const auto it = robot.sessions.find(sessionId);
+    if (it == robot.sessions.end())
+    {
+        return;
+    }
+    ClientSession& session = it->second;
+
+    // Reading is continued when robot takes enough points from queue of session.
+    if (session.isPaused)
     {
-        QByteArray array = _clientSocket->readAll();
+        return;
+    }
+
+    if (session.socket->bytesAvailable() > 0)
+    {
+        const QByteArray array = session.socket->readAll();
+        session.readTime = stats::Trace::Clock::now();
+        robot.connection->getStatistics().add(RobotStatistics::BYTES_FROM_CLIENTS,
+                                              static_cast<std::uint64_t>(array.size()));
+        if (_capture)
+        {
+            _capture->write(capture::Event::FROM_CLIENT, robotId, sessionId,
+                            { array.constData(), static_cast<std::size_t>(array.size()) });
+        }
         ///qDebug() << array << '\n';
 
-        const std::string receivedData = array.toStdString();
-        _logger.writeLine(_clientSocket->localPort(), '-', receivedData);
+        // Socket gives arbitrary pieces of stream, process only complete messages.
+        session.framer.append({ array.constData(), static_cast<std::size_t>(array.size()) });
+    }
+
+    // Messages left in framer after pause are processed here too.
+    while (!session.isPaused)
+    {
+        auto message = session.framer.nextMessage();
+        if (!message.has_value())
+        {
+            break;
+        }
+
+        // Original bytes can be forwarded only if robot expects the same format.
+        if (_workMode == WorkMode::UNSAFE
+            && session.framer.getFormat() == robot.connection->getEndpoint().wireFormat
+            && tryPassThrough(session, *message))
+        {
+            continue;
+        }
+        processClientMessage(session, *message);
+    }
+
+    // Nothing is held between reads, so the last point of stream never waits for the next one.
+    flushSimplifier(session);
+    mergeSessionQueues(robotId);
+}
 
-        switch (_workMode)
+void ServerLayer::processClientMessage(ClientSession& session, const std::string& frame)
+{
+    if (session.framer.getFormat() == protocol::WireFormat::BINARY)
+    {
+        const auto message = protocol::decode(frame);
+        if (!message.has_value())
+        {
+            _printer.writeLine(std::cout, "ERROR 07: Incorrect binary message received!");
+            return;
+        }
+        if (message->type == protocol::MessageType::PING)
+        {
+            answerPing(session, *message);
+            return;
+        }
+        if (message->type == protocol::MessageType::TEXT)
         {
-            case WorkMode::SAFE:
+            if (const auto eta = protocol::parseEtaRequest(message->text); eta.has_value())
             {
-                if (!_coorninateSystem.has_value())
-                {
-                    break;
-                }
-
-                bool flag;
-                const auto robotData = utils::fromString<RobotData>(receivedData, flag);
-                if (!flag || !checkCoordinates(robotData))
-                {
-                    sendData("INCORRECT COORDINATES: " + receivedData, Whereto::CLIENT);
-                }
-                break;
+                answerEta(session, *eta);
+                return;
             }
-            
-            case WorkMode::UNSAFE:
-                _printer.writeLine(std::cout, "Warning: working in unsafe mode!");
-                break;
-
-            default:
-                assert(false);
-                break;
         }
 
-        if (const auto [value, check] = utils::parseCoordinateSystem(receivedData); check)
+        _logger.writeLine(session.socket->localPort(), '-', session.id, '-',
+                          protocol::toText(*message));
+        processClientCommand(session, *message);
+        return;
+    }
+
+    if (const auto heartbeat = protocol::parseHeartbeat(frame);
+        heartbeat.has_value() && heartbeat->type == protocol::MessageType::PING)
+    {
+        answerPing(session, *heartbeat);
+        return;
+    }
+
+    if (const auto eta = protocol::parseEtaRequest(frame); eta.has_value())
+    {
+        answerEta(session, *eta);
+        return;
+    }
+
+    _logger.writeLine(session.socket->localPort(), '-', session.id, '-', frame);
+
+    if (frame == protocol::HANDSHAKE_BINARY)
+    {
+        // Client writes binary right after handshake, confirmation is the last text message.
+        session.framer.setFormat(protocol::WireFormat::BINARY);
+        sendData(frame, session.id);
+        session.wireFormat = protocol::WireFormat::BINARY;
+        return;
+    }
+
+    if (const auto [value, check] = utils::parseCoordinateSystem(frame); check)
+    {
+        processClientCommand(session, protocol::makeCoordinateSystem(value));
+        return;
+    }
+
+    // Marked line is parsed as usual, every its point goes to control lane.
+    const auto priorityData = protocol::stripPriorityPrefix(frame);
+    const auto parsed = utils::parseData(priorityData.value_or(frame));
+    const std::vector<RobotData> points(parsed.begin(), parsed.end());
+    if (points.empty())
+    {
+        if (_workMode == WorkMode::SAFE && session.coordinateSystem.has_value())
         {
-            sendData(receivedData, Whereto::SERVER);
-            _coorninateSystem.emplace(value);
+            sendData(std::string(protocol::REJECT_PREFIX) + frame, session.id);
         }
-        else if (_messagesStorage.empty())
+        return;
+    }
+
+    // Program is accepted or rejected as a whole, so robot never stops in the middle of it.
+    if (!acceptPoints(session, points, frame))
+    {
+        return;
+    }
+    for (const auto& point : points)
+    {
+        queuePoint(session, priorityData.has_value() ? protocol::makePriorityPoint(point)
+                                                     : protocol::makePoint(point));
+    }
+}
+
+bool ServerLayer::tryPassThrough(ClientSession& session, std::string& frame)
+{
+    if (session.framer.getFormat() == protocol::WireFormat::BINARY)
+    {
+        // Decoding of fixed-size record is cheap and gives number of point and its coordinates.
+        const auto message = protocol::decode(frame);
+        if (!message.has_value() || message->type != protocol::MessageType::POINT
+            || protocol::isPriority(*message))
         {
-            _messagesStorage = utils::parseData(receivedData);
-            emit signalProcessMessagesStorage();
+            return false;
         }
-        else
+
+        _logger.writeLine(session.socket->localPort(), '-', session.id, '-', "point",
+                          message->sequence);
+        flushSimplifier(session);
+        session.simplifier.reset();
+        enqueueCommand(session, { message->robotData, session.id, _arrivalCounter++,
+                                  session.coordinateSystem, message->sequence,
+                                  std::move(frame), {} });
+        return true;
+    }
+
+    // Handshake and coordinate system change state of session, heartbeats and queue requests
+    // are answered by layer itself and control points skip queue, so they are processed as usual.
+    if (frame.empty() || frame == protocol::HANDSHAKE_BINARY
+        || protocol::parseHeartbeat(frame).has_value()
+        || protocol::parseEtaRequest(frame).has_value()
+        || protocol::stripPriorityPrefix(frame).has_value()
+        || utils::parseCoordinateSystem(frame).second)
+    {
+        return false;
+    }
+
+    _logger.writeLine(session.socket->localPort(), '-', session.id, '-', frame);
+    frame.push_back(protocol::Framer::DELIMITER);
+    flushSimplifier(session);
+    session.simplifier.reset();
+    enqueueCommand(session, { RobotData{}, session.id, _arrivalCounter++,
+                              session.coordinateSystem, 0, std::move(frame), {} });
+    return true;
+}
+
+void ServerLayer::answerPing(const ClientSession& session, const protocol::Message& ping) const
+{
+    // Pong is written at once and not printed, so heartbeat measures link and not console.
+    const QByteArray data = QByteArray::fromStdString(
+        protocol::serialize(protocol::makePong(ping.sequence), session.wireFormat));
+    session.socket->write(data);
+    _robots.at(session.robotId).connection->getStatistics().add(
+        RobotStatistics::BYTES_TO_CLIENTS, static_cast<std::uint64_t>(data.size()));
+    if (_capture)
+    {
+        _capture->write(capture::Event::TO_CLIENT, session.robotId, session.id,
+                        { data.constData(), static_cast<std::size_t>(data.size()) });
+    }
+}
+
+void ServerLayer::answerEta(const ClientSession& session, const protocol::Eta& request)
+{
+    const RobotContext& robot = _robots.at(session.robotId);
+
+    protocol::Eta answer = request;
+    if (!request.sequence.has_value())
+    {
+        answer.time = getProgramEta(session.robotId);
+    }
+    else if (const auto merged = robot.timeline.find(
+                 makeTimelineTag(session.id, *request.sequence)))
+    {
+        answer.time = getBusyTime(session.robotId) + *merged;
+    }
+    else if (const auto queued = session.timeline.find(*request.sequence))
+    {
+        answer.time = getBusyTime(session.robotId) + robot.timeline.getRemaining() + *queued;
+    }
+    sendData(protocol::makeEtaAnswer(answer), session.id);
+}
+
+void ServerLayer::processClientCommand(ClientSession& session, const protocol::Message& message)
+{
+    switch (message.type)
+    {
+        case protocol::MessageType::COORDINATE_SYSTEM:
+            // Points in different coordinate systems don't make one path.
+            flushSimplifier(session);
+            session.simplifier.reset();
+
+            // Coordinate system is sent to robot right before the first point of this client.
+            session.coordinateSystem.emplace(message.coordinateSystem);
+            break;
+
+        case protocol::MessageType::POINT:
+            if (acceptPoints(session, { message.robotData }, protocol::toText(message)))
+            {
+                queuePoint(session, message);
+            }
+            break;
+
+        default:
+            _printer.writeLine(std::cout, "Unexpected message from client", session.id, ':',
+                               protocol::toText(message));
+            break;
+    }
+}
+
+bool ServerLayer::acceptPoints(ClientSession& session, const std::vector<RobotData>& points,
+                               const std::string& source)
+{
+    switch (_workMode)
+    {
+        case WorkMode::SAFE:
         {
-            for (auto&& datum : utils::parseData(receivedData))
+            // Nothing to check against until client tells how to interpret coordinates.
+            if (!session.coordinateSystem.has_value())
+            {
+                return true;
+            }
+
+            const auto rejected = WorkspaceValidator::getRejected(
+                checkCoordinates(points, *session.coordinateSystem));
+            if (rejected.empty())
+            {
+                return true;
+            }
+
+            // Whole program is rejected, so all its points are counted.
+            _robots.at(session.robotId).connection->getStatistics().add(
+                RobotStatistics::REJECTED_POINTS, points.size());
+
+            std::string indices;
+            for (const std::size_t index : rejected)
             {
-                _messagesStorage.emplace_back(datum);
+                indices += ' ' + std::to_string(index);
             }
-            emit signalProcessMessagesStorage();
+            _printer.writeLine(std::cout, "ERROR 03: Incorrect coordinates to send! Points:",
+                               indices);
+            sendData(std::string(protocol::REJECT_PREFIX) + source
+                     + std::string(protocol::REJECT_POINTS) + indices, session.id);
+            return false;
         }
+
+        case WorkMode::UNSAFE:
+            _printer.writeLine(std::cout, "Warning: working in unsafe mode!");
+            return true;
+
+        default:
+            assert(false);
+            return false;
     }
 }
 
-void ServerLayer::slotReadFromServer()
+void ServerLayer::queuePoint(ClientSession& session, const protocol::Message& message)
 {
-    if (_receivingSocket->bytesAvailable() > 0)
+    static const bool kIsSimplified = CONFIG.get<Param::SIMPLIFICATION_WINDOW>() > 0;
+
+    if (protocol::isPriority(message))
     {
-        const QByteArray array = _receivingSocket->readAll();
-        const std::string data = array.toStdString();
+        queuePriorityPoint(session, message);
+        return;
+    }
 
-        _answersStorage.push_back(data);
-        ///sendData(data, Whereto::CLIENT);
-        emit signalProcessAnswersStorage();
+    Command command{ message.robotData, session.id, _arrivalCounter++, session.coordinateSystem,
+                     message.sequence, {}, {} };
+    if (!kIsSimplified)
+    {
+        enqueueCommand(session, std::move(command));
+        return;
+    }
+
+    // Point may stay on hold until next points show if it lies on straight segment.
+    command.trace.id = command.arrivalNumber;
+    command.trace.mark(Command::Stage::RECEIVE, session.readTime);
 
-        _logger.writeLine(_receivingSocket->localPort(), '-', data);
+    const std::uint64_t removed = session.simplifier.getRemoved();
+    auto kept = session.simplifier.push(std::move(command));
+    _robots.at(session.robotId).connection->getStatistics().add(
+        RobotStatistics::SIMPLIFIED_POINTS, session.simplifier.getRemoved() - removed);
+    if (kept.has_value())
+    {
+        enqueueCommand(session, std::move(*kept));
     }
 }
 
-void ServerLayer::slotSendDataToClient(const QByteArray& data) const
+void ServerLayer::queuePriorityPoint(ClientSession& session, const protocol::Message& message)
 {
-    _clientSocket->write(data);
-    _printer.writeLine(std::cout, "Sent data to client:", data.toStdString(), "successfully.\n");
+    static const RobotConnection::PriorityFlush kFlush =
+        !CONFIG.get<Param::PRIORITY_FLUSH>() ? RobotConnection::PriorityFlush::NONE
+        : CONFIG.get<Param::PRIORITY_FLUSH_ALL_SESSIONS>() ? RobotConnection::PriorityFlush::ALL
+                                                           : RobotConnection::PriorityFlush::SESSION;
+
+    Command command{ message.robotData, session.id, _arrivalCounter++, session.coordinateSystem,
+                     message.sequence, {}, {} };
+    command.trace.id = command.arrivalNumber;
+    command.trace.mark(Command::Stage::RECEIVE, session.readTime);
+    command.trace.mark(Command::Stage::ENQUEUE);
+
+    RobotContext& robot = _robots.at(session.robotId);
+    switch (kFlush)
+    {
+        case RobotConnection::PriorityFlush::NONE:
+            flushSimplifier(session);
+            break;
+
+        case RobotConnection::PriorityFlush::SESSION:
+            // Only the sender cancels the rest of its program, other clients keep their work.
+            session.inputQueue.clear();
+            session.simplifier.reset();
+            session.timeline.clear();
+            break;
+
+        case RobotConnection::PriorityFlush::ALL:
+            // Robot stops or returns home for everybody, so the rest of all programs is dropped.
+            for (auto& [sessionId, other] : robot.sessions)
+            {
+                other.inputQueue.clear();
+                other.simplifier.reset();
+                other.timeline.clear();
+            }
+            break;
+    }
+
+    _printer.writeLine(std::cout, "Priority point from session", session.id, "for robot",
+                       session.robotId, ':', message.robotData);
+
+    // Queued call is executed in the next iteration of connection event loop.
+    RobotConnection* connection = robot.connection.get();
+    QMetaObject::invokeMethod(connection,
+                              [connection, command]()
+                              {
+                                  connection->dispatchPriorityCommand(command, kFlush);
+                              },
+                              Qt::QueuedConnection);
+
+    if (kFlush != RobotConnection::PriorityFlush::NONE)
+    {
+        resumeSessions(session.robotId);
+    }
 }
 
-void ServerLayer::slotSendDataToServer(const QByteArray& data) const
+void ServerLayer::flushSimplifier(ClientSession& session)
 {
-    _sendingSocket->write(data);
-    _printer.writeLine(std::cout, "Sent data to server:", data.toStdString(), "successfully.\n");
+    if (session.simplifier.empty())
+    {
+        return;
+    }
+
+    const std::uint64_t removed = session.simplifier.getRemoved();
+    auto kept = session.simplifier.flush();
+    _robots.at(session.robotId).connection->getStatistics().add(
+        RobotStatistics::SIMPLIFIED_POINTS, session.simplifier.getRemoved() - removed);
+    if (kept.has_value())
+    {
+        enqueueCommand(session, std::move(*kept));
+    }
 }
 
-void ServerLayer::slotProcessMessagesStorage()
+void ServerLayer::enqueueCommand(ClientSession& session, Command&& command)
 {
-    while (!_messagesStorage.empty())
+    static const std::size_t kCapacity = CONFIG.get<Param::SESSION_QUEUE_CAPACITY>();
+
+    // Point was received with the last read piece of stream unless it was held by simplifier.
+    if (!command.trace.isMarked(Command::Stage::RECEIVE))
     {
-        // Not move because RobotData is LiteralType (in such case move == copy).
-        const RobotData robotData = _messagesStorage.front();
-        sendData(robotData.toString(), Whereto::SERVER);
+        command.trace.id = command.arrivalNumber;
+        command.trace.mark(Command::Stage::RECEIVE, session.readTime);
+    }
+    command.trace.mark(Command::Stage::ENQUEUE);
+    RobotContext& robot = _robots.at(session.robotId);
+    robot.connection->getStatistics().add(RobotStatistics::POINTS_IN);
 
-        std::this_thread::sleep_for(_delayManager.calculateDuration(_lastReceivedPoint, robotData));
-        _lastReceivedPoint = robotData;
-        _messagesStorage.pop_front();
+    // Program is predicted when it arrives, so time left to any its point is known at once.
+    // Text point forwarded without parsing has no coordinates and takes no time.
+    std::chrono::microseconds duration(0);
+    if (command.rawFrame.empty()
+        || robot.connection->getEndpoint().wireFormat == protocol::WireFormat::BINARY)
+    {
+        duration = robot.delayManager->calculateDuration(session.lastQueuedPoint,
+                                                         command.robotData);
+        session.lastQueuedPoint = command.robotData;
+    }
+    session.timeline.append(command.sequence, duration);
+
+    session.inputQueue.push_back(std::move(command));
+    session.inputHighWaterMark = std::max(session.inputHighWaterMark, session.inputQueue.size());
+
+    // Client streams faster than robot moves, stop reading until robot catches up.
+    if (!session.isPaused && session.inputQueue.size() >= kCapacity)
+    {
+        session.isPaused = true;
+        _printer.writeLine(std::cout, "Queue of session", session.id, "is full, reading paused.");
+        sendData(std::string(protocol::QUEUE_FULL), session.id);
     }
 }
 
-void ServerLayer::slotProcessAnswersStorage()
+void ServerLayer::resumeSessions(const std::size_t robotId)
 {
-    while (!_answersStorage.empty())
+    static const std::size_t kCapacity = CONFIG.get<Param::SESSION_QUEUE_CAPACITY>();
+
+    for (auto& [sessionId, session] : _robots.at(robotId).sessions)
     {
-        if (_clientSocket == nullptr)
+        // Half of queue is free, so client doesn't switch between states on every point.
+        if (!session.isPaused || session.inputQueue.size() > kCapacity / 2)
         {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
             continue;
         }
 
-        const std::string data = std::move(_answersStorage.front());
-        sendData(data, Whereto::CLIENT);
+        session.isPaused = false;
+        _printer.writeLine(std::cout, "Queue of session", sessionId, "is released, reading "
+                           "resumed.");
+        sendData(std::string(protocol::QUEUE_RESUME), sessionId);
+
+        // Data which came during pause doesn't trigger readyRead again.
+        const std::size_t id = sessionId;
+        QMetaObject::invokeMethod(this, [this, robotId, id]() { slotReadFromClient(robotId, id); },
+                                  Qt::QueuedConnection);
+    }
+}
+
+void ServerLayer::slotSendDataToClient(const std::size_t sessionId, const QByteArray& data) const
+{
+    const ClientSession* session = findSession(sessionId);
+    if (session == nullptr)
+    {
+        _printer.writeLine(std::cout, "Session", sessionId, "is closed, data was dropped.");
+        return;
+    }
+
+    session->socket->write(data);
+    _robots.at(session->robotId).connection->getStatistics().add(
+        RobotStatistics::BYTES_TO_CLIENTS, static_cast<std::uint64_t>(data.size()));
+    if (_capture)
+    {
+        _capture->write(capture::Event::TO_CLIENT, session->robotId, sessionId,
+                        { data.constData(), static_cast<std::size_t>(data.size()) });
+    }
+    if (session->wireFormat == protocol::WireFormat::BINARY)
+    {
+        _printer.writeLine(std::cout, "Sent", data.size(), "bytes to client", sessionId,
+                           "successfully.\n");
+    }
+    else
+    {
+        _printer.writeLine(std::cout, "Sent data to client", sessionId, ':', data.toStdString(),
+                           "successfully.\n");
+    }
+}
 
-        _answersStorage.pop_front();
+void ServerLayer::slotAnswerReceived(const std::size_t robotId, const std::size_t sessionId,
+                                     const protocol::Message& answer)
+{
+    if (sessionId != ClientSession::BROADCAST)
+    {
+        sendMessage(answer, sessionId, true);
+        return;
     }
+
+    static const std::size_t kCapacity = CONFIG.get<Param::ANSWERS_CAPACITY>();
+
+    RobotContext& robot = _robots.at(robotId);
+    if (robot.answersStorage.size() >= kCapacity)
+    {
+        _printer.writeLine(std::cout, "Storage of answers from robot", robotId, "is full, the "
+                           "oldest answer was dropped.");
+        robot.answersStorage.pop_front();
+    }
+    robot.answersStorage.push_back(answer);
+    robot.answersHighWaterMark = std::max(robot.answersHighWaterMark, robot.answersStorage.size());
+    processAnswersStorage(robotId);
+}
+
+void ServerLayer::slotCommandsReleased(const std::size_t robotId, const std::size_t count)
+{
+    RobotContext& robot = _robots.at(robotId);
+    robot.queuedCommands -= std::min(count, robot.queuedCommands);
+    robot.timeline.release(count);
+    mergeSessionQueues(robotId);
 }
 
-void ServerLayer::checkConnectionToServer(const long long time)
+void ServerLayer::slotDelayTableChanged(const std::size_t robotId,
+                                        std::shared_ptr<const DelayManager> delayManager)
 {
-    while (true)
+    // Points queued before keep their prediction, they are released soon anyway.
+    _robots.at(robotId).delayManager = std::move(delayManager);
+}
+
+void ServerLayer::slotSampleStatistics()
+{
+    const auto now = std::chrono::steady_clock::now();
+    for (auto& robot : _robots)
     {
-        sendData(_lastReceivedPoint.toString(), Whereto::SERVER);
-        _logger.writeLine(_lastReceivedPoint);
+        robot.connection->getStatistics().sample(now);
+    }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(time));
+    if (_capture)
+    {
+        _capture->flush();
     }
 }
 
-bool ServerLayer::checkCoordinates(const RobotData& robotData) const
+void ServerLayer::processAnswersStorage(const std::size_t robotId)
 {
-    // Get default parameters for checking.
-    static const std::size_t kMainCoordinates = CONFIG.get<Param::NUMBER_OF_MAIN_COORDINATES>();
-    static const std::array<int, 3> kMinCoords = CONFIG.get<Param::MIN_COORDINATES>();
-    static const std::array<int, 3> kMaxCoords = CONFIG.get<Param::MAX_COORDINATES>();
+    RobotContext& robot = _robots.at(robotId);
 
-    for (std::size_t i = 0; i < kMainCoordinates; ++i)
+    // Keep answers until some client connects, it will call this method again.
+    if (robot.sessions.empty())
     {
-        if (robotData.coordinates.at(i) < kMinCoords.at(i)
-         || robotData.coordinates.at(i) > kMaxCoords.at(i))
-        {
-            _printer.writeLine(std::cout, "ERROR 03: Incorrect coordinates to send!", robotData);
-            return false;
-        }
+        return;
     }
 
-    return true;
+    while (!robot.answersStorage.empty())
+    {
+        broadcastMessage(robotId, robot.answersStorage.front());
+        robot.answersStorage.pop_front();
+    }
 }
 
-void ServerLayer::sendData(const std::string& data, const Whereto recipient) const
+void ServerLayer::mergeSessionQueues(const std::size_t robotId)
 {
-    switch (recipient)
+    static const std::size_t kMaxMergedCommands = CONFIG.get<Param::MAX_MERGED_COMMANDS>();
+
+    RobotContext& robot = _robots.at(robotId);
+
+    // Robot queue is kept short, so arbitration policy takes effect almost immediately.
+    std::size_t merged = 0;
+    while (robot.queuedCommands < kMaxMergedCommands)
     {
-        case Whereto::SERVER:
-            emit signalToSendToServer(data.c_str());
-            break;
-        
-        case Whereto::CLIENT:
-            emit signalToSendToClient(data.c_str());
+        const auto sessionId = robot.arbiter.selectSession(robot.sessions);
+        if (!sessionId.has_value())
+        {
             break;
-        
-        default:
-            assert(false);
+        }
+
+        // Ring is sized to hold all merged points, so this fails only if counter is broken.
+        ClientSession& session = robot.sessions.at(*sessionId);
+        const Command& command = session.inputQueue.front();
+        const std::uint64_t tag = makeTimelineTag(command.sessionId, command.sequence);
+        if (!robot.connection->pushCommand(command))
+        {
             break;
+        }
+        session.inputQueue.pop_front();
+
+        // Point keeps its prediction, robot queue is released in the same order as it is filled.
+        robot.timeline.append(tag, session.timeline.release(1));
+        ++robot.queuedCommands;
+        ++merged;
+    }
+
+    if (merged == 0)
+    {
+        return;
     }
+
+    resumeSessions(robotId);
+
+    RobotConnection* connection = robot.connection.get();
+    QMetaObject::invokeMethod(connection, [connection]() { connection->dispatchPoints(); },
+                              Qt::QueuedConnection);
 }
 
-void ServerLayer::launch()
+WorkspaceValidator::Verdicts ServerLayer::checkCoordinates(
+    const std::vector<RobotData>& points, const CoordinateSystem coordinateSystem) const
 {
-    if (_layerSocket->listen(QHostAddress::Any, _layerPort))
+    return _workspaceValidator.validate(points, coordinateSystem);
+}
+
+std::string ServerLayer::makeStatisticsReport() const
+{
+    std::ostringstream report;
+    for (std::size_t robotId = 0; robotId < _robots.size(); ++robotId)
     {
-        _printer.writeLine(std::cout, "Layer server is started!");
+        const RobotContext& robot = _robots[robotId];
+        RobotStatistics& statistics = robot.connection->getStatistics();
+        const std::string label = "{robot=\"" + std::to_string(robotId) + "\"} ";
+
+        std::size_t sessionsQueue = 0;
+        for (const auto& [sessionId, session] : robot.sessions)
+        {
+            sessionsQueue += session.inputQueue.size();
+        }
+
+        // Queues first, monitoring alerts on them before operator notices anything.
+        report << "layer_sessions" << label << robot.sessions.size() << '\n'
+               << "layer_sessions_queue" << label << sessionsQueue << '\n'
+               << "layer_robot_queue" << label << robot.connection->getQueueSize() << '\n'
+               << "layer_merged_points" << label << robot.queuedCommands << '\n'
+               << "layer_in_flight" << label << statistics.getInFlight() << '\n'
+               << "layer_answers_storage" << label << robot.answersStorage.size() << '\n'
+               << "layer_answers_storage_high_water_mark" << label
+               << robot.answersHighWaterMark << '\n'
+               << "layer_program_eta_microseconds" << label
+               << getProgramEta(robotId).count() << '\n';
+
+        for (std::size_t i = 0; i < RobotStatistics::NUMBER_OF_COUNTERS; ++i)
+        {
+            const auto counter = static_cast<RobotStatistics::Counter>(i);
+            const std::string name(RobotStatistics::getName(counter));
+            report << "layer_" << name << "_total" << label << statistics.get(counter) << '\n'
+                   << "layer_" << name << "_per_second" << label << statistics.getRate(counter)
+                   << '\n';
+        }
+
+        // Sums are kept instead of means, so counters stay lock-free.
+        const std::uint64_t predictions = statistics.get(RobotStatistics::PREDICTIONS);
+        if (predictions > 0)
+        {
+            report << "layer_mean_predicted_microseconds" << label
+                   << statistics.get(RobotStatistics::PREDICTED_MICROSECONDS) / predictions
+                   << '\n'
+                   << "layer_mean_actual_microseconds" << label
+                   << statistics.get(RobotStatistics::ACTUAL_MICROSECONDS) / predictions << '\n'
+                   << "layer_mean_prediction_error_microseconds" << label
+                   << statistics.get(RobotStatistics::PREDICTION_ERROR_MICROSECONDS)
+                      / predictions
+                   << '\n';
+
+            // Mean of the last period shows if calibration of delays converges.
+            const double predictionsRate = statistics.getRate(RobotStatistics::PREDICTIONS);
+            if (predictionsRate > 0.0)
+            {
+                report << "layer_recent_prediction_error_microseconds" << label
+                       << statistics.getRate(RobotStatistics::PREDICTION_ERROR_MICROSECONDS)
+                          / predictionsRate
+                       << '\n';
+            }
+        }
+
+        // Control lane is reported apart, its latency must not drown in queued points.
+        const std::uint64_t priorityCommands = statistics.get(RobotStatistics::PRIORITY_COMMANDS);
+        if (priorityCommands > 0)
+        {
+            report << "layer_mean_priority_dispatch_microseconds" << label
+                   << statistics.get(RobotStatistics::PRIORITY_DISPATCH_MICROSECONDS)
+                      / priorityCommands
+                   << '\n';
+        }
     }
-    else
+    return report.str();
+}
+
+std::chrono::microseconds ServerLayer::getProgramEta(const std::size_t robotId) const
+{
+    const RobotContext& robot = _robots.at(robotId);
+    std::chrono::microseconds result = getBusyTime(robotId) + robot.timeline.getRemaining();
+    for (const auto& [sessionId, session] : robot.sessions)
     {
-        _printer.writeLine(std::cout, "Layer server is not started!");
+        result += session.timeline.getRemaining();
     }
-    doConnection();
+    return result;
 }
 
-bool ServerLayer::tryConnect(const int port, const std::string& ip,
-                             QTcpSocket* const socketToConnect, const int msecs) const
+std::chrono::microseconds ServerLayer::getBusyTime(const std::size_t robotId) const
 {
-    if (socketToConnect->isOpen())
+    const auto idleTime = _robots.at(robotId).connection->getIdleTime();
+    const auto now = std::chrono::steady_clock::now();
+    if (idleTime <= now)
     {
-        socketToConnect->close();
+        return std::chrono::microseconds(0);
     }
+    return std::chrono::duration_cast<std::chrono::microseconds>(idleTime - now);
+}
 
-    socketToConnect->connectToHost(ip.c_str(), port);
+WorkspaceValidator::Limits ServerLayer::makeWorkspaceLimits()
+{
+    // Get default parameters for checking.
+    const std::size_t kMainCoordinates = CONFIG.get<Param::NUMBER_OF_MAIN_COORDINATES>();
+    const std::array<int, 3> kMinCoords = CONFIG.get<Param::MIN_COORDINATES>();
+    const std::array<int, 3> kMaxCoords = CONFIG.get<Param::MAX_COORDINATES>();
 
-    if (socketToConnect->waitForConnected(msecs))
+    WorkspaceValidator::Limits limits = WorkspaceValidator::DEFAULT_LIMITS;
+    for (std::size_t i = 0; i < std::min(kMainCoordinates, kMinCoords.size()); ++i)
     {
-        _printer.writeLine(std::cout, "Connected to Server!");
-        return true;
+        limits.minCoordinates[i] = kMinCoords[i];
+        limits.maxCoordinates[i] = kMaxCoords[i];
+    }
+    return limits;
+}
+
+void ServerLayer::sendData(const std::string& data, const std::size_t sessionId)
+{
+    sendMessage(protocol::makeText(data), sessionId);
+}
+
+void ServerLayer::sendMessage(protocol::Message message, const std::size_t sessionId,
+                              const bool isReply)
+{
+    ClientSession* session = findSession(sessionId);
+    if (session == nullptr)
+    {
+        _printer.writeLine(std::cout, "Session", sessionId, "is closed, data was dropped.");
+        return;
     }
 
-    _printer.writeLine(std::cout, "Not connected to Server!");
-    return false;
+    // Every client gets message in format it negotiated and with its own numbering.
+    if (!isReply)
+    {
+        message.sequence = session->sequence++;
+    }
+    emit signalToSendToClient(sessionId, QByteArray::fromStdString(
+        protocol::serialize(message, session->wireFormat)));
 }
 
-void ServerLayer::doConnection()
+void ServerLayer::broadcastMessage(const std::size_t robotId, const protocol::Message& message)
 {
-    // Remember that sending socket should be connect to server receiving port
-    // and receiving socket should be connect to server sending port!
-    bool isConnected = tryConnect(_serverReceivingPort, _serverIP, _sendingSocket.get())
-                    && tryConnect(_serverSendingPort, _serverIP, _receivingSocket.get());
-    while (!isConnected)
+    for (const auto& [sessionId, session] : _robots.at(robotId).sessions)
     {
-        isConnected = tryConnect(_serverReceivingPort, _serverIP, _sendingSocket.get())
-                   && tryConnect(_serverSendingPort, _serverIP, _receivingSocket.get());
+        sendMessage(message, sessionId);
+    }
+}
 
-        std::this_thread::sleep_for(
-            std::chrono::milliseconds(CONFIG.get<Param::RECONNECTION_DELAY>()));
+ClientSession* ServerLayer::findSession(const std::size_t sessionId)
+{
+    for (auto& robot : _robots)
+    {
+        if (const auto it = robot.sessions.find(sessionId); it != robot.sessions.end())
+        {
+            return &it->second;
+        }
     }
+    return nullptr;
+}
 
-    _printer.writeLine(std::cout, "\nServerLayer launched...\n");
-    _logger.writeLine("\nServerLayer launched at", utils::getCurrentSystemTime());
+const ClientSession* ServerLayer::findSession(const std::size_t sessionId) const
+{
+    for (const auto& robot : _robots)
+    {
+        if (const auto it = robot.sessions.find(sessionId); it != robot.sessions.end())
+        {
+            return &it->second;
+        }
+    }
+    return nullptr;
 }
 
-void ServerLayer::tryReconnectToServer()
+void ServerLayer::launch()
 {
-    doConnection();
+    for (auto& robot : _robots)
+    {
+        const int layerPort = robot.connection->getEndpoint().layerPort;
+        if (robot.layerSocket->listen(QHostAddress::Any, layerPort))
+        {
+            _printer.writeLine(std::cout, "Layer server is started on port", layerPort);
+        }
+        else
+        {
+            _printer.writeLine(std::cout, "Layer server is not started on port", layerPort);
+        }
+
+        robot.thread->start();
+    }
+
+    // Zero port turns statistics off.
+    const int statisticsPort = CONFIG.get<Param::STATISTICS_PORT>();
+    const bool isStatisticsServed = statisticsPort > 0 && _statisticsServer->listen(statisticsPort);
+    if ((isStatisticsServed || _capture) && _statisticsTimer->interval() > 0)
+    {
+        _statisticsTimer->start();
+    }
+
+    _printer.writeLine(std::cout, "\nServerLayer launched...\n");
+    _logger.writeLine("\nServerLayer launched at", utils::getCurrentSystemTime());
 }
 
 } // namespace vasily
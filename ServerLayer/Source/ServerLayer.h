@@ -1,21 +1,32 @@
 #ifndef SERVER_LAYER
 #define SERVER_LAYER
 
+#include <chrono>
+#include <map>
+#include <memory>
 #include <optional>
+#include <vector>
 
 #include <QObject>
+#include <QThread>
 #include <QTcpSocket>
 #include <QTcpServer>
+#include <QTimer>
 
 #include "Utilities.h"
+#include "Arbiter.h"
+#include "ClientSession.h"
 #include "DelayManager.h"
+#include "RobotConnection.h"
+#include "StatisticsServer.h"
+#include "WorkspaceValidator.h"
 
 
 namespace vasily
 {
 
 /**
- * \brief Class used to bind clients and robot as server.
+ * \brief Class used to bind clients and robots as server.
  *        Also provides additional toolset to process received data.
  */
 class ServerLayer : public QObject
@@ -45,7 +56,30 @@ public:
         NUMBER_OF_MAIN_COORDINATES,
         MIN_COORDINATES,
         MAX_COORDINATES,
-        RECONNECTION_DELAY
+        RECONNECTION_DELAY,
+        MAX_MERGED_COMMANDS,
+        DEFAULT_ROBOTS_FILE_NAME,
+        ACK_WINDOW,
+        ACK_TIMEOUT,
+        SESSION_QUEUE_CAPACITY,
+        ANSWERS_CAPACITY,
+        MAX_RECONNECTION_DELAY,
+        CONNECTION_TIMEOUT,
+        HEARTBEAT_INTERVAL,
+        MAX_MISSED_HEARTBEATS,
+        TRACE_FILE_PREFIX,
+        STATISTICS_PORT,
+        STATISTICS_PERIOD,
+        SIMPLIFICATION_TOLERANCE,
+        SIMPLIFICATION_WINDOW,
+        PRIORITY_FLUSH,
+        PRIORITY_FLUSH_ALL_SESSIONS,
+        CAPTURE_FILE_NAME,
+        DELAY_LOGGING,
+        DELAY_LEARNING_RATE,
+        DELAY_SAVE_PERIOD,
+        DELAY_TABLE_FILE_PREFIX,
+        ARBITRATION_POLICY
     };
 
     /**
@@ -54,32 +88,52 @@ public:
      *          std::string because of std::istream and std::ostream.
      */
     static const config::Config<std::string, std::string, std::string_view, int, int, int,
-                                std::size_t, std::array<int, 3>, std::array<int, 3>, long long>
+                                std::size_t, std::array<int, 3>, std::array<int, 3>, long long,
+                                std::size_t, std::string, std::size_t, long long, std::size_t,
+                                std::size_t, long long, long long, long long, std::size_t,
+                                std::string, int, long long, std::array<int, 2>, std::size_t,
+                                bool, bool, std::string, bool, double, long long, std::string,
+                                std::string_view>
         CONFIG;
 
     /**
-     * \brief                         Constructor that initializes sockets, connects to server and
-     *                                creates socket to work with clients.
+     * \brief                         Constructor that initializes sockets to work with one robot
+     *                                and creates socket to work with clients.
      * \param[in] serverReceivingPort Server port to receiive.
      * \param[in] serverSendingPort   Server port to send.
      * \param[in] serverIP            Server IP address for connection.
      * \param[in] layerPort           Additional port to communicate with clients.
      * \param[in] workMode            Set work mode for layer to work with robot in safety
      *                                or unsafety.
+     * \param[in] arbitration         Policy used to merge clients queues into robot queue.
      * \param[in] parent              The necessary data for Qt.
      */
     explicit ServerLayer(
-        const int serverReceivingPort   = CONFIG.get<Param::DEFAULT_RECEIVING_PORT_FROM_SERVER>(),
-        const int serverSendingPort     = CONFIG.get<Param::DEFAULT_SENDING_PORT_TO_SERVER>(),
-        const std::string_view serverIP = CONFIG.get<Param::DEFAULT_SERVER_IP>(),
-        const int layerPort             = CONFIG.get<Param::DEFAULT_LAYER_PORT>(),
-        const WorkMode workMode         = WorkMode::SAFE,
-        QObject* parent                 = nullptr);
+        const int serverReceivingPort     = CONFIG.get<Param::DEFAULT_RECEIVING_PORT_FROM_SERVER>(),
+        const int serverSendingPort       = CONFIG.get<Param::DEFAULT_SENDING_PORT_TO_SERVER>(),
+        const std::string_view serverIP   = CONFIG.get<Param::DEFAULT_SERVER_IP>(),
+        const int layerPort               = CONFIG.get<Param::DEFAULT_LAYER_PORT>(),
+        const WorkMode workMode           = WorkMode::SAFE,
+        const Arbiter::Policy arbitration = Arbiter::Policy::FIFO,
+        QObject* parent                   = nullptr);
 
     /**
-     * \brief Destructor that closes client socket.
+     * \brief                 Constructor that initializes connections to several robots. Every
+     *                        robot gets its own thread and its own port for clients.
+     * \param[in] endpoints   Robots addresses and ports.
+     * \param[in] workMode    Set work mode for layer to work with robots in safety or unsafety.
+     * \param[in] arbitration Policy used to merge clients queues into robot queue.
+     * \param[in] parent      The necessary data for Qt.
      */
-    virtual         ~ServerLayer() = default;
+    explicit ServerLayer(const std::vector<RobotConnection::Endpoint>& endpoints,
+                         const WorkMode workMode           = WorkMode::SAFE,
+                         const Arbiter::Policy arbitration = Arbiter::Policy::FIFO,
+                         QObject* parent                   = nullptr);
+
+    /**
+     * \brief Destructor that stops robots threads.
+     */
+    virtual         ~ServerLayer();
 
     /**
      * \brief           Deleted copy constructor.
@@ -113,213 +167,362 @@ public:
     void            launch();
 
     /**
-     * \brief               Check if given point is not out of working coordinates.
-     * \param[in] robotData	Point to check.
-     * \return              True if point is correct, false otherwise.
+     * \brief                      Check if given points are not out of robot workspace.
+     * \param[in] points           Points to check (usually the whole message from client).
+     * \param[in] coordinateSystem Coordinate system which points are given in.
+     * \return                     Verdict for every point.
      */
-    bool		    checkCoordinates(const RobotData& robotData) const;
+    WorkspaceValidator::Verdicts checkCoordinates(const std::vector<RobotData>& points,
+                                                  const CoordinateSystem coordinateSystem) const;
+
+    /**
+     * \brief   Build report about queues and counters of all robots.
+     * \details Every line is "layer_<name>{robot=\"<index>\"} <value>", so report can be
+     *          scraped by monitoring as is. Rates are calculated over the last sample period.
+     * \return  Report text.
+     */
+    std::string     makeStatisticsReport() const;
 
 
 signals:
     /**
-     * \brief          Notify layer to send data to client.
-     * \param[in] data Data to be send.
+     * \brief               Notify layer to send data to client.
+     * \param[in] sessionId Session of client to send.
+     * \param[in] data      Data to be send.
      */
-    void signalToSendToClient(const QByteArray& data) const;
+    void signalToSendToClient(const std::size_t sessionId, const QByteArray& data) const;
+
 
+private slots:
     /**
-     * \brief          Notify layer to send data to server.
-     * \param[in] data Data to be send.
+     * \brief             Process new client connection to layer.
+     * \param[in] robotId Robot which port client connected to.
      */
-    void signalToSendToServer(const QByteArray& data) const;
+    void slotNewClientConnection(const std::size_t robotId);
 
     /**
-     * \brief Notify layer that message from client was received and
-     *        needs to be processed.
+     * \brief               Process client disconnection from layer.
+     * \param[in] robotId   Robot which client works with.
+     * \param[in] sessionId Session of disconnected client.
      */
-    void signalProcessMessagesStorage();
+    void slotClientDisconnected(const std::size_t robotId, const std::size_t sessionId);
 
     /**
-     * \brief Notify layer that answer from server was received and
-     *        needs to be processed.
+     * \brief               Receive data from client.
+     * \param[in] robotId   Robot which client works with.
+     * \param[in] sessionId Session of client which sent data.
      */
-    void signalProcessAnswersStorage();
+    void slotReadFromClient(const std::size_t robotId, const std::size_t sessionId);
 
+    /**
+     * \brief               Send data to client after notifying from signal.
+     * \param[in] sessionId Session of client to send.
+     * \param[in] data      Data to be send.
+     */
+    void slotSendDataToClient(const std::size_t sessionId, const QByteArray& data) const;
 
-private slots:
     /**
-     * \brief Process new client connection to layer.
+     * \brief               Process answer received from robot.
+     * \param[in] robotId   Robot which sent answer.
+     * \param[in] sessionId Session which answer belongs to.
+     * \param[in] answer    Received answer.
      */
-    void slotNewClientConnection();
+    void slotAnswerReceived(const std::size_t robotId, const std::size_t sessionId,
+                            const protocol::Message& answer);
 
     /**
-     * \brief Process client disconnection from layer.
+     * \brief             Take into account that points left robot queue and merge new ones.
+     * \param[in] robotId Robot which queue was changed.
+     * \param[in] count   Number of points.
      */
-    void slotClientDisconnected();
+    void slotCommandsReleased(const std::size_t robotId, const std::size_t count);
 
     /**
-     * \brief Process server disconnection from layer.
+     * \brief                  Predict queued points of robot with its corrected delay table.
+     * \param[in] robotId      Robot which table was changed.
+     * \param[in] delayManager Copy of delay table.
      */
-    void slotServerDisconnected();
+    void slotDelayTableChanged(const std::size_t robotId,
+                               std::shared_ptr<const DelayManager> delayManager);
 
     /**
-     * \brief Receive data from client
+     * \brief Remember counters of all robots to calculate rates and write buffered capture to
+     *        file, so capture survives killed layer.
      */
-    void slotReadFromClient();
+    void slotSampleStatistics();
+
 
+protected:
     /**
-     * \brief Receive data from server.
+     * \brief Structure which keeps everything layer knows about one robot.
      */
-    void slotReadFromServer();
+    struct RobotContext
+    {
+        /**
+         * \brief Connected socket used to receive clients of this robot.
+         */
+        std::unique_ptr<QTcpServer>             layerSocket;
+
+        /**
+         * \brief Connection which works with robot in its own thread.
+         */
+        std::unique_ptr<RobotConnection>        connection;
+
+        /**
+         * \brief Thread which connection lives in.
+         */
+        std::unique_ptr<QThread>                thread;
+
+        /**
+         * \brief Table of connected clients sorted by session identifier.
+         */
+        std::map<std::size_t, ClientSession>    sessions;
+
+        /**
+         * \brief Class used to merge clients queues into robot queue.
+         */
+        Arbiter                                 arbiter;
+
+        /**
+         * \brief Number of points which were passed to connection and are still in its queue.
+         */
+        std::size_t                             queuedCommands;
+
+        /**
+         * \brief Queue used to keeps answers from robot until some client connects (the oldest
+         *        answers are dropped when it is full).
+         */
+        std::deque<protocol::Message>           answersStorage;
+
+        /**
+         * \brief The largest number of answers which were kept in storage.
+         */
+        std::size_t                             answersHighWaterMark;
+
+        /**
+         * \brief Delay table used to predict queued points, replaced when robot corrects it.
+         */
+        std::shared_ptr<const DelayManager>     delayManager;
+
+        /**
+         * \brief Predicted durations of points merged into robot queue, tagged by session and
+         *        sequence of point.
+         */
+        utils::Timeline                         timeline;
+    };
 
     /**
-     * \brief          Send data to client after notifying from signal.
-     * \param[in] data Data to be send.
+     * \brief Implementation of type-safe output printer.
      */
-    void slotSendDataToClient(const QByteArray& data) const;
+    printer::Printer&               _printer = printer::Printer::getInstance();
 
     /**
-     * \brief          Send data to server after notifying from signal.
-     * \param[in] data Data to be send.
+     * \brief Identifier which will be given to the next connected client.
      */
-    void slotSendDataToServer(const QByteArray& data) const;
+    std::size_t                     _nextSessionId;
 
     /**
-     * \brief Process received message from client after notifying from signal.
+     * \brief Counter used to number points in order of arrival from all clients.
      */
-    void slotProcessMessagesStorage();
+    std::uint64_t                   _arrivalCounter;
 
     /**
-     * \brief Process received answer from server after notifying from signal.
+     * \brief Variable used to determine which layer are working in.
      */
-    void slotProcessAnswersStorage();
+    WorkMode                        _workMode;
 
+    /**
+     * \brief Logger used to write received data to file.
+     */
+    logger::Logger                  _logger;  // ORDER DEPENDENCY => 1.
 
-protected:
     /**
-     * \brief A set of constants used to specify the recipient in the send function.
+     * \brief Class used to calculate delays, every robot connection gets its copy.
      */
-    enum class Whereto
-    {
-        SERVER,
-        CLIENT
-    };
+    DelayManager                    _delayManager;  // ORDER DEPENDENCY => 2.
 
     /**
-     * \brief Implementation of type-safe output printer.
+     * \brief Class used to check points from clients in safe mode.
      */
-    printer::Printer&               _printer = printer::Printer::getInstance();
+    WorkspaceValidator              _workspaceValidator;
 
     /**
-     * \brief Variable used to keep reciving port.
+     * \brief Capture of all traffic of layer or nullptr if capture is turned off (shared with
+     *        robots connections, so it has to outlive them).
      */
-    int                             _layerPort;
+    std::unique_ptr<capture::CaptureWriter> _capture;
 
     /**
-     * \brief Connected socket used to receive data.
+     * \brief Robots which layer works with, index in container is robot identifier.
      */
-    std::unique_ptr<QTcpServer>	    _layerSocket;
+    std::vector<RobotContext>       _robots;
 
     /**
-     * \brief Pointer to socket used to work with clients.
+     * \brief Server used to give statistics report to monitoring.
      */
-    QTcpSocket*                     _clientSocket;
+    std::unique_ptr<StatisticsServer>   _statisticsServer;
 
     /**
-     * \brief Variable used to keep recieving server port.
+     * \brief Timer used to sample counters of robots.
      */
-    int	                            _serverReceivingPort;
+    std::unique_ptr<QTimer>             _statisticsTimer;
+
 
     /**
-     * \brief Connected to server socket used to receive data.
+     * \brief               Send text to client on a connected socket.
+     * \param[in] data      A buffer containing the data to be transmitted.
+     * \param[in] sessionId Session of client to send.
      */
-    std::unique_ptr<QTcpSocket>     _receivingSocket;
+    void sendData(const std::string& data, const std::size_t sessionId);
 
     /**
-     * \brief Variable used to keep sending server port.
+     * \brief               Send message to client in format which client negotiated.
+     * \param[in] message   Message to send.
+     * \param[in] sessionId Session of client to send.
+     * \param[in] isReply   Reply keeps sequence number of point it answers.
      */
-    int                             _serverSendingPort;
+    void sendMessage(protocol::Message message, const std::size_t sessionId,
+                     const bool isReply = false);
 
     /**
-     * \brief Connected to server socket used to send data.
+     * \brief             Send message to all clients of robot.
+     * \param[in] robotId Robot which clients should receive message.
+     * \param[in] message Message to send.
      */
-    std::unique_ptr<QTcpSocket>     _sendingSocket;
+    void broadcastMessage(const std::size_t robotId, const protocol::Message& message);
 
     /**
-     * \brief Variable used to keep server IP address.
+     * \brief              Process one complete message from client.
+     * \param[out] session Session which sent message.
+     * \param[in] frame    Message without delimiter (text format) or with header (binary one).
      */
-    std::string                     _serverIP;
+    void processClientMessage(ClientSession& session, const std::string& frame);
 
     /**
-     * \brief Variable used to keep coordinate type from client.
+     * \brief              Answer heartbeat of client.
+     * \param[in] session Session which sent ping.
+     * \param[in] ping    Received ping.
      */
-    std::optional<CoordinateSystem>	_coorninateSystem;
+    void answerPing(const ClientSession& session, const protocol::Message& ping) const;
 
     /**
-     * \brief Variable used to determine which layer are working in. 
+     * \brief             Tell client how much time is left to its point or to the end of
+     *                    robot queue.
+     * \details           Time of point counts points which are before it in robot queue and in
+     *                    queue of this client. Points of other clients which arbiter merges
+     *                    before it are not known yet, so they are counted only in total time.
+     * \param[in] session Session which asked.
+     * \param[in] request Requested point.
      */
-    WorkMode                        _workMode;
+    void answerEta(const ClientSession& session, const protocol::Eta& request);
 
     /**
-     * \brief Last received data from client.
+     * \brief             Get time left to the end of all points of robot.
+     * \param[in] robotId Index of robot.
+     * \return            Predicted time of points sent to robot and all queued points.
      */
-    RobotData                       _lastReceivedPoint;
+    std::chrono::microseconds getProgramEta(const std::size_t robotId) const;
 
     /**
-     * \brief Queue used to keeps received messages from clients.
+     * \brief             Get time left until robot finishes points sent to it.
+     * \param[in] robotId Index of robot.
+     * \return            Predicted time or 0 if robot is idle.
      */
-    std::deque<RobotData>           _messagesStorage;
+    std::chrono::microseconds getBusyTime(const std::size_t robotId) const;
 
     /**
-     * \brief Queue used to keeps received messages from server.
+     * \brief              Queue point from client without parsing and re-encoding (only for
+     *                     unsafe mode when client and robot use the same format).
+     * \param[out] session Session which sent message.
+     * \param[out] frame   Message from client, it is moved to queue if point was accepted.
+     * \return             True if message was queued, false if it has to be processed as usual.
      */
-    std::deque<std::string>         _answersStorage;
+    bool tryPassThrough(ClientSession& session, std::string& frame);
 
     /**
-     * \brief Logger used to write received data to file.
+     * \brief              Process decoded command from client.
+     * \param[out] session Session which sent command.
+     * \param[in] message  Point or coordinate system.
      */
-    logger::Logger                  _logger;  // ORDER DEPENDENCY => 1.
+    void processClientCommand(ClientSession& session, const protocol::Message& message);
 
     /**
-     * \brief Class used to calculate delays.
+     * \brief              Check points according to work mode and reply to client which points
+     *                     are incorrect.
+     * \param[out] session Session which sent points.
+     * \param[in] points   Points of one message.
+     * \param[in] source   Message used in reply to client.
+     * \return             True if all points can be queued, false if message is rejected.
      */
-    DelayManager                    _delayManager;  // ORDER DEPENDENCY => 2.
+    bool acceptPoints(ClientSession& session, const std::vector<RobotData>& points,
+                      const std::string& source);
 
+    /**
+     * \brief              Add accepted point to queue of session.
+     * \param[out] session Session which sent point.
+     * \param[in] message  Point with sequence number of client.
+     */
+    void queuePoint(ClientSession& session, const protocol::Message& message);
 
     /**
-     * \brief          Check connection to robot every time.
-     * \param[in] time Period time to check.
+     * \brief              Pass control point (stop, return home) to robot connection at once,
+     *                     bypassing queues of sessions and arbitration.
+     * \param[out] session Session which sent point.
+     * \param[in] message  Point with sequence number of client.
      */
-    void checkConnectionToServer(const long long time);
+    void queuePriorityPoint(ClientSession& session, const protocol::Message& message);
 
     /**
-     * \brief               Send data on a connected socket.
-     * \param[in] data      A buffer containing the data to be transmitted.
-     * \param[in] recipient Specifies the recipient.
+     * \brief              Queue point which path simplification kept on hold.
+     * \param[out] session Session which sent points.
+     */
+    void flushSimplifier(ClientSession& session);
+
+    /**
+     * \brief              Add point to queue of session and pause reading if queue is full.
+     * \param[out] session Session which sent point.
+     * \param[in] command  Point with information about its origin.
+     */
+    void enqueueCommand(ClientSession& session, Command&& command);
+
+    /**
+     * \brief             Continue reading from paused sessions which queues were released.
+     * \param[in] robotId Robot which clients should be checked.
+     */
+    void resumeSessions(const std::size_t robotId);
+
+    /**
+     * \brief  Build workspace limits from position limits in config.
+     * \return Limits for validator.
+     */
+    static WorkspaceValidator::Limits makeWorkspaceLimits();
+
+    /**
+     * \brief             Move points from clients queues into robot queue using arbitration
+     *                    policy.
+     * \param[in] robotId Robot which queue should be filled.
      */
-    void sendData(const std::string& data, const Whereto recipient) const;
+    void mergeSessionQueues(const std::size_t robotId);
 
     /**
-     * \brief                        Establishe a connection to a specified socket.
-     * \param[in] port               Port for connection.
-     * \param[in] ip                 IP address for connection.
-     * \param[out] socketToConnect   A descriptor identifying an unconnected socket.
-     * \param[in] msecs              Time which Qt waits until the socket is connected. If this
-     *                               parameter is -1, function will not time out.
-     * \return                       If no error occurs, connect returns true, false otherwise.
+     * \brief             Send kept answers to clients of robot.
+     * \param[in] robotId Robot which answers should be sent.
      */
-    bool tryConnect(const int port, const std::string& ip, QTcpSocket* const socketToConnect,
-                    const int msecs = 3000) const;
+    void processAnswersStorage(const std::size_t robotId);
 
     /**
-     * \brief Try to establish a connection to server again.
+     * \brief               Find session among clients of all robots.
+     * \param[in] sessionId Session to find.
+     * \return              Pointer to session or nullptr if session is closed.
      */
-    void tryReconnectToServer();
+    ClientSession*       findSession(const std::size_t sessionId);
 
     /**
-     * \brief Additional method which contains all connection calls. 
+     * \brief               Find session among clients of all robots.
+     * \param[in] sessionId Session to find.
+     * \return              Pointer to session or nullptr if session is closed.
      */
-    void doConnection();
+    const ClientSession* findSession(const std::size_t sessionId) const;
 };
 
 } // namespace vasily
@@ -0,0 +1,60 @@
+#include "StatisticsServer.h"
+
+
+namespace vasily
+{
+
+StatisticsServer::StatisticsServer(ReportBuilder reportBuilder, QObject* parent)
+    : QObject(parent),
+      _server(std::make_unique<QTcpServer>(this)),
+      _reportBuilder(std::move(reportBuilder))
+{
+    connect(_server.get(), &QTcpServer::newConnection, this,
+            &StatisticsServer::slotNewConnection);
+}
+
+bool StatisticsServer::listen(const int port)
+{
+    if (!_server->listen(QHostAddress::LocalHost, static_cast<quint16>(port)))
+    {
+        _printer.writeLine(std::cout, "Statistics server is not started on port", port);
+        return false;
+    }
+
+    _printer.writeLine(std::cout, "Statistics server is started on port", port);
+    return true;
+}
+
+void StatisticsServer::slotNewConnection()
+{
+    while (_server->hasPendingConnections())
+    {
+        QTcpSocket* socket = _server->nextPendingConnection();
+        connect(socket, &QTcpSocket::readyRead, this,
+                [this, socket]() { slotReadRequest(socket); });
+        connect(socket, &QTcpSocket::disconnected, socket, &QTcpSocket::deleteLater);
+    }
+}
+
+void StatisticsServer::slotReadRequest(QTcpSocket* socket)
+{
+    // The first piece of request is enough to choose format, the rest is ignored.
+    const QByteArray request = socket->readAll();
+    disconnect(socket, &QTcpSocket::readyRead, this, nullptr);
+
+    const std::string report = _reportBuilder();
+    if (request.startsWith("GET "))
+    {
+        const std::string header = "HTTP/1.0 200 OK\r\n"
+                                   "Content-Type: text/plain; version=0.0.4\r\n"
+                                   "Content-Length: " + std::to_string(report.size()) + "\r\n"
+                                   "Connection: close\r\n\r\n";
+        socket->write(header.data(), static_cast<qint64>(header.size()));
+    }
+    socket->write(report.data(), static_cast<qint64>(report.size()));
+
+    // Socket is deleted after all data is written and peer is disconnected.
+    socket->disconnectFromHost();
+}
+
+} // namespace vasily
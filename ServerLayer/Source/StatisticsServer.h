@@ -0,0 +1,99 @@
+#ifndef STATISTICS_SERVER_H
+#define STATISTICS_SERVER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include "Utilities.h"
+
+
+namespace vasily
+{
+
+/**
+ * \brief   Class used to give statistics report to monitoring on local port.
+ * \details Every connection gets one report and is closed. Request which starts with "GET " is
+ *          answered as minimal HTTP, so report can be read by browser, curl or scraper; any other
+ *          request (e.g. empty line from netcat) gets plain text.
+ */
+class StatisticsServer : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * \brief Function used to build report at the moment of request.
+     */
+    using ReportBuilder = std::function<std::string()>;
+
+
+    /**
+     * \brief                   Constructor that initializes server socket.
+     * \param[in] reportBuilder Function used to build report.
+     * \param[in] parent        The necessary data for Qt.
+     */
+    explicit            StatisticsServer(ReportBuilder reportBuilder, QObject* parent = nullptr);
+
+    /**
+     * \brief Default destructor.
+     */
+    virtual             ~StatisticsServer() = default;
+
+    /**
+     * \brief           Deleted copy constructor.
+     * \param[in] other Other object.
+     */
+                        StatisticsServer(const StatisticsServer& other) = delete;
+
+    /**
+     * \brief           Deleted copy assignment operator.
+     * \param[in] other Other object.
+     * \return          Returns nothing because it's deleted.
+     */
+    StatisticsServer&   operator=(const StatisticsServer& other) = delete;
+
+    /**
+     * \brief          Start listening on localhost only, statistics is not shown to network.
+     * \param[in] port Port to listen.
+     * \return         True if server is started.
+     */
+    bool                listen(const int port);
+
+
+private slots:
+    /**
+     * \brief Process new connection of monitoring.
+     */
+    void slotNewConnection();
+
+    /**
+     * \brief            Answer request and close connection.
+     * \param[in] socket Socket which sent request.
+     */
+    void slotReadRequest(QTcpSocket* socket);
+
+
+private:
+    /**
+     * \brief Implementation of type-safe output printer.
+     */
+    printer::Printer&               _printer = printer::Printer::getInstance();
+
+    /**
+     * \brief Socket used to receive monitoring connections.
+     */
+    std::unique_ptr<QTcpServer>     _server;
+
+    /**
+     * \brief Function used to build report.
+     */
+    ReportBuilder                   _reportBuilder;
+};
+
+} // namespace vasily
+
+#endif // STATISTICS_SERVER_H
@@ -0,0 +1,174 @@
+#include <climits>
+#include <cmath>
+
+#include "WorkspaceValidator.h"
+
+
+namespace vasily
+{
+
+namespace
+{
+
+/**
+ * \brief Number of RobotData units in one mm or one degree.
+ */
+constexpr double kUnitsPerValue = 1000.0;
+
+/**
+ * \brief Value of PI used for conversion between degrees and radians.
+ */
+constexpr double kPi = 3.14159265358979323846;
+
+/**
+ * \brief D-H parameters of Fanuc M20ia in mm (world frame origin is on J2 axis height).
+ */
+constexpr double kShoulderOffset = 150.0;
+constexpr double kUpperArm       = 790.0;
+constexpr double kElbowOffset    = 250.0;
+constexpr double kForearm        = 835.0;
+constexpr double kFlange         = 100.0;
+
+} // anonymous namespace
+
+const WorkspaceValidator::Limits WorkspaceValidator::DEFAULT_LIMITS
+{
+    { INT_MIN, INT_MIN, INT_MIN, -180'000, -180'000, -180'000 },
+    { INT_MAX, INT_MAX, INT_MAX,  180'000,  180'000,  180'000 },
+    { -170'000, -100'000, -185'000, -200'000, -180'000, -450'000 },
+    {  170'000,  160'000,  273'000,  200'000,  180'000,  450'000 }
+};
+
+WorkspaceValidator::WorkspaceValidator(const Limits& limits) noexcept
+    : _limits(limits)
+{
+}
+
+const WorkspaceValidator::Limits& WorkspaceValidator::getLimits() const noexcept
+{
+    return _limits;
+}
+
+WorkspaceValidator::Verdicts WorkspaceValidator::validate(const std::vector<RobotData>& points,
+                                                          const CoordinateSystem coordinateSystem)
+    const
+{
+    Verdicts result(points.size(), Violation::NONE);
+
+    if (coordinateSystem == CoordinateSystem::JOINT)
+    {
+        checkRanges(points, 0, RobotData::NUMBER_OF_COORDINATES, _limits.minJoints,
+                    _limits.maxJoints, Violation::JOINT_LIMIT, result);
+        return result;
+    }
+
+    checkRanges(points, 0, 3, _limits.minCoordinates, _limits.maxCoordinates,
+                Violation::POSITION, result);
+    checkRanges(points, 3, RobotData::NUMBER_OF_COORDINATES, _limits.minCoordinates,
+                _limits.maxCoordinates, Violation::ORIENTATION, result);
+
+    // Jog frame is set on robot, so only world points can be solved here.
+    if (coordinateSystem != CoordinateSystem::WORLD)
+    {
+        return result;
+    }
+
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        std::array<int, 3> joints{};
+        if (!solveArm(points[i], joints))
+        {
+            result[i] |= Violation::UNREACHABLE;
+            continue;
+        }
+
+        for (std::size_t j = 0; j < joints.size(); ++j)
+        {
+            if (joints[j] < _limits.minJoints[j] || joints[j] > _limits.maxJoints[j])
+            {
+                result[i] |= Violation::JOINT_LIMIT;
+            }
+        }
+    }
+
+    return result;
+}
+
+std::vector<std::size_t> WorkspaceValidator::getRejected(const Verdicts& verdicts)
+{
+    std::vector<std::size_t> result;
+    for (std::size_t i = 0; i < verdicts.size(); ++i)
+    {
+        if (verdicts[i] != Violation::NONE)
+        {
+            result.push_back(i);
+        }
+    }
+    return result;
+}
+
+void WorkspaceValidator::checkRanges(
+    const std::vector<RobotData>& points, const std::size_t first, const std::size_t last,
+    const std::array<int, RobotData::NUMBER_OF_COORDINATES>& minimums,
+    const std::array<int, RobotData::NUMBER_OF_COORDINATES>& maximums, const Violation flag,
+    Verdicts& result)
+{
+    // Walk one coordinate through all points, so inner loop has no branches to mispredict.
+    for (std::size_t j = first; j < last; ++j)
+    {
+        const int minimum = minimums[j];
+        const int maximum = maximums[j];
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+            const int value = points[i].coordinates[j];
+            result[i] |= static_cast<std::uint8_t>(
+                (value < minimum || value > maximum) ? flag : Violation::NONE);
+        }
+    }
+}
+
+bool WorkspaceValidator::solveArm(const RobotData& point, std::array<int, 3>& joints)
+{
+    const double x = point.coordinates[0] / kUnitsPerValue;
+    const double y = point.coordinates[1] / kUnitsPerValue;
+    const double z = point.coordinates[2] / kUnitsPerValue;
+    const double w = point.coordinates[3] / kUnitsPerValue * kPi / 180.0;
+    const double p = point.coordinates[4] / kUnitsPerValue * kPi / 180.0;
+    const double r = point.coordinates[5] / kUnitsPerValue * kPi / 180.0;
+
+    // Wrist center lies on tool axis (third column of Rz(r) * Ry(p) * Rx(w)) behind flange.
+    const double wristX = x - kFlange * (std::cos(r) * std::sin(p) * std::cos(w)
+                                         + std::sin(r) * std::sin(w));
+    const double wristY = y - kFlange * (std::sin(r) * std::sin(p) * std::cos(w)
+                                         - std::cos(r) * std::sin(w));
+    const double wristZ = z - kFlange * std::cos(p) * std::cos(w);
+
+    // Planar two-link task in vertical plane of J1, forearm is replaced by straight link.
+    const double reach = std::hypot(wristX, wristY) - kShoulderOffset;
+    const double forearm = std::hypot(kElbowOffset, kForearm);
+    const double forearmAngle = std::atan2(kForearm, kElbowOffset);
+    const double cosElbow = (reach * reach + wristZ * wristZ - kUpperArm * kUpperArm
+                             - forearm * forearm) / (2.0 * kUpperArm * forearm);
+    if (cosElbow < -1.0 || cosElbow > 1.0)
+    {
+        return false;
+    }
+
+    // Elbow-up configuration, the same one robot uses for default point.
+    const double elbow = -std::acos(cosElbow);
+    const double upperArmAngle = std::atan2(wristZ, reach)
+                               - std::atan2(forearm * std::sin(elbow),
+                                            kUpperArm + forearm * std::cos(elbow));
+
+    // Fanuc counts J2 from vertical and J3 from horizontal (J2/J3 interaction).
+    const double j1 = std::atan2(wristY, wristX);
+    const double j2 = kPi / 2.0 - upperArmAngle;
+    const double j3 = upperArmAngle + elbow + forearmAngle - kPi / 2.0;
+
+    joints[0] = static_cast<int>(std::lround(j1 * 180.0 / kPi * kUnitsPerValue));
+    joints[1] = static_cast<int>(std::lround(j2 * 180.0 / kPi * kUnitsPerValue));
+    joints[2] = static_cast<int>(std::lround(j3 * 180.0 / kPi * kUnitsPerValue));
+    return true;
+}
+
+} // namespace vasily
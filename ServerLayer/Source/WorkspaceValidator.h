@@ -0,0 +1,137 @@
+#ifndef WORKSPACE_VALIDATOR_H
+#define WORKSPACE_VALIDATOR_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Utilities.h"
+
+
+namespace vasily
+{
+
+/**
+ * \brief   Class used to check whole program of points against robot workspace before it is
+ *          queued, so program is accepted or rejected in one step.
+ * \details All values are in units of RobotData: thousandths of mm for positions and thousandths
+ *          of degree for angles. Reachability and joint limits are calculated by closed-form
+ *          inverse kinematics of wrist center for Fanuc M20ia (the same D-H parameters as
+ *          FanucModel uses).
+ */
+class WorkspaceValidator
+{
+public:
+    /**
+     * \brief Array of reasons why point can be rejected (combined in verdict of point).
+     */
+    enum Violation : std::uint8_t
+    {
+        NONE        = 0,
+        POSITION    = 1 << 0,
+        ORIENTATION = 1 << 1,
+        UNREACHABLE = 1 << 2,
+        JOINT_LIMIT = 1 << 3
+    };
+
+    /**
+     * \brief Structure which keeps limits of robot workspace.
+     */
+    struct Limits
+    {
+        /**
+         * \brief Minimal values of x, y, z, w, p, r.
+         */
+        std::array<int, RobotData::NUMBER_OF_COORDINATES> minCoordinates;
+
+        /**
+         * \brief Maximal values of x, y, z, w, p, r.
+         */
+        std::array<int, RobotData::NUMBER_OF_COORDINATES> maxCoordinates;
+
+        /**
+         * \brief Minimal angles of joints J1-J6.
+         */
+        std::array<int, RobotData::NUMBER_OF_COORDINATES> minJoints;
+
+        /**
+         * \brief Maximal angles of joints J1-J6.
+         */
+        std::array<int, RobotData::NUMBER_OF_COORDINATES> maxJoints;
+    };
+
+    /**
+     * \brief Verdicts of points in order of checking, NONE means point is correct.
+     */
+    using Verdicts = std::vector<std::uint8_t>;
+
+    /**
+     * \brief Default limits: orientation is not limited, joints have Fanuc M20ia ranges.
+     */
+    static const Limits DEFAULT_LIMITS;
+
+
+    /**
+     * \brief            Constructor which sets limits.
+     * \param[in] limits Limits of robot workspace.
+     */
+    explicit        WorkspaceValidator(const Limits& limits = DEFAULT_LIMITS) noexcept;
+
+    /**
+     * \brief  Get limits of robot workspace.
+     * \return Current limits.
+     */
+    const Limits&   getLimits() const noexcept;
+
+    /**
+     * \brief                      Check all points of program.
+     * \param[in] points           Points to check.
+     * \param[in] coordinateSystem Coordinate system which points are given in.
+     * \return                     Verdict for every point.
+     */
+    Verdicts        validate(const std::vector<RobotData>& points,
+                             const CoordinateSystem coordinateSystem) const;
+
+    /**
+     * \brief              Get indices of rejected points.
+     * \param[in] verdicts Result of validation.
+     * \return             Indices of points which verdict is not NONE (empty if all correct).
+     */
+    static std::vector<std::size_t> getRejected(const Verdicts& verdicts);
+
+
+private:
+    /**
+     * \brief Limits of robot workspace.
+     */
+    Limits _limits;
+
+
+    /**
+     * \brief              Check that every coordinate of every point lies in its range.
+     * \param[in] points   Points to check.
+     * \param[in] first    Index of the first coordinate to check.
+     * \param[in] last     Index after the last coordinate to check.
+     * \param[in] minimums Minimal values of coordinates.
+     * \param[in] maximums Maximal values of coordinates.
+     * \param[in] flag     Violation to set if value is out of range.
+     * \param[out] result  Verdicts to update.
+     */
+    static void checkRanges(const std::vector<RobotData>& points, const std::size_t first,
+                            const std::size_t last,
+                            const std::array<int, RobotData::NUMBER_OF_COORDINATES>& minimums,
+                            const std::array<int, RobotData::NUMBER_OF_COORDINATES>& maximums,
+                            const Violation flag, Verdicts& result);
+
+    /**
+     * \brief             Calculate J1-J3 of robot for cartesian point.
+     * \param[in] point   Point in world frame.
+     * \param[out] joints Calculated angles in units of RobotData.
+     * \return            False if wrist center is out of arm reach.
+     */
+    static bool solveArm(const RobotData& point, std::array<int, 3>& joints);
+};
+
+} // namespace vasily
+
+#endif // WORKSPACE_VALIDATOR_H
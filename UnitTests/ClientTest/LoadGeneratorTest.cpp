@@ -0,0 +1,109 @@
+#include <cstdlib>
+#include <iterator>
+#include <string>
+
+#include "LoadGenerator.h"
+
+#include "LoadGeneratorTest.h"
+
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace clientTests
+{
+
+void LoadGeneratorTest::zigzagPattern()
+{
+    vasily::LoadProfile profile;
+    profile.amplitude = 300;
+    const vasily::RobotData center;
+    vasily::PointGenerator generator(profile, center);
+
+    // Same sequence as former "test1" routine, but repeated after amplitude.
+    const int expected[] = { -100, 100, -200, 200, -300, 300, -100, 100 };
+    for (std::size_t i = 0; i < std::size(expected); ++i)
+    {
+        const vasily::RobotData point = generator.next();
+        const std::wstring message = L"In " + std::to_wstring(i) + L" point!";
+        Assert::AreEqual(center.coordinates[1] + expected[i], point.coordinates[1],
+                         message.c_str());
+        Assert::AreEqual(center.coordinates[0], point.coordinates[0], message.c_str());
+    }
+}
+
+void LoadGeneratorTest::sweepPattern()
+{
+    vasily::LoadProfile profile;
+    profile.pattern = vasily::LoadProfile::Pattern::SWEEP;
+    profile.axes.reset();
+    profile.axes.set(3);
+    profile.axes.set(5);
+    profile.amplitude = 200;
+    const vasily::RobotData center;
+    vasily::PointGenerator generator(profile, center);
+
+    const int expected[] = { 100, 200, 100, 0, -100, -200, -100, 0, 100 };
+    for (std::size_t i = 0; i < std::size(expected); ++i)
+    {
+        const vasily::RobotData point = generator.next();
+        const std::wstring message = L"In " + std::to_wstring(i) + L" point!";
+        Assert::AreEqual(center.coordinates[3] + expected[i], point.coordinates[3],
+                         message.c_str());
+        Assert::AreEqual(center.coordinates[5] + expected[i], point.coordinates[5],
+                         message.c_str());
+        Assert::AreEqual(center.coordinates[1], point.coordinates[1], message.c_str());
+    }
+}
+
+void LoadGeneratorTest::randomWalkPattern()
+{
+    vasily::LoadProfile profile;
+    profile.pattern = vasily::LoadProfile::Pattern::RANDOM_WALK;
+    profile.amplitude = 250;
+    profile.seed = 42;
+    const vasily::RobotData center;
+    vasily::PointGenerator first(profile, center);
+    vasily::PointGenerator second(profile, center);
+
+    int previous = center.coordinates[1];
+    for (int i = 0; i < 1'000; ++i)
+    {
+        const vasily::RobotData point = first.next();
+        Assert::AreEqual(point.coordinates[1], second.next().coordinates[1],
+                         L"Same seed gives different points");
+        Assert::IsTrue(std::abs(point.coordinates[1] - center.coordinates[1]) <= 250,
+                       L"Walk left amplitude");
+        Assert::IsTrue(std::abs(point.coordinates[1] - previous) <= 100, L"Step is too long");
+        previous = point.coordinates[1];
+    }
+}
+
+void LoadGeneratorTest::optionsParsing()
+{
+    const auto profile = vasily::parseLoadProfile({ "--pattern", "sweep", "--axes", "wr",
+                                                    "--rate", "50.5", "--window", "0",
+                                                    "--count", "0", "--duration", "1500" });
+    Assert::IsTrue(profile.has_value(), L"Correct options are rejected");
+    Assert::IsTrue(profile->pattern == vasily::LoadProfile::Pattern::SWEEP, L"Wrong pattern");
+    Assert::IsTrue(profile->axes.test(3) && profile->axes.test(5) && profile->axes.count() == 2,
+                   L"Wrong axes");
+    Assert::AreEqual(50.5, profile->rate, 1e-9, L"Wrong rate");
+    Assert::AreEqual(std::size_t{ 0 }, profile->window, L"Wrong window");
+    Assert::AreEqual(1500LL, static_cast<long long>(profile->duration.count()),
+                     L"Wrong duration");
+
+    Assert::IsFalse(vasily::parseLoadProfile({ "--axes", "Q" }).has_value(),
+                    L"Unknown axis is accepted");
+    Assert::IsFalse(vasily::parseLoadProfile({ "--step", "10x" }).has_value(),
+                    L"Incorrect number is accepted");
+    Assert::IsFalse(vasily::parseLoadProfile({ "--count" }).has_value(),
+                    L"Option without value is accepted");
+    Assert::IsFalse(vasily::parseLoadProfile({ "--count", "0" }).has_value(),
+                    L"Endless load is accepted");
+    Assert::IsFalse(vasily::parseLoadProfile({ "--pattern", "replay", "--file", "absent.txt" })
+                        .has_value(),
+                    L"Replay without points is accepted");
+}
+
+} // namespace clientTests
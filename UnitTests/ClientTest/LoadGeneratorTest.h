@@ -0,0 +1,40 @@
+#ifndef LOAD_GENERATOR_TEST_H
+#define LOAD_GENERATOR_TEST_H
+
+#include <CppUnitTest.h>
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace clientTests
+{
+
+TEST_CLASS(LoadGeneratorTest)
+{
+public:
+
+    /**
+     * \brief Test of zigzag which grows up to amplitude and starts again.
+     */
+    TEST_METHOD(zigzagPattern);
+
+    /**
+     * \brief Test of sweep between amplitudes on several axes.
+     */
+    TEST_METHOD(sweepPattern);
+
+    /**
+     * \brief Test of random walk repeatability and its bounds.
+     */
+    TEST_METHOD(randomWalkPattern);
+
+    /**
+     * \brief Test of parsing load options.
+     */
+    TEST_METHOD(optionsParsing);
+};
+
+} // namespace clientTests
+
+#endif // LOAD_GENERATOR_TEST_H
@@ -0,0 +1,179 @@
+#include "AnswerWindowTest.h"
+
+#include <vector>
+
+#include <Parsing/Parsing.h>
+#include <Protocol/AnswerWindow.h>
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+namespace
+{
+
+/**
+ * \brief        Make point which differs from others by x coordinate.
+ * \param[in] id Number of point.
+ * \return       Point.
+ */
+vasily::RobotData makePoint(const int id)
+{
+    return { { id * 1000, 0, 0, 0, 0, 0 }, { 10, 2, 0 } };
+}
+
+/**
+ * \brief        Make text answer which robot sends when it reaches point.
+ * \param[in] id Number of point.
+ * \return       Line of answer.
+ */
+std::string makeAnswer(const int id)
+{
+    return utils::parseFullData(makePoint(id).toString());
+}
+
+/**
+ * \brief             Send points with numbers from 0 to count - 1.
+ * \param[out] window Window to fill.
+ * \param[in] count   Number of points.
+ */
+void sendPoints(protocol::AnswerWindow<int>& window, const int count)
+{
+    for (int id = 0; id < count; ++id)
+    {
+        window.push(id, static_cast<std::uint32_t>(id), makePoint(id));
+    }
+}
+
+} // anonymous namespace
+
+void AnswerWindowTest::binaryAnswers()
+{
+    protocol::AnswerWindow<int> window(3, 3);
+    sendPoints(window, 3);
+    Assert::IsFalse(window.hasPlace(), L"Full window has place");
+
+    Assert::IsFalse(window.completeBinary(7).has_value(), L"Unknown number matched");
+
+    const auto completion = window.completeBinary(1);
+    Assert::IsTrue(completion.has_value() && completion->value == 1, L"Incorrect point matched");
+    Assert::AreEqual(std::size_t{ 1 }, window.size(), L"Skipped point is kept");
+    Assert::AreEqual(2, window.front(), L"Incorrect point is left");
+
+    // Late binary answer can't be confused with another point, so point is just released.
+    window.timeOut(false, protocol::AnswerWindow<int>::Clock::now());
+    Assert::IsTrue(window.empty(), L"Timed out point is kept");
+    Assert::AreEqual(std::size_t{ 0 }, window.getOverdueCount(), L"Binary point became overdue");
+}
+
+void AnswerWindowTest::lateTextAnswer()
+{
+    protocol::AnswerWindow<int> window(4, 4);
+    sendPoints(window, 3);
+
+    window.timeOut(true, protocol::AnswerWindow<int>::Clock::now() + std::chrono::seconds(1));
+    Assert::AreEqual(std::size_t{ 1 }, window.getOverdueCount(), L"Point didn't become overdue");
+    Assert::AreEqual(1, window.front(), L"Timed out point is still in window");
+
+    const auto late = window.completeText(makeAnswer(0));
+    Assert::IsTrue(late.has_value() && late->value == 0 && late->isOverdue,
+                   L"Late answer isn't matched to timed out point");
+
+    const auto next = window.completeText(makeAnswer(1));
+    Assert::IsTrue(next.has_value() && next->value == 1 && !next->isOverdue,
+                   L"Next answer isn't matched to next point");
+    Assert::IsTrue(window.takeLost().empty(), L"Answered point is lost");
+}
+
+void AnswerWindowTest::lostTextAnswer()
+{
+    protocol::AnswerWindow<int> window(4, 4);
+    sendPoints(window, 4);
+
+    const auto deadline = protocol::AnswerWindow<int>::Clock::now() + std::chrono::seconds(1);
+    window.timeOut(true, deadline);
+    window.timeOut(true, deadline);
+
+    // Answer of point 0 never comes, answer of point 1 has to skip it.
+    const auto second = window.completeText(makeAnswer(1));
+    Assert::IsTrue(second.has_value() && second->value == 1 && second->isOverdue,
+                   L"Answer is matched to point which answer was lost");
+
+    // Answer of point in window means that no overdue answer will come.
+    window.timeOut(true, deadline);
+    const auto fourth = window.completeText(makeAnswer(3));
+    Assert::IsTrue(fourth.has_value() && fourth->value == 3 && !fourth->isOverdue,
+                   L"Answer is matched to overdue point");
+
+    const std::vector<int> lost = window.takeLost();
+    Assert::IsTrue(lost == std::vector<int>{ 0, 2 }, L"Incorrect lost points");
+    Assert::AreEqual(std::size_t{ 0 }, window.getOverdueCount(), L"Overdue points are left");
+    Assert::IsTrue(window.empty(), L"Answered points are left");
+}
+
+void AnswerWindowTest::overdueLimits()
+{
+    using Clock = protocol::AnswerWindow<int>::Clock;
+
+    protocol::AnswerWindow<int> window(4, 2);
+    sendPoints(window, 4);
+
+    const auto start = Clock::now();
+    window.timeOut(true, start + std::chrono::milliseconds(10));
+    window.timeOut(true, start + std::chrono::milliseconds(20));
+    window.timeOut(true, start + std::chrono::milliseconds(30));
+    Assert::AreEqual(std::size_t{ 2 }, window.getOverdueCount(), L"Overdue points aren't limited");
+    Assert::IsTrue(window.takeLost() == std::vector<int>{ 0 }, L"The oldest point isn't lost");
+
+    Assert::IsTrue(window.getOverdueDeadline() == start + std::chrono::milliseconds(20),
+                   L"Incorrect nearest deadline");
+    window.expireOverdue(start + std::chrono::milliseconds(25));
+    Assert::IsTrue(window.takeLost() == std::vector<int>{ 1 }, L"Expired point isn't lost");
+    Assert::AreEqual(std::size_t{ 1 }, window.getOverdueCount(), L"Point expired too early");
+
+    // New link never brings answers of old one.
+    const auto points = window.takeAll();
+    Assert::IsTrue(points.size() == 1 && points.front() == 3, L"Points in window aren't taken");
+    Assert::AreEqual(std::size_t{ 0 }, window.getOverdueCount(), L"Overdue points are kept");
+}
+
+void AnswerWindowTest::unterminatedLink()
+{
+    using Clock = protocol::AnswerWindow<int>::Clock;
+
+    protocol::AnswerWindow<int> window(4, 4);
+    window.setUnterminated(true);
+
+    // Dispatch as connection does: fill window while it has place.
+    auto dispatch = [&window](int& next)
+    {
+        std::size_t sent = 0;
+        while (window.hasPlace())
+        {
+            window.push(next, static_cast<std::uint32_t>(next), makePoint(next));
+            ++next;
+            ++sent;
+        }
+        return sent;
+    };
+
+    int next = 0;
+    Assert::AreEqual(std::size_t{ 1 }, dispatch(next), L"Several points sent at once");
+    Assert::AreEqual(std::size_t{ 0 }, dispatch(next), L"Point sent before answer");
+
+    const auto first = window.completeText(makeAnswer(0));
+    Assert::IsTrue(first.has_value() && first->value == 0, L"Answer isn't matched");
+    Assert::AreEqual(std::size_t{ 1 }, dispatch(next), L"Point isn't sent after answer");
+
+    // Late answer may still come, so timed out point keeps link busy until it is given up.
+    const auto start = Clock::now();
+    window.timeOut(true, start + std::chrono::milliseconds(10));
+    Assert::AreEqual(std::size_t{ 0 }, dispatch(next), L"Point sent while answer may come");
+    window.expireOverdue(start + std::chrono::milliseconds(10));
+    Assert::AreEqual(std::size_t{ 1 }, dispatch(next), L"Point isn't sent after giving up");
+    Assert::IsTrue(window.takeLost() == std::vector<int>{ 1 }, L"Given up point isn't lost");
+}
+
+} // namespace utilitiesTests
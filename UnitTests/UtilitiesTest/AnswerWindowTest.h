@@ -0,0 +1,51 @@
+#ifndef ANSWER_WINDOW_TEST_H
+#define ANSWER_WINDOW_TEST_H
+
+#include <CppUnitTest.h>
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+/**
+ * \brief Set of tests for matching robot answers to sent points.
+ */
+TEST_CLASS(AnswerWindowTest)
+{
+public:
+    /**
+     * \brief Test for checking that binary answer releases its point and points sent before it.
+     */
+    TEST_METHOD(binaryAnswers);
+
+    /**
+     * \brief Test for checking that late text answer goes to its timed out point.
+     */
+    TEST_METHOD(lateTextAnswer);
+
+    /**
+     * \brief Test for checking that lost text answer doesn't shift answers of next points.
+     */
+    TEST_METHOD(lostTextAnswer);
+
+    /**
+     * \brief Test for checking that overdue points are limited and expire.
+     */
+    TEST_METHOD(overdueLimits);
+
+    /**
+     * \brief Test for checking that link without delimiters gets the next point only after
+     *        answer of previous one.
+     */
+    TEST_METHOD(unterminatedLink);
+};
+
+} // namespace utilitiesTests
+
+#endif // ANSWER_WINDOW_TEST_H
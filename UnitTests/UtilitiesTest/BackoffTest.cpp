@@ -0,0 +1,39 @@
+#include "BackoffTest.h"
+
+#include <Backoff/Backoff.h>
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+void BackoffTest::delayGrowth()
+{
+    using namespace std::chrono_literals;
+    utils::Backoff backoff(100ms, 1000ms, 0.5);
+
+    const long long expected[] = { 100, 200, 400, 800, 1000, 1000 };
+    for (const long long delay : expected)
+    {
+        const long long actual = backoff.nextDelay().count();
+        Assert::IsTrue(actual <= delay, L"Delay is bigger than expected");
+        Assert::IsTrue(actual >= delay / 2, L"Jitter is bigger than expected");
+    }
+    Assert::AreEqual(std::size_t{ 6 }, backoff.getAttempts(), L"Incorrect number of attempts");
+}
+
+void BackoffTest::resetDelay()
+{
+    using namespace std::chrono_literals;
+    utils::Backoff backoff(100ms, 1000ms, 0.0);
+
+    backoff.nextDelay();
+    backoff.nextDelay();
+    backoff.reset();
+
+    Assert::AreEqual(100LL, static_cast<long long>(backoff.nextDelay().count()),
+                     L"Delay not reset");
+}
+
+} // namespace utilitiesTests
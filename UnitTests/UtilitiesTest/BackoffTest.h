@@ -0,0 +1,35 @@
+#ifndef BACKOFF_TEST_H
+#define BACKOFF_TEST_H
+
+#include <CppUnitTest.h>
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+/**
+ * \brief Set of tests for reconnection delays.
+ */
+TEST_CLASS(BackoffTest)
+{
+public:
+    /**
+     * \brief Test for checking that delay grows up to limit and stays in jitter range.
+     */
+    TEST_METHOD(delayGrowth);
+
+    /**
+     * \brief Test for checking that reset returns to initial delay.
+     */
+    TEST_METHOD(resetDelay);
+};
+
+} // namespace utilitiesTests
+
+#endif // BACKOFF_TEST_H
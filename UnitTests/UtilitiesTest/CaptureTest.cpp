@@ -0,0 +1,96 @@
+#include "CaptureTest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include <Capture/Capture.h>
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+void CaptureTest::writeAndRead()
+{
+    const std::string fileName = "capture_test.bin";
+    std::remove(fileName.c_str());
+
+    const std::string binary("\x46\x56\x01\x00\x00", 5);
+    {
+        capture::CaptureWriter writer(fileName);
+        Assert::IsTrue(writer.isOpen(), L"Capture file not opened");
+        writer.write(capture::Event::CLIENT_CONNECTED, 1, 7, "8888");
+        writer.write(capture::Event::FROM_CLIENT, 1, 7, binary);
+    }
+    {
+        // The second run continues the same file.
+        capture::CaptureWriter writer(fileName);
+        writer.write(capture::Event::TO_ROBOT, 1, 0, {});
+    }
+
+    capture::CaptureReader reader(fileName);
+    Assert::IsTrue(reader.isValid(), L"Capture header not recognized");
+
+    const auto started = reader.next();
+    Assert::IsTrue(started.has_value(), L"Start of run not read");
+    Assert::IsTrue(started->event == capture::Event::RUN_STARTED, L"Run is not marked");
+
+    const auto connected = reader.next();
+    Assert::IsTrue(connected.has_value(), L"The first record not read");
+    Assert::IsTrue(connected->event == capture::Event::CLIENT_CONNECTED, L"Incorrect event");
+    Assert::AreEqual(std::uint16_t{ 1 }, connected->robotId, L"Incorrect robot");
+    Assert::AreEqual(std::uint32_t{ 7 }, connected->sessionId, L"Incorrect session");
+    Assert::AreEqual(std::string("8888"), connected->data, L"Incorrect data");
+
+    const auto received = reader.next();
+    Assert::IsTrue(received.has_value(), L"The second record not read");
+    Assert::AreEqual(binary, received->data, L"Binary data changed");
+    Assert::IsTrue(received->time >= connected->time, L"Time goes back");
+
+    const auto restarted = reader.next();
+    Assert::IsTrue(restarted.has_value(), L"Start of appended run not read");
+    Assert::IsTrue(restarted->event == capture::Event::RUN_STARTED, L"Appended run is not marked");
+
+    const auto sent = reader.next();
+    Assert::IsTrue(sent.has_value(), L"Appended record not read");
+    Assert::IsTrue(sent->event == capture::Event::TO_ROBOT, L"Incorrect appended event");
+    Assert::IsTrue(sent->data.empty(), L"Empty data not kept");
+    Assert::IsTrue(sent->time >= received->time, L"Time of appended run goes back");
+
+    Assert::IsFalse(reader.next().has_value(), L"Record read after the end of file");
+    std::remove(fileName.c_str());
+}
+
+void CaptureTest::collapseRuns()
+{
+    using namespace std::chrono_literals;
+
+    const auto makeRecord = [](const capture::Event event, const std::chrono::nanoseconds time)
+    {
+        capture::Record record;
+        record.event = event;
+        record.time  = time;
+        return record;
+    };
+
+    // The second run starts two hours after the first one.
+    std::vector<capture::Record> records{
+        makeRecord(capture::Event::RUN_STARTED, 10s),
+        makeRecord(capture::Event::CLIENT_CONNECTED, 11s),
+        makeRecord(capture::Event::FROM_CLIENT, 13s),
+        makeRecord(capture::Event::RUN_STARTED, 2h),
+        makeRecord(capture::Event::CLIENT_CONNECTED, 2h + 1s),
+        makeRecord(capture::Event::FROM_CLIENT, 2h + 4s)
+    };
+    capture::collapseRuns(records);
+
+    const std::vector<std::chrono::nanoseconds> expected{ 10s, 11s, 13s, 13s, 14s, 17s };
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        Assert::IsTrue(records[i].time == expected[i], L"Incorrect time after collapsing runs");
+    }
+}
+
+} // namespace utilitiesTests
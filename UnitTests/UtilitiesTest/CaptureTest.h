@@ -0,0 +1,37 @@
+#ifndef CAPTURE_TEST_H
+#define CAPTURE_TEST_H
+
+#include <CppUnitTest.h>
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+/**
+ * \brief Set of tests for traffic capture file.
+ */
+TEST_CLASS(CaptureTest)
+{
+public:
+    /**
+     * \brief Test for checking that records are read back in order of writing, also after
+     *        appending to existing file.
+     */
+    TEST_METHOD(writeAndRead);
+
+    /**
+     * \brief Test for checking that pause between runs in one file is removed and intervals
+     *        inside runs are kept.
+     */
+    TEST_METHOD(collapseRuns);
+};
+
+} // namespace utilitiesTests
+
+#endif // CAPTURE_TEST_H
@@ -0,0 +1,56 @@
+#include "FramerTest.h"
+
+#include <Protocol/Framer.h>
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+void FramerTest::fragmentedMessage()
+{
+    protocol::Framer framer;
+
+    framer.append("985000 0 940");
+    Assert::IsFalse(framer.nextMessage().has_value(), L"Incomplete message extracted");
+
+    framer.append("000 -180000 0 0 10 2 0\n");
+    const auto message = framer.nextMessage();
+
+    Assert::IsTrue(message.has_value(), L"Complete message not extracted");
+    Assert::AreEqual(std::string("985000 0 940000 -180000 0 0 10 2 0"), *message,
+                     L"Message assembled incorrectly");
+    Assert::AreEqual(std::size_t{ 0 }, framer.getBufferedSize(), L"Buffer not consumed");
+}
+
+void FramerTest::coalescedMessages()
+{
+    protocol::Framer framer;
+
+    framer.append(protocol::Framer::frame("2") + protocol::Framer::frame("1 2 3 4 5 6 10 2 0")
+                  + "1 2");
+    const auto messages = framer.extractMessages();
+
+    Assert::AreEqual(std::size_t{ 2 }, messages.size(), L"Incorrect number of messages");
+    Assert::AreEqual(std::string("2"), messages.at(0), L"Coordinate system merged with point");
+    Assert::AreEqual(std::string("1 2 3 4 5 6 10 2 0"), messages.at(1), L"Point parsed incorrectly");
+    Assert::AreEqual(std::size_t{ 3 }, framer.getBufferedSize(), L"Incomplete tail lost");
+}
+
+void FramerTest::oversizedMessage()
+{
+    protocol::Framer framer(4);
+
+    framer.append("0123456");
+    Assert::IsFalse(framer.nextMessage().has_value(), L"Oversized message extracted");
+
+    framer.append("789\nok\n");
+    const auto messages = framer.extractMessages();
+
+    Assert::AreEqual(std::size_t{ 1 }, messages.size(), L"Incorrect number of messages");
+    Assert::AreEqual(std::string("ok"), messages.at(0), L"Next message parsed incorrectly");
+    Assert::AreEqual(std::size_t{ 1 }, framer.getDroppedMessages(), L"Dropped message not counted");
+}
+
+} // namespace utilitiesTests
@@ -0,0 +1,40 @@
+#ifndef FRAMER_TEST_H
+#define FRAMER_TEST_H
+
+#include <CppUnitTest.h>
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+/**
+ * \brief Set of tests for message framer.
+ */
+TEST_CLASS(FramerTest)
+{
+public:
+    /**
+     * \brief Test for checking that message split into several pieces is assembled.
+     */
+    TEST_METHOD(fragmentedMessage);
+
+    /**
+     * \brief Test for checking that several messages received in one piece are separated.
+     */
+    TEST_METHOD(coalescedMessages);
+
+    /**
+     * \brief Test for checking that oversized message is dropped and next one is parsed.
+     */
+    TEST_METHOD(oversizedMessage);
+};
+
+} // namespace utilitiesTests
+
+#endif // FRAMER_TEST_H
@@ -0,0 +1,50 @@
+#include "HeartbeatTest.h"
+
+#include <Protocol/Heartbeat.h>
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+void HeartbeatTest::roundTripTime()
+{
+    using namespace std::chrono_literals;
+    protocol::Heartbeat heartbeat(3);
+
+    const auto sent = protocol::Heartbeat::Clock::now();
+    const protocol::Message ping = heartbeat.makeNextPing(sent);
+    Assert::IsTrue(ping.type == protocol::MessageType::PING, L"Incorrect type of ping");
+
+    const auto roundTrip = heartbeat.receivePong(protocol::makePong(ping.sequence), sent + 250us);
+    Assert::IsTrue(roundTrip.has_value(), L"Pong not matched");
+    Assert::AreEqual(250LL, static_cast<long long>(roundTrip->count()),
+                     L"Incorrect round-trip time");
+    Assert::AreEqual(std::uint64_t{ 1 }, heartbeat.getLatencies().getCount(),
+                     L"Round-trip time not recorded");
+
+    Assert::IsFalse(heartbeat.receivePong(protocol::makePong(ping.sequence), sent + 1ms)
+                        .has_value(), L"Duplicate pong matched");
+}
+
+void HeartbeatTest::missedPongs()
+{
+    protocol::Heartbeat heartbeat(2);
+
+    const protocol::Message first = heartbeat.makeNextPing();
+    Assert::IsTrue(heartbeat.isAlive(), L"Connection dead after the first ping");
+    (void) heartbeat.makeNextPing();
+    Assert::IsTrue(heartbeat.isAlive(), L"Connection dead after one missed pong");
+
+    // Late pong of previous ping doesn't prove that the last one will be answered.
+    Assert::IsFalse(heartbeat.receivePong(protocol::makePong(first.sequence)).has_value(),
+                    L"Late pong matched");
+    (void) heartbeat.makeNextPing();
+    Assert::IsFalse(heartbeat.isAlive(), L"Connection alive after two missed pongs");
+
+    heartbeat.reset();
+    Assert::IsTrue(heartbeat.isAlive(), L"Connection dead after reset");
+}
+
+} // namespace utilitiesTests
@@ -0,0 +1,35 @@
+#ifndef HEARTBEAT_TEST_H
+#define HEARTBEAT_TEST_H
+
+#include <CppUnitTest.h>
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+/**
+ * \brief Set of tests for heartbeat tracking.
+ */
+TEST_CLASS(HeartbeatTest)
+{
+public:
+    /**
+     * \brief Test for checking that round-trip time of answered ping is recorded.
+     */
+    TEST_METHOD(roundTripTime);
+
+    /**
+     * \brief Test for checking that connection is dead after several missed pongs in a row.
+     */
+    TEST_METHOD(missedPongs);
+};
+
+} // namespace utilitiesTests
+
+#endif // HEARTBEAT_TEST_H
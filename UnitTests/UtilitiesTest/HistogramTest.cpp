@@ -0,0 +1,77 @@
+#include "HistogramTest.h"
+
+#include <Histogram/Histogram.h>
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+void HistogramTest::percentiles()
+{
+    stats::Histogram histogram;
+    Assert::AreEqual(0LL, static_cast<long long>(histogram.getPercentile(0.5).count()),
+                     L"Percentile of empty histogram is not zero");
+
+    for (long long i = 1; i <= 1000; ++i)
+    {
+        histogram.record(std::chrono::microseconds(i));
+    }
+
+    Assert::AreEqual(std::uint64_t{ 1000 }, histogram.getCount(), L"Incorrect number of samples");
+    Assert::AreEqual(1LL, static_cast<long long>(histogram.getMin().count()), L"Incorrect min");
+    Assert::AreEqual(1000LL, static_cast<long long>(histogram.getMax().count()),
+                     L"Incorrect max");
+    Assert::AreEqual(500LL, static_cast<long long>(histogram.getMean().count()),
+                     L"Incorrect mean");
+
+    // Bucket gives value which is not less than real one and less than 12.5% bigger.
+    const long long median = histogram.getPercentile(0.5).count();
+    Assert::IsTrue(median >= 500 && median < 563, L"Median is out of bucket precision");
+    const long long tail = histogram.getPercentile(0.99).count();
+    Assert::IsTrue(tail >= 990 && tail <= 1000, L"99th percentile is out of bucket precision");
+    Assert::AreEqual(1000LL, static_cast<long long>(histogram.getPercentile(1.0).count()),
+                     L"100th percentile is not max");
+}
+
+void HistogramTest::mergeHistograms()
+{
+    stats::Histogram fast;
+    stats::Histogram slow;
+    for (int i = 0; i < 90; ++i)
+    {
+        fast.record(std::chrono::microseconds(100));
+    }
+    for (int i = 0; i < 10; ++i)
+    {
+        slow.record(std::chrono::microseconds(10'000));
+    }
+
+    fast.merge(slow);
+    Assert::AreEqual(std::uint64_t{ 100 }, fast.getCount(), L"Samples lost after merge");
+    const long long fastTail = fast.getPercentile(0.9).count();
+    Assert::IsTrue(fastTail >= 100 && fastTail < 113, L"Incorrect 90th percentile after merge");
+    Assert::AreEqual(10'000LL, static_cast<long long>(fast.getPercentile(0.95).count()),
+                     L"Incorrect 95th percentile after merge");
+
+    fast.reset();
+    Assert::AreEqual(std::uint64_t{ 0 }, fast.getCount(), L"Samples left after reset");
+}
+
+void HistogramTest::plainValues()
+{
+    stats::Histogram histogram;
+    for (std::uint64_t i = 1; i <= 1000; ++i)
+    {
+        histogram.record(i * 1000);
+    }
+
+    const std::uint64_t median = histogram.getPercentileValue(0.5);
+    Assert::IsTrue(median >= 500'000 && median < 562'500, L"Median is out of bucket precision");
+    Assert::AreEqual(static_cast<long long>(median),
+                     static_cast<long long>(histogram.getPercentile(0.5).count()),
+                     L"Percentile differs from the same of latency");
+}
+
+} // namespace utilitiesTests
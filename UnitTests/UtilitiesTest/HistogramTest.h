@@ -0,0 +1,40 @@
+#ifndef HISTOGRAM_TEST_H
+#define HISTOGRAM_TEST_H
+
+#include <CppUnitTest.h>
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+/**
+ * \brief Set of tests for latency histogram.
+ */
+TEST_CLASS(HistogramTest)
+{
+public:
+    /**
+     * \brief Test for checking that percentiles stay in bucket precision.
+     */
+    TEST_METHOD(percentiles);
+
+    /**
+     * \brief Test for checking that merged histogram keeps samples of both.
+     */
+    TEST_METHOD(mergeHistograms);
+
+    /**
+     * \brief Test for checking that values which are not latencies use the same buckets.
+     */
+    TEST_METHOD(plainValues);
+};
+
+} // namespace utilitiesTests
+
+#endif // HISTOGRAM_TEST_H
@@ -0,0 +1,68 @@
+#include "InterpolationGridTest.h"
+
+#include <Interpolation/InterpolationGrid.h>
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+void InterpolationGridTest::bilinearInterpolation()
+{
+    const utils::InterpolationGrid empty;
+    Assert::AreEqual(0.0, empty.evaluate(1.0, 1.0), L"Value of empty grid is not zero");
+
+    // Value is 10 * row + column, bilinear interpolation restores it exactly.
+    const utils::InterpolationGrid grid({ 0.0, 1.0, 3.0 }, { 0.0, 10.0 },
+                                        { 0.0, 10.0, 10.0, 20.0, 30.0, 40.0 });
+    Assert::AreEqual(20.0, grid.evaluate(1.0, 10.0), 1e-9, L"Incorrect value in grid point");
+    Assert::AreEqual(15.0, grid.evaluate(0.5, 12.5), 1e-9, L"Column is not clamped");
+    Assert::AreEqual(25.0, grid.evaluate(2.0, 5.0), 1e-9, L"Incorrect value inside of cell");
+    Assert::AreEqual(40.0, grid.evaluate(5.0, 20.0), 1e-9, L"Corner value is not clamped");
+    Assert::AreEqual(0.0, grid.evaluate(-1.0, -1.0), 1e-9, L"Corner value is not clamped");
+
+    const utils::InterpolationGrid column({ 0.0, 10.0 }, { 0.0 }, { 100.0, 200.0 });
+    Assert::AreEqual(150.0, column.evaluate(5.0, 7.0), 1e-9, L"Incorrect value of one column");
+}
+
+void InterpolationGridTest::adaptation()
+{
+    utils::InterpolationGrid grid({ 0.0, 1.0, 2.0 }, { 0.0, 1.0 },
+                                  { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 });
+
+    // Observation in grid point is exponentially weighted moving average.
+    grid.adapt(2.0, 1.0, 100.0, 0.5);
+    Assert::AreEqual(50.0, grid.evaluate(2.0, 1.0), 1e-9, L"Incorrect average in grid point");
+    Assert::AreEqual(0.0, grid.evaluate(1.0, 1.0), 1e-9, L"Far grid point is changed");
+
+    // Observation in the middle of cell is shared equally between its corners.
+    grid.adapt(0.5, 0.5, 40.0, 1.0);
+    const double* values = grid.getValues();
+    for (const std::size_t i : { 0, 1, 2, 3 })
+    {
+        Assert::AreEqual(10.0, values[i], 1e-9, L"Incorrect share of corner");
+    }
+    Assert::AreEqual(0.0, values[4], 1e-9, L"Point outside of cell is changed");
+}
+
+void InterpolationGridTest::externalMemory()
+{
+    const double rows[] = { 0.0, 10.0 };
+    const double columns[] = { 0.0 };
+    const double values[] = { 100.0, 200.0 };
+
+    utils::InterpolationGrid grid(rows, 2, columns, 1, values);
+    Assert::IsTrue(grid.getValues() == values, L"External values are copied");
+    Assert::AreEqual(150.0, grid.evaluate(5.0, 0.0), 1e-9, L"Incorrect value");
+
+    // Copy keeps using external memory until it is changed.
+    utils::InterpolationGrid copy(grid);
+    copy.adapt(0.0, 0.0, 300.0, 1.0);
+    Assert::AreEqual(100.0, values[0], L"External memory is changed");
+    Assert::AreEqual(300.0, copy.evaluate(0.0, 0.0), 1e-9, L"Copy isn't changed");
+    Assert::AreEqual(100.0, grid.evaluate(0.0, 0.0), 1e-9, L"Original is changed");
+    Assert::IsTrue(copy.getRows() == rows, L"Arguments are copied");
+}
+
+} // namespace utilitiesTests
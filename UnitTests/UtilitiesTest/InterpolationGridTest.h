@@ -0,0 +1,40 @@
+#ifndef INTERPOLATION_GRID_TEST_H
+#define INTERPOLATION_GRID_TEST_H
+
+#include <CppUnitTest.h>
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+/**
+ * \brief Set of tests for grid with bilinear interpolation.
+ */
+TEST_CLASS(InterpolationGridTest)
+{
+public:
+    /**
+     * \brief Test for checking interpolation inside of grid and clamping outside of it.
+     */
+    TEST_METHOD(bilinearInterpolation);
+
+    /**
+     * \brief Test for checking that observation changes only surrounding measurements.
+     */
+    TEST_METHOD(adaptation);
+
+    /**
+     * \brief Test for checking that grid over external memory never changes it.
+     */
+    TEST_METHOD(externalMemory);
+};
+
+} // namespace utilitiesTests
+
+#endif // INTERPOLATION_GRID_TEST_H
@@ -0,0 +1,80 @@
+#include "InterpolationTableTest.h"
+
+#include <Interpolation/InterpolationTable.h>
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+void InterpolationTableTest::linearInterpolation()
+{
+    const utils::InterpolationTable empty;
+    Assert::IsTrue(empty.empty(), L"Default table is not empty");
+    Assert::AreEqual(0.0, empty.evaluate(10.0), L"Value of empty table is not zero");
+
+    const utils::InterpolationTable table({ { 20.0, 300.0 }, { 0.0, 100.0 }, { 10.0, 150.0 },
+                                            { 10.0, 250.0 } },
+                                          utils::InterpolationTable::Method::LINEAR);
+    Assert::AreEqual(std::size_t{ 3 }, table.size(), L"Equal arguments are not merged");
+
+    Assert::AreEqual(100.0, table.evaluate(-5.0), L"Value before table is not clamped");
+    Assert::AreEqual(300.0, table.evaluate(25.0), L"Value after table is not clamped");
+    Assert::AreEqual(200.0, table.evaluate(10.0), L"Incorrect mean of equal arguments");
+    Assert::AreEqual(150.0, table.evaluate(5.0), L"Incorrect value in the first segment");
+    Assert::AreEqual(275.0, table.evaluate(17.5), L"Incorrect value in the second segment");
+}
+
+void InterpolationTableTest::monotoneCubic()
+{
+    const utils::InterpolationTable table({ { 0.0, 0.0 }, { 1.0, 10.0 }, { 2.0, 10.0 },
+                                            { 3.0, 40.0 }, { 10.0, 50.0 } });
+
+    const auto& arguments = table.getArguments();
+    const auto& values = table.getValues();
+    for (std::size_t i = 0; i < table.size(); ++i)
+    {
+        Assert::AreEqual(values[i], table.evaluate(arguments[i]), 1e-9,
+                         L"Curve doesn't pass through measurement");
+    }
+
+    // Every step of curve goes in the same direction as measurements, even on flat part.
+    double previous = table.evaluate(0.0);
+    for (double argument = 0.05; argument <= 10.0; argument += 0.05)
+    {
+        const double value = table.evaluate(argument);
+        Assert::IsTrue(value >= previous - 1e-9, L"Curve is not monotone");
+        if (argument > 1.0 && argument < 2.0)
+        {
+            Assert::AreEqual(10.0, value, 1e-9, L"Curve overshoots flat part");
+        }
+        previous = value;
+    }
+}
+
+void InterpolationTableTest::adaptation()
+{
+    utils::InterpolationTable table({ { 0.0, 100.0 }, { 10.0, 200.0 }, { 20.0, 300.0 } },
+                                    utils::InterpolationTable::Method::LINEAR);
+
+    // Observation in table point is exponentially weighted moving average.
+    table.adapt(10.0, 300.0, 0.5);
+    Assert::AreEqual(250.0, table.evaluate(10.0), 1e-9, L"Incorrect average in table point");
+    Assert::AreEqual(100.0, table.evaluate(0.0), 1e-9, L"Far table point is changed");
+    Assert::AreEqual(300.0, table.evaluate(20.0), 1e-9, L"Far table point is changed");
+
+    // Observation between points is shared in proportion to distance to them.
+    table.adapt(2.5, 400.0, 1.0);
+    Assert::AreEqual(296.875, table.getValues()[0], 1e-9, L"Incorrect share of nearest point");
+    Assert::AreEqual(315.625, table.getValues()[1], 1e-9, L"Incorrect share of farther point");
+
+    // Repeated observations converge to observed value.
+    for (int i = 0; i < 100; ++i)
+    {
+        table.adapt(25.0, 500.0, 0.2);
+    }
+    Assert::AreEqual(500.0, table.evaluate(20.0), 1e-6, L"Curve doesn't converge");
+}
+
+} // namespace utilitiesTests
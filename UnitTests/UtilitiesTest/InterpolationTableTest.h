@@ -0,0 +1,41 @@
+#ifndef INTERPOLATION_TABLE_TEST_H
+#define INTERPOLATION_TABLE_TEST_H
+
+#include <CppUnitTest.h>
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+/**
+ * \brief Set of tests for table with interpolation.
+ */
+TEST_CLASS(InterpolationTableTest)
+{
+public:
+    /**
+     * \brief Test for checking linear interpolation, clamping and merging of equal arguments.
+     */
+    TEST_METHOD(linearInterpolation);
+
+    /**
+     * \brief Test for checking that cubic interpolation passes through measurements and never
+     *        leaves range of neighbouring values.
+     */
+    TEST_METHOD(monotoneCubic);
+
+    /**
+     * \brief Test for checking that observations move curve towards them.
+     */
+    TEST_METHOD(adaptation);
+};
+
+} // namespace utilitiesTests
+
+#endif // INTERPOLATION_TABLE_TEST_H
@@ -0,0 +1,181 @@
+#include "MessageTest.h"
+
+#include "../ClientTest/testUtilites.h"
+#include <Protocol/Framer.h>
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+void MessageTest::pointRoundTrip()
+{
+    const vasily::RobotData robotData = { 985'000, -400'000, 940'000, -180'000, 0, 0, 10, 2, 0 };
+    protocol::Message message = protocol::makePoint(robotData);
+    message.sequence = 42;
+
+    const std::string frame = protocol::encode(message);
+    Assert::AreEqual(protocol::HEADER_SIZE + protocol::ROBOT_DATA_SIZE, frame.size(),
+                     L"Incorrect size of binary message");
+
+    const auto decoded = protocol::decode(frame);
+    Assert::IsTrue(decoded.has_value(), L"Correct message not decoded");
+    Assert::IsTrue(decoded->type == protocol::MessageType::POINT, L"Incorrect message type");
+    Assert::AreEqual(std::uint32_t{ 42 }, decoded->sequence, L"Incorrect sequence number");
+    specialAreEqual(robotData, decoded->robotData, L"after decoding");
+}
+
+void MessageTest::incorrectFrame()
+{
+    const std::string frame = protocol::encode(protocol::makePoint(vasily::RobotData{}));
+
+    Assert::IsFalse(protocol::decode(frame.substr(0, frame.size() - 1)).has_value(),
+                    L"Truncated message decoded");
+    Assert::IsFalse(protocol::decode("X" + frame.substr(1)).has_value(),
+                    L"Message with incorrect magic decoded");
+}
+
+void MessageTest::framerAfterHandshake()
+{
+    const vasily::RobotData robotData = { 1, 2, 3, 4, 5, 6, 10, 2, 0 };
+    const std::string point = protocol::encode(protocol::makePoint(robotData));
+
+    protocol::Framer framer;
+    framer.append(protocol::Framer::frame(protocol::HANDSHAKE_BINARY) + point.substr(0, 7));
+
+    const auto handshake = framer.nextMessage();
+    Assert::IsTrue(handshake.has_value() && *handshake == protocol::HANDSHAKE_BINARY,
+                   L"Handshake not extracted");
+
+    framer.setFormat(protocol::WireFormat::BINARY);
+    Assert::IsFalse(framer.nextMessage().has_value(), L"Incomplete binary message extracted");
+
+    framer.append(point.substr(7));
+    const auto frame = framer.nextMessage();
+    Assert::IsTrue(frame.has_value(), L"Complete binary message not extracted");
+    specialAreEqual(robotData, protocol::decode(*frame)->robotData, L"after framing");
+}
+
+void MessageTest::sequenceReplacement()
+{
+    const vasily::RobotData robotData = { 1, -2, 3, -4, 5, -6, 10, 2, 0 };
+    protocol::Message message = protocol::makePoint(robotData);
+    message.sequence = 7;
+
+    std::string frame = protocol::encode(message);
+    protocol::setSequence(frame, 0x01020304);
+
+    const auto decoded = protocol::decode(frame);
+    Assert::IsTrue(decoded.has_value(), L"Message with replaced sequence not decoded");
+    Assert::AreEqual(std::uint32_t{ 0x01020304 }, decoded->sequence, L"Sequence not replaced");
+    specialAreEqual(robotData, decoded->robotData, L"after sequence replacement");
+}
+
+void MessageTest::heartbeatRoundTrip()
+{
+    const auto decoded = protocol::decode(protocol::encode(protocol::makePing(42)));
+    Assert::IsTrue(decoded.has_value(), L"Ping not decoded");
+    Assert::IsTrue(decoded->type == protocol::MessageType::PING, L"Incorrect type of ping");
+    Assert::AreEqual(std::uint32_t{ 42 }, decoded->sequence, L"Incorrect number of ping");
+
+    const auto parsed = protocol::parseHeartbeat(protocol::toText(protocol::makePong(42)));
+    Assert::IsTrue(parsed.has_value(), L"Pong line not parsed");
+    Assert::IsTrue(parsed->type == protocol::MessageType::PONG, L"Incorrect type of pong");
+    Assert::AreEqual(std::uint32_t{ 42 }, parsed->sequence, L"Incorrect number of pong");
+
+    Assert::IsFalse(protocol::parseHeartbeat("#PING x1").has_value(), L"Broken ping parsed");
+    Assert::IsFalse(protocol::parseHeartbeat("#PING 4294967296").has_value(),
+                    L"Too big number of ping parsed");
+}
+
+void MessageTest::priorityPoint()
+{
+    const vasily::RobotData home = vasily::RobotData::getDefaultPosition();
+    Assert::IsFalse(protocol::isPriority(protocol::makePoint(home)),
+                    L"Regular point is priority");
+
+    const auto decoded = protocol::decode(protocol::encode(protocol::makePriorityPoint(home)));
+    Assert::IsTrue(decoded.has_value(), L"Priority point not decoded");
+    Assert::IsTrue(protocol::isPriority(*decoded), L"Priority flag lost in binary format");
+    Assert::IsTrue(decoded->robotData == home, L"Incorrect point after decoding");
+
+    const std::string text = protocol::toText(protocol::makePriorityPoint(home));
+    const auto rest = protocol::stripPriorityPrefix(text);
+    Assert::IsTrue(rest.has_value(), L"Priority prefix lost in text format");
+    Assert::IsTrue(*rest == home.toString(), L"Incorrect point after prefix");
+    Assert::IsFalse(protocol::stripPriorityPrefix(home.toString()).has_value(),
+                    L"Regular line has priority prefix");
+
+    // Stop flag of regular point doesn't make it priority, only mark does.
+    vasily::RobotData stop = home;
+    stop.parameters.back() = 1;
+    Assert::IsFalse(protocol::isPriority(protocol::makePoint(stop)),
+                    L"Stop point without mark is priority");
+}
+
+void MessageTest::etaRoundTrip()
+{
+    const auto total = protocol::parseEtaRequest(protocol::makeEtaRequest(std::nullopt));
+    Assert::IsTrue(total.has_value(), L"Request for queue not parsed");
+    Assert::IsFalse(total->sequence.has_value(), L"Request for queue has point");
+
+    const auto point = protocol::parseEtaRequest(protocol::makeEtaRequest(17));
+    Assert::IsTrue(point.has_value() && point->sequence == 17u,
+                   L"Incorrect number of point in request");
+    Assert::IsFalse(protocol::parseEtaRequest("#ETAX").has_value(), L"Broken request parsed");
+    Assert::IsFalse(protocol::parseEtaRequest("#ETA -1").has_value(), L"Broken request parsed");
+
+    const auto answer = protocol::parseEtaAnswer(
+        protocol::makeEtaAnswer({ 17, std::chrono::microseconds(1'500'000) }));
+    Assert::IsTrue(answer.has_value(), L"Answer not parsed");
+    Assert::IsTrue(answer->sequence == 17u, L"Incorrect number of point in answer");
+    Assert::AreEqual(1'500'000LL, static_cast<long long>(answer->time.count()),
+                     L"Incorrect time in answer");
+
+    const auto unknown = protocol::parseEtaAnswer(protocol::makeEtaAnswer({ std::nullopt, {} }));
+    Assert::IsTrue(unknown.has_value(), L"Answer about queue not parsed");
+    Assert::IsFalse(unknown->sequence.has_value(), L"Answer about queue has point");
+    Assert::AreEqual(0LL, static_cast<long long>(unknown->time.count()),
+                     L"Incorrect time of empty queue");
+
+    const auto missing = protocol::parseEtaAnswer("#ETA 5 -1");
+    Assert::IsTrue(missing.has_value() && missing->time.count() < 0,
+                   L"Unknown time is not negative");
+    Assert::IsFalse(protocol::parseEtaRequest("#ETA TOTAL 10").has_value(),
+                    L"Answer parsed as request");
+}
+
+void MessageTest::batchSerialization()
+{
+    protocol::Message point = protocol::makePoint(vasily::RobotData::getDefaultPosition());
+    point.sequence = 7;
+    const protocol::Message text = protocol::makeText(protocol::QUEUE_FULL);
+
+    for (const auto format : { protocol::WireFormat::TEXT, protocol::WireFormat::BINARY })
+    {
+        std::string buffer;
+        protocol::serialize(point, format, buffer);
+        protocol::serialize(text, format, buffer);
+        Assert::IsTrue(buffer == protocol::serialize(point, format)
+                                 + protocol::serialize(text, format),
+                       L"Batch differs from separate messages");
+    }
+}
+
+void MessageTest::rejectParsing()
+{
+    const std::string line = "1 2 3 4 5 6 10 2 0";
+
+    const auto single = protocol::parseRejectedLine(std::string(protocol::REJECT_PREFIX) + line);
+    Assert::IsTrue(single.has_value() && *single == line, L"Rejected point not extracted");
+
+    const auto program = protocol::parseRejectedLine(std::string(protocol::REJECT_PREFIX) + line
+                                                     + std::string(protocol::REJECT_POINTS)
+                                                     + " 0");
+    Assert::IsTrue(program.has_value() && *program == line, L"Numbers of points not removed");
+
+    Assert::IsFalse(protocol::parseRejectedLine(line).has_value(), L"Answer parsed as rejection");
+}
+
+} // namespace utilitiesTests
@@ -0,0 +1,70 @@
+#ifndef MESSAGE_TEST_H
+#define MESSAGE_TEST_H
+
+#include <CppUnitTest.h>
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+/**
+ * \brief Set of tests for binary wire format.
+ */
+TEST_CLASS(MessageTest)
+{
+public:
+    /**
+     * \brief Test for checking that point is encoded and decoded without changes.
+     */
+    TEST_METHOD(pointRoundTrip);
+
+    /**
+     * \brief Test for checking that broken binary message is rejected.
+     */
+    TEST_METHOD(incorrectFrame);
+
+    /**
+     * \brief Test for checking that framer switches to binary format after handshake.
+     */
+    TEST_METHOD(framerAfterHandshake);
+
+    /**
+     * \brief Test for checking that sequence number is changed without touching payload.
+     */
+    TEST_METHOD(sequenceReplacement);
+
+    /**
+     * \brief Test for checking that heartbeat keeps its number in both formats.
+     */
+    TEST_METHOD(heartbeatRoundTrip);
+
+    /**
+     * \brief Test for checking that priority mark survives both formats.
+     */
+    TEST_METHOD(priorityPoint);
+
+    /**
+     * \brief Test for checking that requests and answers about queue time are parsed back.
+     */
+    TEST_METHOD(etaRoundTrip);
+
+    /**
+     * \brief Test for checking that messages appended to one buffer are the same as separate ones.
+     */
+    TEST_METHOD(batchSerialization);
+
+    /**
+     * \brief Test for checking that rejected line is extracted from answer of layer.
+     */
+    TEST_METHOD(rejectParsing);
+};
+
+} // namespace utilitiesTests
+
+#endif // MESSAGE_TEST_H
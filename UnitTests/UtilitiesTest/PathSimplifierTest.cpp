@@ -0,0 +1,119 @@
+#include "PathSimplifierTest.h"
+
+#include <vector>
+
+#include <PathSimplifier/PathSimplifier.h>
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+namespace
+{
+
+/**
+ * \brief                Pass all points through simplifier.
+ * \param[in] simplifier Simplifier to use.
+ * \param[in] points     Stream of points.
+ * \return               Kept points.
+ */
+std::vector<vasily::RobotData> simplify(utils::PathSimplifier<vasily::RobotData>& simplifier,
+                                        const std::vector<vasily::RobotData>& points)
+{
+    std::vector<vasily::RobotData> result;
+    for (const auto& point : points)
+    {
+        if (auto kept = simplifier.push(point))
+        {
+            result.push_back(*kept);
+        }
+    }
+    if (auto kept = simplifier.flush())
+    {
+        result.push_back(*kept);
+    }
+    return result;
+}
+
+} // anonymous namespace
+
+void PathSimplifierTest::collinearPoints()
+{
+    utils::PathSimplifier<vasily::RobotData> simplifier(100, 100, 64);
+
+    // Line along x with small noise, then corner and line along y.
+    std::vector<vasily::RobotData> points;
+    for (int i = 0; i <= 10; ++i)
+    {
+        points.push_back({ { i * 1000, (i % 2) * 50, 0, 0, 0, 0 }, { 10, 2, 0 } });
+    }
+    for (int i = 1; i <= 10; ++i)
+    {
+        points.push_back({ { 10'000, i * 1000, 0, 0, 0, 0 }, { 10, 2, 0 } });
+    }
+
+    const auto kept = simplify(simplifier, points);
+    Assert::AreEqual(std::size_t{ 3 }, kept.size(), L"Incorrect number of kept points");
+    Assert::IsTrue(kept[0] == points.front(), L"The first point is lost");
+    Assert::IsTrue(kept[1] == points[10], L"Corner is lost");
+    Assert::IsTrue(kept[2] == points.back(), L"The last point is lost");
+    Assert::AreEqual(std::uint64_t{ 18 }, simplifier.getRemoved(),
+                     L"Incorrect number of removed points");
+
+    // Window limits number of points replaced by one segment.
+    utils::PathSimplifier<vasily::RobotData> limited(100, 100, 4);
+    Assert::AreEqual(std::size_t{ 7 }, simplify(limited, points).size(),
+                     L"Window size is not taken into account");
+
+    // Point returning back is a turn, not a duplicate.
+    utils::PathSimplifier<vasily::RobotData> turn(100, 100, 64);
+    const std::vector<vasily::RobotData> backAndForth
+    {
+        { { 0, 0, 0, 0, 0, 0 }, { 10, 2, 0 } },
+        { { 5000, 0, 0, 0, 0, 0 }, { 10, 2, 0 } },
+        { { 0, 0, 0, 0, 0, 0 }, { 10, 2, 0 } }
+    };
+    Assert::AreEqual(std::size_t{ 3 }, simplify(turn, backAndForth).size(),
+                     L"Turn back was removed");
+}
+
+void PathSimplifierTest::orientationAndParameters()
+{
+    utils::PathSimplifier<vasily::RobotData> simplifier(100, 100, 64);
+
+    // Position is on line, but tool turns there and back.
+    const std::vector<vasily::RobotData> rotation
+    {
+        { { 0, 0, 0, 0, 0, 0 }, { 10, 2, 0 } },
+        { { 1000, 0, 0, 5000, 0, 0 }, { 10, 2, 0 } },
+        { { 2000, 0, 0, 0, 0, 0 }, { 10, 2, 0 } }
+    };
+    Assert::AreEqual(std::size_t{ 3 }, simplify(simplifier, rotation).size(),
+                     L"Orientation is not taken into account");
+
+    // Pure rotation without movement is interpolated by orientation.
+    simplifier.reset();
+    const std::vector<vasily::RobotData> turnInPlace
+    {
+        { { 0, 0, 0, 0, 0, 0 }, { 10, 2, 0 } },
+        { { 0, 0, 0, 1000, 0, 0 }, { 10, 2, 0 } },
+        { { 0, 0, 0, 2000, 0, 0 }, { 10, 2, 0 } }
+    };
+    Assert::AreEqual(std::size_t{ 2 }, simplify(simplifier, turnInPlace).size(),
+                     L"Rotation in place is not simplified");
+
+    // Point with other segtime has to reach robot.
+    simplifier.reset();
+    const std::vector<vasily::RobotData> parameters
+    {
+        { { 0, 0, 0, 0, 0, 0 }, { 10, 2, 0 } },
+        { { 1000, 0, 0, 0, 0, 0 }, { 20, 2, 0 } },
+        { { 2000, 0, 0, 0, 0, 0 }, { 10, 2, 0 } }
+    };
+    Assert::AreEqual(std::size_t{ 3 }, simplify(simplifier, parameters).size(),
+                     L"Points with different parameters were merged");
+}
+
+} // namespace utilitiesTests
@@ -0,0 +1,35 @@
+#ifndef PATH_SIMPLIFIER_TEST_H
+#define PATH_SIMPLIFIER_TEST_H
+
+#include <CppUnitTest.h>
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+/**
+ * \brief Set of tests for streaming path simplification.
+ */
+TEST_CLASS(PathSimplifierTest)
+{
+public:
+    /**
+     * \brief Test for checking that collinear points are removed and corners are kept.
+     */
+    TEST_METHOD(collinearPoints);
+
+    /**
+     * \brief Test for checking that orientation and parameters of points are taken into account.
+     */
+    TEST_METHOD(orientationAndParameters);
+};
+
+} // namespace utilitiesTests
+
+#endif // PATH_SIMPLIFIER_TEST_H
@@ -0,0 +1,75 @@
+#include "RingBufferTest.h"
+
+#include <thread>
+
+#include <RingBuffer/RingBuffer.h>
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+void RingBufferTest::capacityLimit()
+{
+    container::RingBuffer<int> buffer(3);
+    Assert::AreEqual(std::size_t{ 4 }, buffer.capacity(), L"Capacity not rounded");
+
+    for (int i = 0; i < 4; ++i)
+    {
+        Assert::IsTrue(buffer.tryPush(i), L"Element rejected before queue is full");
+    }
+    Assert::IsFalse(buffer.tryPush(4), L"Element accepted by full queue");
+
+    Assert::AreEqual(0, *buffer.tryPop(), L"Incorrect order of elements");
+    Assert::IsTrue(buffer.tryPush(4), L"Element rejected after pop");
+    for (int i = 1; i < 5; ++i)
+    {
+        Assert::AreEqual(i, *buffer.tryPop(), L"Incorrect order after wrap around");
+    }
+    Assert::IsFalse(buffer.tryPop().has_value(), L"Element popped from empty queue");
+    Assert::AreEqual(std::size_t{ 4 }, buffer.getHighWaterMark(), L"Incorrect high-water mark");
+}
+
+void RingBufferTest::producerConsumer()
+{
+    constexpr int kCount = 10'000;
+    container::RingBuffer<int> buffer(16);
+
+    std::thread producer([&buffer]()
+    {
+        for (int i = 0; i < kCount; )
+        {
+            if (buffer.tryPush(i))
+            {
+                ++i;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    long long sum = 0;
+    int expected = 0;
+    while (expected < kCount)
+    {
+        if (const auto value = buffer.tryPop(); value.has_value())
+        {
+            Assert::AreEqual(expected, *value, L"Element lost or reordered");
+            sum += *value;
+            ++expected;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    Assert::AreEqual(static_cast<long long>(kCount) * (kCount - 1) / 2, sum,
+                     L"Incorrect sum of elements");
+}
+
+} // namespace utilitiesTests
@@ -0,0 +1,35 @@
+#ifndef RING_BUFFER_TEST_H
+#define RING_BUFFER_TEST_H
+
+#include <CppUnitTest.h>
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+/**
+ * \brief Set of tests for fixed-capacity queue.
+ */
+TEST_CLASS(RingBufferTest)
+{
+public:
+    /**
+     * \brief Test for checking that full queue rejects elements and keeps order.
+     */
+    TEST_METHOD(capacityLimit);
+
+    /**
+     * \brief Test for checking that elements pass between two threads without loss.
+     */
+    TEST_METHOD(producerConsumer);
+};
+
+} // namespace utilitiesTests
+
+#endif // RING_BUFFER_TEST_H
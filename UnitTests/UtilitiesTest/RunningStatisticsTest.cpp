@@ -0,0 +1,47 @@
+#include "RunningStatisticsTest.h"
+
+#include <RunningStatistics/RunningStatistics.h>
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+void RunningStatisticsTest::knownSamples()
+{
+    stats::RunningStatistics statistics;
+    Assert::AreEqual(0.0, statistics.getVariance(), 1e-12,
+                     L"Variance of empty statistics is not zero");
+
+    for (const double value : { 2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0 })
+    {
+        statistics.record(value);
+    }
+
+    Assert::AreEqual(std::uint64_t{ 8 }, statistics.getCount(), L"Incorrect number of samples");
+    Assert::AreEqual(5.0, statistics.getMean(), 1e-12, L"Incorrect mean");
+    Assert::AreEqual(32.0 / 7.0, statistics.getVariance(), 1e-12, L"Incorrect variance");
+    Assert::AreEqual(2.0, statistics.getMin(), 1e-12, L"Incorrect min");
+    Assert::AreEqual(9.0, statistics.getMax(), 1e-12, L"Incorrect max");
+
+    statistics.reset();
+    Assert::AreEqual(std::uint64_t{ 0 }, statistics.getCount(), L"Statistics not reset");
+}
+
+void RunningStatisticsTest::largeOffset()
+{
+    stats::RunningStatistics statistics;
+
+    // Sum of squares would lose all digits of spread here.
+    constexpr double kOffset = 1e9;
+    for (int i = 0; i < 1000; ++i)
+    {
+        statistics.record(kOffset + (i % 2 == 0 ? -1.0 : 1.0));
+    }
+
+    Assert::AreEqual(kOffset, statistics.getMean(), 1e-6, L"Incorrect mean");
+    Assert::AreEqual(1000.0 / 999.0, statistics.getVariance(), 1e-6, L"Incorrect variance");
+}
+
+} // namespace utilitiesTests
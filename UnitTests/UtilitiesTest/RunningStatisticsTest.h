@@ -0,0 +1,35 @@
+#ifndef RUNNING_STATISTICS_TEST_H
+#define RUNNING_STATISTICS_TEST_H
+
+#include <CppUnitTest.h>
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+/**
+ * \brief Set of tests for streaming mean and variance.
+ */
+TEST_CLASS(RunningStatisticsTest)
+{
+public:
+    /**
+     * \brief Test for checking mean, variance and range of known samples.
+     */
+    TEST_METHOD(knownSamples);
+
+    /**
+     * \brief Test for checking that variance stays precise when mean is much bigger than spread.
+     */
+    TEST_METHOD(largeOffset);
+};
+
+} // namespace utilitiesTests
+
+#endif // RUNNING_STATISTICS_TEST_H
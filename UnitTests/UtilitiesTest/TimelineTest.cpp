@@ -0,0 +1,67 @@
+#include "TimelineTest.h"
+
+#include <Timeline/Timeline.h>
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+void TimelineTest::prefixSums()
+{
+    using namespace std::chrono_literals;
+    utils::Timeline timeline;
+
+    Assert::AreEqual(100LL, static_cast<long long>(timeline.append(1, 100us).count()),
+                     L"Incorrect finish of the first operation");
+    Assert::AreEqual(300LL, static_cast<long long>(timeline.append(2, 200us).count()),
+                     L"Incorrect finish of the second operation");
+    Assert::AreEqual(350LL, static_cast<long long>(timeline.append(3, 50us).count()),
+                     L"Incorrect finish of the third operation");
+    Assert::AreEqual(350LL, static_cast<long long>(timeline.getRemaining().count()),
+                     L"Incorrect remaining time");
+
+    Assert::AreEqual(100LL, static_cast<long long>(timeline.release(1).count()),
+                     L"Incorrect released time");
+    Assert::IsFalse(timeline.find(1).has_value(), L"Released operation is found");
+    Assert::AreEqual(200LL, static_cast<long long>(timeline.find(2)->count()),
+                     L"Incorrect time left to the second operation");
+    Assert::AreEqual(250LL, static_cast<long long>(timeline.find(3)->count()),
+                     L"Incorrect time left to the third operation");
+
+    // Extra operations are ignored.
+    Assert::AreEqual(250LL, static_cast<long long>(timeline.release(5).count()),
+                     L"Incorrect released time");
+    Assert::IsTrue(timeline.empty(), L"Queue is not empty");
+    Assert::AreEqual(0LL, static_cast<long long>(timeline.getRemaining().count()),
+                     L"Incorrect remaining time");
+}
+
+void TimelineTest::tagsAndClear()
+{
+    using namespace std::chrono_literals;
+    utils::Timeline timeline;
+
+    timeline.append(7, 10us);
+    timeline.append(7, 20us);
+    timeline.append(8, 30us);
+    Assert::AreEqual(30LL, static_cast<long long>(timeline.find(7)->count()),
+                     L"Tag is not given to the last operation");
+
+    // The first operation with the same tag goes away, the second one stays.
+    timeline.release(1);
+    Assert::AreEqual(20LL, static_cast<long long>(timeline.find(7)->count()),
+                     L"Tag of remaining operation is lost");
+
+    timeline.clear();
+    Assert::AreEqual(std::size_t{ 0 }, timeline.size(), L"Queue is not cleared");
+    Assert::IsFalse(timeline.find(8).has_value(), L"Cleared operation is found");
+
+    Assert::AreEqual(40LL, static_cast<long long>(timeline.append(9, 40us).count()),
+                     L"Cleared operations are counted");
+    Assert::AreEqual(40LL, static_cast<long long>(timeline.find(9)->count()),
+                     L"Incorrect time left after clearing");
+}
+
+} // namespace utilitiesTests
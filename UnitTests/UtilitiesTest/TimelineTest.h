@@ -0,0 +1,35 @@
+#ifndef TIMELINE_TEST_H
+#define TIMELINE_TEST_H
+
+#include <CppUnitTest.h>
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+/**
+ * \brief Set of tests for queue of planned operations.
+ */
+TEST_CLASS(TimelineTest)
+{
+public:
+    /**
+     * \brief Test for checking that time left to operations decreases when queue is released.
+     */
+    TEST_METHOD(prefixSums);
+
+    /**
+     * \brief Test for checking that repeated tag and clearing keep lookup correct.
+     */
+    TEST_METHOD(tagsAndClear);
+};
+
+} // namespace utilitiesTests
+
+#endif // TIMELINE_TEST_H
@@ -0,0 +1,42 @@
+#include "TraceRecorderTest.h"
+
+#include <Trace/TraceRecorder.h>
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+void TraceRecorderTest::stageSpans()
+{
+    using namespace std::chrono_literals;
+    stats::TraceRecorder recorder({ "receive", "enqueue", "dispatch" }, {});
+
+    const auto start = stats::Trace::Clock::now();
+    stats::Trace full;
+    full.mark(0, start);
+    full.mark(1, start + 10us);
+    full.mark(2, start + 110us);
+    recorder.record(full);
+
+    // Skipped stage gives its time to the next passed one.
+    stats::Trace partial;
+    partial.mark(0, start);
+    partial.mark(2, start + 50us);
+    recorder.record(partial);
+
+    Assert::AreEqual(std::uint64_t{ 2 }, recorder.getCount(), L"Incorrect number of traces");
+    Assert::AreEqual(std::uint64_t{ 1 }, recorder.getSpan(1).getCount(),
+                     L"Skipped stage recorded");
+    Assert::AreEqual(10LL, static_cast<long long>(recorder.getSpan(1).getMax().count()),
+                     L"Incorrect span of the second stage");
+    Assert::AreEqual(50LL, static_cast<long long>(recorder.getSpan(2).getMin().count()),
+                     L"Incorrect span after skipped stage");
+    Assert::AreEqual(100LL, static_cast<long long>(recorder.getSpan(2).getMax().count()),
+                     L"Incorrect span of the third stage");
+    Assert::AreEqual(110LL, static_cast<long long>(recorder.getTotal().getMax().count()),
+                     L"Incorrect total time");
+}
+
+} // namespace utilitiesTests
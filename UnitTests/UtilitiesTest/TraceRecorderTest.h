@@ -0,0 +1,30 @@
+#ifndef TRACE_RECORDER_TEST_H
+#define TRACE_RECORDER_TEST_H
+
+#include <CppUnitTest.h>
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+/**
+ * \brief Namespace scope to test project.
+ */
+namespace utilitiesTests
+{
+
+/**
+ * \brief Set of tests for per-point tracing.
+ */
+TEST_CLASS(TraceRecorderTest)
+{
+public:
+    /**
+     * \brief Test for checking that every stage gets time since the previous passed stage.
+     */
+    TEST_METHOD(stageSpans);
+};
+
+} // namespace utilitiesTests
+
+#endif // TRACE_RECORDER_TEST_H
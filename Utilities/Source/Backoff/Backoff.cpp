@@ -0,0 +1,45 @@
+#include <algorithm>
+
+#include "Backoff.h"
+
+
+namespace utils
+{
+
+Backoff::Backoff(const std::chrono::milliseconds initialDelay,
+                 const std::chrono::milliseconds maxDelay, const double jitter)
+    : _initialDelay(initialDelay),
+      _maxDelay(std::max(initialDelay, maxDelay)),
+      _jitter(std::clamp(jitter, 0.0, 1.0)),
+      _attempts(0),
+      _generator(std::random_device{}())
+{
+}
+
+std::chrono::milliseconds Backoff::nextDelay()
+{
+    // Stop doubling when limit is reached, so delay never overflows.
+    auto delay = _initialDelay;
+    for (std::size_t i = 0; i < _attempts && delay < _maxDelay; ++i)
+    {
+        delay *= 2;
+    }
+    delay = std::min(delay, _maxDelay);
+    ++_attempts;
+
+    std::uniform_real_distribution<double> distribution(1.0 - _jitter, 1.0);
+    return std::chrono::milliseconds(
+        static_cast<long long>(static_cast<double>(delay.count()) * distribution(_generator)));
+}
+
+void Backoff::reset() noexcept
+{
+    _attempts = 0;
+}
+
+std::size_t Backoff::getAttempts() const noexcept
+{
+    return _attempts;
+}
+
+} // namespace utils
@@ -0,0 +1,79 @@
+#ifndef BACKOFF_H
+#define BACKOFF_H
+
+#include <chrono>
+#include <random>
+
+
+/**
+ * \brief Unique namespace for utilities functions.
+ */
+namespace utils
+{
+
+/**
+ * \brief   Class used to calculate delays between reconnection attempts.
+ * \details Delay doubles after every failed attempt up to limit. Random jitter keeps several
+ *          peers which lost connection at once from reconnecting in the same moment.
+ */
+class Backoff
+{
+public:
+    /**
+     * \brief                  Constructor which sets delays.
+     * \param[in] initialDelay Delay before the first attempt.
+     * \param[in] maxDelay     Limit of delay.
+     * \param[in] jitter       Part of delay which is randomized, in range [0, 1].
+     */
+                                Backoff(const std::chrono::milliseconds initialDelay,
+                                        const std::chrono::milliseconds maxDelay,
+                                        const double jitter = 0.2);
+
+    /**
+     * \brief  Get delay before next attempt and increase it for the following one.
+     * \return Delay in milliseconds.
+     */
+    std::chrono::milliseconds   nextDelay();
+
+    /**
+     * \brief Return to initial delay (e.g. after successful connection).
+     */
+    void                        reset() noexcept;
+
+    /**
+     * \brief  Get number of attempts since last reset.
+     * \return Number of calculated delays.
+     */
+    std::size_t                 getAttempts() const noexcept;
+
+
+private:
+    /**
+     * \brief Delay before the first attempt.
+     */
+    std::chrono::milliseconds   _initialDelay;
+
+    /**
+     * \brief Limit of delay.
+     */
+    std::chrono::milliseconds   _maxDelay;
+
+    /**
+     * \brief Part of delay which is randomized.
+     */
+    double                      _jitter;
+
+    /**
+     * \brief Number of attempts since last reset.
+     */
+    std::size_t                 _attempts;
+
+    /**
+     * \brief Generator used for jitter.
+     */
+    std::mt19937                _generator;
+};
+
+} // namespace utils
+
+#endif // BACKOFF_H
@@ -0,0 +1,163 @@
+#include <array>
+
+#include "Capture.h"
+
+
+namespace capture
+{
+
+namespace
+{
+
+/**
+ * \brief             Append integer to buffer in little-endian order.
+ * \tparam T          Unsigned integer type.
+ * \param[out] buffer Buffer to append.
+ * \param[in] value   Value to write.
+ */
+template <class T>
+void writeLittleEndian(std::string& buffer, const T value)
+{
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+    {
+        buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+/**
+ * \brief          Read integer in little-endian order.
+ * \tparam T       Unsigned integer type.
+ * \param[in] data Buffer which contains at least sizeof(T) bytes.
+ * \return         Read value.
+ */
+template <class T>
+T readLittleEndian(const char* data)
+{
+    T result = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+    {
+        result |= static_cast<T>(static_cast<unsigned char>(data[i])) << (8 * i);
+    }
+    return result;
+}
+
+} // anonymous namespace
+
+CaptureWriter::CaptureWriter(const std::string& fileName)
+    : _file(fileName, std::ios::binary | std::ios::app),
+      _mutex(),
+      _startTime(std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch())),
+      _start(std::chrono::steady_clock::now())
+{
+    // Append mode always writes at the end, so empty file is the only one without header.
+    _file.seekp(0, std::ios::end);
+    if (_file.is_open() && _file.tellp() == 0)
+    {
+        _file.write(FILE_MAGIC.data(), static_cast<std::streamsize>(FILE_MAGIC.size()));
+    }
+    if (_file.is_open())
+    {
+        write(Event::RUN_STARTED, 0, 0, {});
+    }
+}
+
+bool CaptureWriter::isOpen() const noexcept
+{
+    return _file.is_open();
+}
+
+void CaptureWriter::write(const Event event, const std::size_t robotId,
+                          const std::size_t sessionId, const std::string_view data)
+{
+    // Rest of header is built before lock, so other threads wait only for file write.
+    std::string header;
+    header.reserve(RECORD_HEADER_SIZE);
+    writeLittleEndian(header, static_cast<std::uint8_t>(event));
+    writeLittleEndian(header, std::uint8_t{ 0 });
+    writeLittleEndian(header, static_cast<std::uint16_t>(robotId));
+    writeLittleEndian(header, static_cast<std::uint32_t>(sessionId));
+    writeLittleEndian(header, static_cast<std::uint32_t>(data.size()));
+
+    std::lock_guard lockGuard(_mutex);
+
+    // Clock is read under lock, otherwise records of several threads get out of time order.
+    const auto time = _startTime + std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - _start);
+    std::string stamp;
+    writeLittleEndian(stamp, static_cast<std::uint64_t>(time.count()));
+
+    _file.write(stamp.data(), static_cast<std::streamsize>(stamp.size()));
+    _file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    _file.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+void CaptureWriter::flush()
+{
+    std::lock_guard lockGuard(_mutex);
+    _file.flush();
+}
+
+CaptureReader::CaptureReader(const std::string& fileName)
+    : _file(fileName, std::ios::binary),
+      _isValid(false)
+{
+    std::string magic(FILE_MAGIC.size(), '\0');
+    _file.read(magic.data(), static_cast<std::streamsize>(magic.size()));
+    _isValid = _file.good() && magic == FILE_MAGIC;
+}
+
+bool CaptureReader::isValid() const noexcept
+{
+    return _isValid;
+}
+
+std::optional<Record> CaptureReader::next()
+{
+    if (!_isValid)
+    {
+        return std::nullopt;
+    }
+
+    std::array<char, RECORD_HEADER_SIZE> header{};
+    if (!_file.read(header.data(), static_cast<std::streamsize>(header.size())))
+    {
+        return std::nullopt;
+    }
+
+    Record record;
+    record.time      = std::chrono::nanoseconds(readLittleEndian<std::uint64_t>(header.data()));
+    record.event     = static_cast<Event>(readLittleEndian<std::uint8_t>(header.data() + 8));
+    record.robotId   = readLittleEndian<std::uint16_t>(header.data() + 10);
+    record.sessionId = readLittleEndian<std::uint32_t>(header.data() + 12);
+    if (record.event > Event::RUN_STARTED)
+    {
+        _isValid = false;
+        return std::nullopt;
+    }
+
+    // Record cut by crash of writer is dropped.
+    record.data.resize(readLittleEndian<std::uint32_t>(header.data() + 16));
+    if (!_file.read(record.data.data(), static_cast<std::streamsize>(record.data.size())))
+    {
+        _isValid = false;
+        return std::nullopt;
+    }
+    return record;
+}
+
+void collapseRuns(std::vector<Record>& records)
+{
+    std::chrono::nanoseconds shift{};
+    for (std::size_t i = 1; i < records.size(); ++i)
+    {
+        // Records of one run are shifted together, so their intervals stay the same.
+        if (records[i].event == Event::RUN_STARTED)
+        {
+            shift = records[i - 1].time - records[i].time;
+        }
+        records[i].time += shift;
+    }
+}
+
+} // namespace capture
@@ -0,0 +1,189 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+/**
+ * \brief Additional namespace to record and replay network traffic.
+ */
+namespace capture
+{
+
+/**
+ * \brief Array of events which are written to capture file.
+ */
+enum class Event : std::uint8_t
+{
+    CLIENT_CONNECTED    = 0,
+    CLIENT_DISCONNECTED = 1,
+    FROM_CLIENT         = 2,
+    TO_CLIENT           = 3,
+    FROM_ROBOT          = 4,
+    TO_ROBOT            = 5,
+    RUN_STARTED         = 6
+};
+
+/**
+ * \brief Value which starts every capture file, the last digits are version of format.
+ */
+constexpr std::string_view FILE_MAGIC = "VCAP0001";
+
+/**
+ * \brief Size of record header: time (8), event (1), reserved (1), robot (2), session (4),
+ *        length (4), all little-endian.
+ */
+constexpr std::size_t      RECORD_HEADER_SIZE = 20;
+
+
+/**
+ * \brief Structure which keeps one captured event.
+ */
+struct Record
+{
+    /**
+     * \brief Time of event in nanoseconds since epoch (monotonic inside one run, the next run
+     *        in the same file may start hours later).
+     */
+    std::chrono::nanoseconds    time{};
+
+    /**
+     * \brief Type of event.
+     */
+    Event                       event = Event::FROM_CLIENT;
+
+    /**
+     * \brief Index of robot which traffic belongs to.
+     */
+    std::uint16_t               robotId = 0;
+
+    /**
+     * \brief Session of client or zero for traffic of robot.
+     */
+    std::uint32_t               sessionId = 0;
+
+    /**
+     * \brief Bytes exactly as they were read or written (layer port for CLIENT_CONNECTED).
+     */
+    std::string                 data;
+};
+
+
+/**
+ * \brief   Class used to append events to capture file from several threads.
+ * \details File is opened for appending, so several runs can be kept in one file, every run
+ *          starts with RUN_STARTED record. Record is written under lock as one piece, so
+ *          records of different threads never mix.
+ */
+class CaptureWriter
+{
+public:
+    /**
+     * \brief              Constructor which opens file, writes its header if file is new and
+     *                     marks start of run.
+     * \param[in] fileName File to append.
+     */
+    explicit        CaptureWriter(const std::string& fileName);
+
+    /**
+     * \brief  Check if file was opened.
+     * \return True if records are written.
+     */
+    bool            isOpen() const noexcept;
+
+    /**
+     * \brief               Append record with current time.
+     * \param[in] event     Type of event.
+     * \param[in] robotId   Index of robot.
+     * \param[in] sessionId Session of client or zero.
+     * \param[in] data      Bytes of event.
+     */
+    void            write(const Event event, const std::size_t robotId,
+                          const std::size_t sessionId, const std::string_view data);
+
+    /**
+     * \brief Write buffered records to file.
+     */
+    void            flush();
+
+
+private:
+    /**
+     * \brief Output file.
+     */
+    std::ofstream                           _file;
+
+    /**
+     * \brief Mutex used to write records from several threads.
+     */
+    std::mutex                              _mutex;
+
+    /**
+     * \brief Time of opening by wall clock, so different runs can be told apart.
+     */
+    std::chrono::nanoseconds                _startTime;
+
+    /**
+     * \brief Time of opening by monotonic clock, records are stamped relative to it.
+     */
+    std::chrono::steady_clock::time_point   _start;
+};
+
+
+/**
+ * \brief Class used to read capture file record by record.
+ */
+class CaptureReader
+{
+public:
+    /**
+     * \brief              Constructor which opens file and checks its header.
+     * \param[in] fileName File to read.
+     */
+    explicit        CaptureReader(const std::string& fileName);
+
+    /**
+     * \brief  Check if file is opened and has correct header.
+     * \return True if records can be read.
+     */
+    bool            isValid() const noexcept;
+
+    /**
+     * \brief  Read next record.
+     * \return Record or std::nullopt at the end of file or if record is broken.
+     */
+    std::optional<Record> next();
+
+
+private:
+    /**
+     * \brief Input file.
+     */
+    std::ifstream   _file;
+
+    /**
+     * \brief Flag which shows that file has correct header.
+     */
+    bool            _isValid;
+};
+
+
+/**
+ * \brief               Shift times of records, so every run starts right after the last record
+ *                      of previous run.
+ * \details             Pause between runs in one file can take hours, replay at original timing
+ *                      would wait for it. Intervals inside one run are kept.
+ * \param[out] records Records in order of file, runs are separated by RUN_STARTED records.
+ */
+void                collapseRuns(std::vector<Record>& records);
+
+} // namespace capture
+
+#endif // CAPTURE_H
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <limits>
+
+#include "Histogram.h"
+
+
+namespace stats
+{
+
+Histogram::Histogram() noexcept
+    : _buckets{},
+      _count(0),
+      _sum(0),
+      _min(std::numeric_limits<std::uint64_t>::max()),
+      _max(0)
+{
+}
+
+void Histogram::record(const std::chrono::microseconds value) noexcept
+{
+    record(static_cast<std::uint64_t>(std::max<long long>(0, value.count())));
+}
+
+void Histogram::record(const std::uint64_t sample) noexcept
+{
+    ++_buckets[getBucketIndex(sample)];
+    ++_count;
+    _sum += sample;
+    _min = std::min(_min, sample);
+    _max = std::max(_max, sample);
+}
+
+void Histogram::merge(const Histogram& other) noexcept
+{
+    for (std::size_t i = 0; i < NUMBER_OF_BUCKETS; ++i)
+    {
+        _buckets[i] += other._buckets[i];
+    }
+    _count += other._count;
+    _sum   += other._sum;
+    _min    = std::min(_min, other._min);
+    _max    = std::max(_max, other._max);
+}
+
+void Histogram::reset() noexcept
+{
+    *this = Histogram();
+}
+
+std::uint64_t Histogram::getCount() const noexcept
+{
+    return _count;
+}
+
+std::chrono::microseconds Histogram::getMin() const noexcept
+{
+    return std::chrono::microseconds(_count == 0 ? 0 : _min);
+}
+
+std::chrono::microseconds Histogram::getMax() const noexcept
+{
+    return std::chrono::microseconds(_max);
+}
+
+std::chrono::microseconds Histogram::getMean() const noexcept
+{
+    return std::chrono::microseconds(_count == 0 ? 0 : _sum / _count);
+}
+
+std::chrono::microseconds Histogram::getPercentile(const double quantile) const noexcept
+{
+    return std::chrono::microseconds(getPercentileValue(quantile));
+}
+
+std::uint64_t Histogram::getPercentileValue(const double quantile) const noexcept
+{
+    if (_count == 0)
+    {
+        return 0;
+    }
+
+    // Rank of sample counted from one, the smallest quantile still gives the first sample.
+    const double clamped = std::clamp(quantile, 0.0, 1.0);
+    const auto rank = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(clamped * static_cast<double>(_count) + 0.5));
+
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < NUMBER_OF_BUCKETS; ++i)
+    {
+        seen += _buckets[i];
+        if (seen >= rank)
+        {
+            const std::uint64_t upper = i + 1 < NUMBER_OF_BUCKETS
+                                      ? getLowerBound(i + 1) - 1
+                                      : std::numeric_limits<std::uint64_t>::max();
+            return std::clamp(upper, _min, _max);
+        }
+    }
+    return _max;
+}
+
+std::size_t Histogram::getBucketIndex(const std::uint64_t value) noexcept
+{
+    // Small values are kept exactly.
+    if (value < SUB_BUCKETS)
+    {
+        return static_cast<std::size_t>(value);
+    }
+
+    std::size_t exponent = 0;
+    for (std::uint64_t rest = value; rest > 1; rest >>= 1)
+    {
+        ++exponent;
+    }
+
+    // Exponent is at least 3 here, sub-bucket is given by 3 bits after the highest one.
+    const std::size_t subBucket = static_cast<std::size_t>(value >> (exponent - 3)) & 7;
+    return (exponent - 2) * SUB_BUCKETS + subBucket;
+}
+
+std::uint64_t Histogram::getLowerBound(const std::size_t index) noexcept
+{
+    if (index < SUB_BUCKETS)
+    {
+        return index;
+    }
+
+    const std::size_t exponent  = index / SUB_BUCKETS + 2;
+    const std::size_t subBucket = index % SUB_BUCKETS;
+    return static_cast<std::uint64_t>(SUB_BUCKETS + subBucket) << (exponent - 3);
+}
+
+} // namespace stats
@@ -0,0 +1,148 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+
+/**
+ * \brief Additional namespace for runtime statistics.
+ */
+namespace stats
+{
+
+/**
+ * \brief   Class used to collect distribution of latencies without storing samples.
+ * \details Buckets grow exponentially with 8 linear sub-buckets in every power of two, so
+ *          relative error of percentile is below 12.5% for any value and memory is fixed.
+ *          Any other non-negative integer values (e.g. velocities) can be collected too.
+ */
+class Histogram
+{
+public:
+    /**
+     * \brief Number of linear sub-buckets in every power of two.
+     */
+    static constexpr std::size_t SUB_BUCKETS = 8;
+
+    /**
+     * \brief Total number of buckets which cover all 64-bit values.
+     */
+    static constexpr std::size_t NUMBER_OF_BUCKETS = (64 - 2) * SUB_BUCKETS;
+
+
+    /**
+     * \brief Default constructor.
+     */
+                                Histogram() noexcept;
+
+    /**
+     * \brief           Add one sample.
+     * \param[in] value Measured latency.
+     */
+    void                        record(const std::chrono::microseconds value) noexcept;
+
+    /**
+     * \brief           Add one sample which is not a latency.
+     * \param[in] value Measured value.
+     */
+    void                        record(const std::uint64_t value) noexcept;
+
+    /**
+     * \brief           Add all samples of other histogram.
+     * \param[in] other Histogram to merge.
+     */
+    void                        merge(const Histogram& other) noexcept;
+
+    /**
+     * \brief Remove all samples.
+     */
+    void                        reset() noexcept;
+
+    /**
+     * \brief  Get number of samples.
+     * \return Number of recorded samples.
+     */
+    std::uint64_t               getCount() const noexcept;
+
+    /**
+     * \brief  Get the smallest sample.
+     * \return Minimal latency or zero if there are no samples.
+     */
+    std::chrono::microseconds   getMin() const noexcept;
+
+    /**
+     * \brief  Get the largest sample.
+     * \return Maximal latency or zero if there are no samples.
+     */
+    std::chrono::microseconds   getMax() const noexcept;
+
+    /**
+     * \brief  Get average of samples.
+     * \return Mean latency or zero if there are no samples.
+     */
+    std::chrono::microseconds   getMean() const noexcept;
+
+    /**
+     * \brief              Get value which given part of samples doesn't exceed.
+     * \param[in] quantile Part of samples in range [0, 1] (e.g. 0.99 for 99th percentile).
+     * \return             Upper bound of bucket which contains quantile or zero if there are no
+     *                     samples.
+     */
+    std::chrono::microseconds   getPercentile(const double quantile) const noexcept;
+
+    /**
+     * \brief              Get value which given part of samples doesn't exceed.
+     * \param[in] quantile Part of samples in range [0, 1].
+     * \return             Upper bound of bucket which contains quantile or zero if there are no
+     *                     samples.
+     */
+    std::uint64_t               getPercentileValue(const double quantile) const noexcept;
+
+
+private:
+    /**
+     * \brief Number of samples in every bucket.
+     */
+    std::array<std::uint64_t, NUMBER_OF_BUCKETS> _buckets;
+
+    /**
+     * \brief Number of samples.
+     */
+    std::uint64_t               _count;
+
+    /**
+     * \brief Sum of samples used for mean.
+     */
+    std::uint64_t               _sum;
+
+    /**
+     * \brief The smallest sample.
+     */
+    std::uint64_t               _min;
+
+    /**
+     * \brief The largest sample.
+     */
+    std::uint64_t               _max;
+
+
+    /**
+     * \brief           Get bucket which contains value.
+     * \param[in] value Value in microseconds.
+     * \return          Index of bucket.
+     */
+    static std::size_t          getBucketIndex(const std::uint64_t value) noexcept;
+
+    /**
+     * \brief           Get the smallest value of bucket.
+     * \param[in] index Index of bucket.
+     * \return          Lower bound in microseconds.
+     */
+    static std::uint64_t        getLowerBound(const std::size_t index) noexcept;
+};
+
+} // namespace stats
+
+#endif // HISTOGRAM_H
@@ -0,0 +1,177 @@
+#include <cassert>
+#include <utility>
+
+#include "InterpolationTable.h"
+
+#include "InterpolationGrid.h"
+
+
+namespace utils
+{
+
+InterpolationGrid::InterpolationGrid(std::vector<double> rows, std::vector<double> columns,
+                                     std::vector<double> values)
+    : _rowsStorage(std::move(rows)),
+      _columnsStorage(std::move(columns)),
+      _valuesStorage(std::move(values)),
+      _numberOfRows(_rowsStorage.size()),
+      _numberOfColumns(_columnsStorage.size())
+{
+    assert(_valuesStorage.size() == _numberOfRows * _numberOfColumns);
+    bindStorage();
+}
+
+InterpolationGrid::InterpolationGrid(const double* rows, const std::size_t numberOfRows,
+                                     const double* columns, const std::size_t numberOfColumns,
+                                     const double* values) noexcept
+    : _rows(rows),
+      _columns(columns),
+      _values(values),
+      _numberOfRows(numberOfRows),
+      _numberOfColumns(numberOfColumns)
+{
+}
+
+InterpolationGrid::InterpolationGrid(const InterpolationGrid& other)
+    : _rowsStorage(other._rowsStorage),
+      _columnsStorage(other._columnsStorage),
+      _valuesStorage(other._valuesStorage),
+      _rows(other._rows),
+      _columns(other._columns),
+      _values(other._values),
+      _numberOfRows(other._numberOfRows),
+      _numberOfColumns(other._numberOfColumns)
+{
+    bindStorage();
+}
+
+InterpolationGrid& InterpolationGrid::operator=(const InterpolationGrid& other)
+{
+    if (this != &other)
+    {
+        InterpolationGrid copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+double InterpolationGrid::evaluate(const double row, const double column) const noexcept
+{
+    if (empty())
+    {
+        return 0.0;
+    }
+
+    const Cell r = locate(_rows, _numberOfRows, row);
+    const Cell c = locate(_columns, _numberOfColumns, column);
+    const std::size_t width = _numberOfColumns;
+    const double* lower = &_values[r.index * width + c.index];
+
+    // Neighbours on the last row or column have zero weight, so they are never read.
+    const double right = c.weight > 0.0 ? lower[1] : lower[0];
+    const double bottom = r.weight > 0.0 ? lower[width] : lower[0];
+    const double corner = r.weight > 0.0 && c.weight > 0.0 ? lower[width + 1] : bottom;
+
+    const double top = lower[0] + c.weight * (right - lower[0]);
+    const double down = bottom + c.weight * (corner - bottom);
+    return top + r.weight * (down - top);
+}
+
+void InterpolationGrid::adapt(const double row, const double column, const double value,
+                              const double rate)
+{
+    if (empty())
+    {
+        return;
+    }
+
+    // External memory is shared by all copies, so it is never changed.
+    if (_valuesStorage.empty())
+    {
+        _valuesStorage.assign(_values, _values + _numberOfRows * _numberOfColumns);
+        _values = _valuesStorage.data();
+    }
+
+    const double residual = value - evaluate(row, column);
+    const Cell r = locate(_rows, _numberOfRows, row);
+    const Cell c = locate(_columns, _numberOfColumns, column);
+    const std::size_t width = _numberOfColumns;
+
+    const double rowWeights[] = { 1.0 - r.weight, r.weight };
+    const double columnWeights[] = { 1.0 - c.weight, c.weight };
+    for (std::size_t i = 0; i < 2; ++i)
+    {
+        for (std::size_t j = 0; j < 2; ++j)
+        {
+            const double weight = rowWeights[i] * columnWeights[j];
+            if (weight > 0.0)
+            {
+                _valuesStorage[(r.index + i) * width + c.index + j] += rate * weight * residual;
+            }
+        }
+    }
+}
+
+bool InterpolationGrid::empty() const noexcept
+{
+    return _numberOfRows == 0 || _numberOfColumns == 0;
+}
+
+std::size_t InterpolationGrid::getNumberOfRows() const noexcept
+{
+    return _numberOfRows;
+}
+
+std::size_t InterpolationGrid::getNumberOfColumns() const noexcept
+{
+    return _numberOfColumns;
+}
+
+const double* InterpolationGrid::getRows() const noexcept
+{
+    return _rows;
+}
+
+const double* InterpolationGrid::getColumns() const noexcept
+{
+    return _columns;
+}
+
+const double* InterpolationGrid::getValues() const noexcept
+{
+    return _values;
+}
+
+void InterpolationGrid::bindStorage() noexcept
+{
+    if (!_rowsStorage.empty())
+    {
+        _rows = _rowsStorage.data();
+    }
+    if (!_columnsStorage.empty())
+    {
+        _columns = _columnsStorage.data();
+    }
+    if (!_valuesStorage.empty())
+    {
+        _values = _valuesStorage.data();
+    }
+}
+
+InterpolationGrid::Cell InterpolationGrid::locate(const double* arguments, const std::size_t size,
+                                                  const double argument) noexcept
+{
+    if (argument <= arguments[0])
+    {
+        return { 0, 0.0 };
+    }
+    if (argument >= arguments[size - 1])
+    {
+        return { size - 1, 0.0 };
+    }
+
+    const std::size_t index = findInterval(arguments, size, argument);
+    return { index, (argument - arguments[index]) / (arguments[index + 1] - arguments[index]) };
+}
+
+} // namespace utils
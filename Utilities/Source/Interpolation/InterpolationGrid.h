@@ -0,0 +1,216 @@
+#ifndef INTERPOLATION_GRID_H
+#define INTERPOLATION_GRID_H
+
+#include <cstddef>
+#include <vector>
+
+
+/**
+ * \brief Unique namespace for utilities functions.
+ */
+namespace utils
+{
+
+/**
+ * \brief   Table of values measured on rectangular grid of two arguments with bilinear
+ *          interpolation between them.
+ * \details Values are kept row by row in one contiguous array. Outside of measured range
+ *          arguments are clamped to the nearest row or column. Grid either owns its arrays or
+ *          uses external memory (e.g. mapped file) without copying; external values are copied
+ *          only when grid is changed.
+ */
+class InterpolationGrid
+{
+public:
+    /**
+     * \brief Default constructor which creates empty grid.
+     */
+                                InterpolationGrid() = default;
+
+    /**
+     * \brief             Constructor which copies measurements.
+     * \param[in] rows    Sorted unique arguments of rows.
+     * \param[in] columns Sorted unique arguments of columns.
+     * \param[in] values  Values row by row (size is product of sizes of arguments).
+     */
+                                InterpolationGrid(std::vector<double> rows,
+                                                  std::vector<double> columns,
+                                                  std::vector<double> values);
+
+    /**
+     * \brief                     Constructor which uses external memory, memory has to live
+     *                            longer than grid and all its copies.
+     * \param[in] rows            Sorted unique arguments of rows.
+     * \param[in] numberOfRows    Number of rows.
+     * \param[in] columns         Sorted unique arguments of columns.
+     * \param[in] numberOfColumns Number of columns.
+     * \param[in] values          Values row by row.
+     */
+                                InterpolationGrid(const double* rows,
+                                                  const std::size_t numberOfRows,
+                                                  const double* columns,
+                                                  const std::size_t numberOfColumns,
+                                                  const double* values) noexcept;
+
+    /**
+     * \brief           Copy constructor which copies own arrays and shares external ones.
+     * \param[in] other Other object.
+     */
+                                InterpolationGrid(const InterpolationGrid& other);
+
+    /**
+     * \brief           Default move constructor.
+     * \param[in] other Other object.
+     */
+                                InterpolationGrid(InterpolationGrid&& other) = default;
+
+    /**
+     * \brief           Copy assignment operator which copies own arrays and shares external
+     *                  ones.
+     * \param[in] other Other object.
+     * \return          Reference to this object.
+     */
+    InterpolationGrid&          operator=(const InterpolationGrid& other);
+
+    /**
+     * \brief           Default move assignment operator.
+     * \param[in] other Other object.
+     * \return          Reference to this object.
+     */
+    InterpolationGrid&          operator=(InterpolationGrid&& other) = default;
+
+    /**
+     * \brief            Calculate value for pair of arguments.
+     * \param[in] row    Argument of rows.
+     * \param[in] column Argument of columns.
+     * \return           Interpolated value or 0 if grid is empty.
+     */
+    double                      evaluate(const double row, const double column) const noexcept;
+
+    /**
+     * \brief            Move surface towards observed value without changing arguments.
+     * \details          Difference is shared between four surrounding measurements with the
+     *                   same weights as interpolation uses, so measurement observed exactly is
+     *                   updated as exponentially weighted moving average.
+     * \param[in] row    Observed argument of rows.
+     * \param[in] column Observed argument of columns.
+     * \param[in] value  Observed value.
+     * \param[in] rate   Weight of observation in range [0, 1].
+     */
+    void                        adapt(const double row, const double column, const double value,
+                                      const double rate);
+
+    /**
+     * \brief  Check if grid has no measurements.
+     * \return True if grid is empty.
+     */
+    bool                        empty() const noexcept;
+
+    /**
+     * \brief  Get number of rows.
+     * \return Number of arguments of rows.
+     */
+    std::size_t                 getNumberOfRows() const noexcept;
+
+    /**
+     * \brief  Get number of columns.
+     * \return Number of arguments of columns.
+     */
+    std::size_t                 getNumberOfColumns() const noexcept;
+
+    /**
+     * \brief  Get arguments of rows.
+     * \return Sorted arguments.
+     */
+    const double*               getRows() const noexcept;
+
+    /**
+     * \brief  Get arguments of columns.
+     * \return Sorted arguments.
+     */
+    const double*               getColumns() const noexcept;
+
+    /**
+     * \brief  Get values.
+     * \return Values row by row.
+     */
+    const double*               getValues() const noexcept;
+
+
+private:
+    /**
+     * \brief Position of argument between two measured ones.
+     */
+    struct Cell
+    {
+        /**
+         * \brief Index of the lower measured argument.
+         */
+        std::size_t index;
+
+        /**
+         * \brief Distance to the lower argument as part of interval in range [0, 1].
+         */
+        double      weight;
+    };
+
+    /**
+     * \brief Own arguments of rows (empty if external memory is used).
+     */
+    std::vector<double>         _rowsStorage;
+
+    /**
+     * \brief Own arguments of columns (empty if external memory is used).
+     */
+    std::vector<double>         _columnsStorage;
+
+    /**
+     * \brief Own values (empty if external memory is used and grid wasn't changed).
+     */
+    std::vector<double>         _valuesStorage;
+
+    /**
+     * \brief Sorted arguments of rows.
+     */
+    const double*               _rows = nullptr;
+
+    /**
+     * \brief Sorted arguments of columns.
+     */
+    const double*               _columns = nullptr;
+
+    /**
+     * \brief Values row by row.
+     */
+    const double*               _values = nullptr;
+
+    /**
+     * \brief Number of rows.
+     */
+    std::size_t                 _numberOfRows = 0;
+
+    /**
+     * \brief Number of columns.
+     */
+    std::size_t                 _numberOfColumns = 0;
+
+
+    /**
+     * \brief Point arrays to own storage where it's used.
+     */
+    void                        bindStorage() noexcept;
+
+    /**
+     * \brief               Find position of argument with clamping to measured range.
+     * \param[in] arguments Sorted arguments.
+     * \param[in] size      Number of arguments.
+     * \param[in] argument  Argument to find.
+     * \return              Position of argument (weight is zero on the last argument).
+     */
+    static Cell                 locate(const double* arguments, const std::size_t size,
+                                       const double argument) noexcept;
+};
+
+} // namespace utils
+
+#endif // INTERPOLATION_GRID_H
@@ -0,0 +1,188 @@
+#include <algorithm>
+
+#include "InterpolationTable.h"
+
+
+namespace utils
+{
+
+std::size_t findInterval(const double* arguments, const std::size_t size,
+                         const double argument) noexcept
+{
+    const double* base = arguments;
+    std::size_t length = size;
+    while (length > 1)
+    {
+        const std::size_t half = length / 2;
+        base = (base[half] <= argument) ? base + half : base;
+        length -= half;
+    }
+    return static_cast<std::size_t>(base - arguments);
+}
+
+InterpolationTable::InterpolationTable(std::vector<std::pair<double, double>> points,
+                                       const Method method)
+    : _method(method)
+{
+    std::stable_sort(points.begin(), points.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    _arguments.reserve(points.size());
+    _values.reserve(points.size());
+    for (std::size_t i = 0; i < points.size();)
+    {
+        // Repeated measurements of one argument are averaged.
+        std::size_t j = i;
+        double sum = 0.0;
+        for (; j < points.size() && points[j].first == points[i].first; ++j)
+        {
+            sum += points[j].second;
+        }
+
+        _arguments.push_back(points[i].first);
+        _values.push_back(sum / static_cast<double>(j - i));
+        i = j;
+    }
+
+    calculateTangents();
+}
+
+double InterpolationTable::evaluate(const double argument) const noexcept
+{
+    if (_arguments.empty())
+    {
+        return 0.0;
+    }
+    if (argument <= _arguments.front())
+    {
+        return _values.front();
+    }
+    if (argument >= _arguments.back())
+    {
+        return _values.back();
+    }
+
+    const std::size_t i = findInterval(_arguments.data(), _arguments.size(), argument);
+    const double width = _arguments[i + 1] - _arguments[i];
+    const double t = (argument - _arguments[i]) / width;
+
+    if (_method == Method::LINEAR)
+    {
+        return _values[i] + t * (_values[i + 1] - _values[i]);
+    }
+
+    // Cubic Hermite basis.
+    const double t2 = t * t;
+    const double t3 = t2 * t;
+    return (2.0 * t3 - 3.0 * t2 + 1.0) * _values[i]
+         + (t3 - 2.0 * t2 + t) * width * _tangents[i]
+         + (-2.0 * t3 + 3.0 * t2) * _values[i + 1]
+         + (t3 - t2) * width * _tangents[i + 1];
+}
+
+void InterpolationTable::adapt(const double argument, const double value,
+                               const double rate) noexcept
+{
+    if (_arguments.empty())
+    {
+        return;
+    }
+
+    const double residual = value - evaluate(argument);
+    std::size_t i = 0;
+    double t = 0.0;
+    if (argument >= _arguments.back())
+    {
+        i = _arguments.size() - 1;
+    }
+    else if (argument > _arguments.front())
+    {
+        i = findInterval(_arguments.data(), _arguments.size(), argument);
+        t = (argument - _arguments[i]) / (_arguments[i + 1] - _arguments[i]);
+    }
+
+    _values[i] += rate * (1.0 - t) * residual;
+    if (t > 0.0)
+    {
+        _values[i + 1] += rate * t * residual;
+    }
+
+    // Tangent depends only on neighbouring values, so only nearby ones are changed.
+    const std::size_t first = i > 0 ? i - 1 : 0;
+    const std::size_t last = std::min(i + 3, _arguments.size());
+    for (std::size_t j = first; j < last; ++j)
+    {
+        _tangents[j] = calculateTangent(j);
+    }
+}
+
+std::size_t InterpolationTable::size() const noexcept
+{
+    return _arguments.size();
+}
+
+bool InterpolationTable::empty() const noexcept
+{
+    return _arguments.empty();
+}
+
+InterpolationTable::Method InterpolationTable::getMethod() const noexcept
+{
+    return _method;
+}
+
+const std::vector<double>& InterpolationTable::getArguments() const noexcept
+{
+    return _arguments;
+}
+
+const std::vector<double>& InterpolationTable::getValues() const noexcept
+{
+    return _values;
+}
+
+void InterpolationTable::calculateTangents()
+{
+    _tangents.resize(_arguments.size());
+    for (std::size_t i = 0; i < _tangents.size(); ++i)
+    {
+        _tangents[i] = calculateTangent(i);
+    }
+}
+
+double InterpolationTable::calculateTangent(const std::size_t index) const noexcept
+{
+    const std::size_t size = _arguments.size();
+    if (size < 2)
+    {
+        return 0.0;
+    }
+
+    auto secant = [this](const std::size_t i)
+    {
+        return (_values[i + 1] - _values[i]) / (_arguments[i + 1] - _arguments[i]);
+    };
+    if (index == 0)
+    {
+        return secant(0);
+    }
+    if (index + 1 == size)
+    {
+        return secant(size - 2);
+    }
+
+    // Local extremum or flat part: curve has to stay flat, otherwise it overshoots.
+    const double leftSecant = secant(index - 1);
+    const double rightSecant = secant(index);
+    if (leftSecant * rightSecant <= 0.0)
+    {
+        return 0.0;
+    }
+
+    const double left = _arguments[index] - _arguments[index - 1];
+    const double right = _arguments[index + 1] - _arguments[index];
+    return 3.0 * (left + right)
+         / ((2.0 * right + left) / leftSecant + (right + 2.0 * left) / rightSecant);
+}
+
+} // namespace utils
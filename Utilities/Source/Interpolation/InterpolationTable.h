@@ -0,0 +1,143 @@
+#ifndef INTERPOLATION_TABLE_H
+#define INTERPOLATION_TABLE_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+
+/**
+ * \brief Unique namespace for utilities functions.
+ */
+namespace utils
+{
+
+/**
+ * \brief               Find interval of sorted arguments which contains argument.
+ * \details             Binary search without unpredictable branches: number of steps depends
+ *                      only on number of arguments.
+ * \param[in] arguments Sorted arguments.
+ * \param[in] size      Number of arguments, at least one.
+ * \param[in] argument  Argument inside of range of arguments.
+ * \return              Index of the last argument which is not greater than given one.
+ */
+std::size_t findInterval(const double* arguments, const std::size_t size,
+                         const double argument) noexcept;
+
+/**
+ * \brief   Table of measured values with interpolation between them.
+ * \details Arguments, values and tangents are kept in separate contiguous arrays, so search
+ *          touches only arguments. Outside of measured range result is clamped to the first or
+ *          the last value.
+ */
+class InterpolationTable
+{
+public:
+    /**
+     * \brief Array of methods used to calculate value between two arguments.
+     */
+    enum class Method
+    {
+        LINEAR,
+        MONOTONE_CUBIC
+    };
+
+
+    /**
+     * \brief            Constructor which sorts measurements and prepares tangents.
+     * \details          Values of equal arguments are replaced by their mean.
+     * \param[in] points Pairs of argument and value in any order.
+     * \param[in] method Method of interpolation.
+     */
+    explicit                    InterpolationTable(
+                                    std::vector<std::pair<double, double>> points = {},
+                                    const Method method = Method::MONOTONE_CUBIC);
+
+    /**
+     * \brief              Calculate value for argument.
+     * \param[in] argument Argument of table function.
+     * \return             Interpolated value or 0 if table is empty.
+     */
+    double                      evaluate(const double argument) const noexcept;
+
+    /**
+     * \brief              Move curve towards observed value without changing arguments.
+     * \details            Difference is shared between two neighbouring measurements in
+     *                     proportion to distance to them, so measurement observed exactly is
+     *                     updated as exponentially weighted moving average.
+     * \param[in] argument Observed argument.
+     * \param[in] value    Observed value.
+     * \param[in] rate     Weight of observation in range [0, 1].
+     */
+    void                        adapt(const double argument, const double value,
+                                      const double rate) noexcept;
+
+    /**
+     * \brief  Get number of different arguments.
+     * \return Size of table.
+     */
+    std::size_t                 size() const noexcept;
+
+    /**
+     * \brief  Check if table has no measurements.
+     * \return True if table is empty.
+     */
+    bool                        empty() const noexcept;
+
+    /**
+     * \brief  Get method of interpolation.
+     * \return Method used by evaluate.
+     */
+    Method                      getMethod() const noexcept;
+
+    /**
+     * \brief  Get sorted arguments.
+     * \return Arguments of table.
+     */
+    const std::vector<double>&  getArguments() const noexcept;
+
+    /**
+     * \brief  Get values in order of arguments.
+     * \return Values of table.
+     */
+    const std::vector<double>&  getValues() const noexcept;
+
+
+private:
+    /**
+     * \brief Method of interpolation.
+     */
+    Method                      _method;
+
+    /**
+     * \brief Sorted unique arguments.
+     */
+    std::vector<double>         _arguments;
+
+    /**
+     * \brief Values in order of arguments.
+     */
+    std::vector<double>         _values;
+
+    /**
+     * \brief Derivatives in table points (used only by cubic interpolation).
+     */
+    std::vector<double>         _tangents;
+
+
+    /**
+     * \brief  Calculate derivatives which keep interpolation monotone between measurements
+     *         (Fritsch-Butland formula).
+     */
+    void                        calculateTangents();
+
+    /**
+     * \brief           Calculate derivative in one table point.
+     * \param[in] index Index of table point.
+     * \return          Derivative which keeps interpolation monotone.
+     */
+    double                      calculateTangent(const std::size_t index) const noexcept;};
+
+} // namespace utils
+
+#endif // INTERPOLATION_TABLE_H
@@ -0,0 +1,133 @@
+#ifndef PATH_SIMPLIFIER_H
+#define PATH_SIMPLIFIER_H
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <type_traits>
+
+#include "RobotData/RobotData.h"
+
+
+/**
+ * \brief Unique namespace for utilities functions.
+ */
+namespace utils
+{
+
+/**
+ * \brief   Class used to remove redundant points from stream of points before they are sent to
+ *          robot.
+ * \details Streaming variant of Ramer-Douglas-Peucker: points after the last kept one (anchor)
+ *          are collected in window while every one of them lies within tolerance of segment
+ *          from anchor to the newest point. When new point breaks this, the previous point is
+ *          kept and becomes anchor, points between are removed. Position (x, y, z) and
+ *          orientation (w, p, r) are checked separately with the same interpolation parameter,
+ *          because robot turns tool proportionally to passed distance. Points with different
+ *          parameters (segtime, type of moving, start/stop) are never merged.
+ * \tparam T Type of points: vasily::RobotData or any type which has robotData member.
+ */
+template <class T>
+class PathSimplifier
+{
+public:
+    /**
+     * \brief                          Constructor which sets tolerances.
+     * \param[in] positionTolerance    Maximal deviation of position in units of RobotData.
+     * \param[in] orientationTolerance Maximal deviation of orientation in units of RobotData.
+     * \param[in] maxWindow            Maximal number of points which can be replaced by one
+     *                                 segment, so kept points are delayed for bounded time.
+     */
+                        PathSimplifier(const int positionTolerance,
+                                       const int orientationTolerance,
+                                       const std::size_t maxWindow);
+
+    /**
+     * \brief           Add next point of stream.
+     * \param[in] value Point to add.
+     * \return          Point which should be sent or std::nullopt if nothing is ready yet.
+     */
+    std::optional<T>    push(T value);
+
+    /**
+     * \brief  Release the last collected point (e.g. at the end of program).
+     * \return Point which should be sent or std::nullopt if there is nothing to release.
+     */
+    std::optional<T>    flush();
+
+    /**
+     * \brief Forget anchor, so the next point is never merged with previous ones.
+     */
+    void                reset();
+
+    /**
+     * \brief  Check if some points wait for release.
+     * \return True if window is empty.
+     */
+    bool                empty() const noexcept;
+
+    /**
+     * \brief  Get number of removed points since construction.
+     * \return Number of points.
+     */
+    std::uint64_t       getRemoved() const noexcept;
+
+
+private:
+    /**
+     * \brief Maximal deviation of position.
+     */
+    double                  _positionTolerance;
+
+    /**
+     * \brief Maximal deviation of orientation.
+     */
+    double                  _orientationTolerance;
+
+    /**
+     * \brief Maximal number of points in window.
+     */
+    std::size_t             _maxWindow;
+
+    /**
+     * \brief The last kept point or std::nullopt if stream has just started.
+     */
+    std::optional<T>        _anchor;
+
+    /**
+     * \brief Points after anchor which can still be removed.
+     */
+    std::deque<T>           _window;
+
+    /**
+     * \brief Number of removed points.
+     */
+    std::uint64_t           _removed;
+
+
+    /**
+     * \brief           Get coordinates of point.
+     * \param[in] value Point.
+     * \return          Reference to RobotData of point.
+     */
+    static const vasily::RobotData& getData(const T& value) noexcept;
+
+    /**
+     * \brief          Check that all points in window lie within tolerance of segment.
+     * \param[in] last The end of segment which starts at anchor.
+     * \return         True if last point can replace window.
+     */
+    bool                isWindowCovered(const vasily::RobotData& last) const;
+
+    /**
+     * \brief  Keep the last point of window and remove the others.
+     * \return Kept point.
+     */
+    std::optional<T>    closeWindow();
+};
+
+#include "PathSimplifier.inl"
+
+} // namespace utils
+
+#endif // PATH_SIMPLIFIER_H
@@ -0,0 +1,160 @@
+#ifndef PATH_SIMPLIFIER_INL
+#define PATH_SIMPLIFIER_INL
+
+#include <algorithm>
+#include <cmath>
+
+
+template <class T>
+PathSimplifier<T>::PathSimplifier(const int positionTolerance, const int orientationTolerance,
+                                  const std::size_t maxWindow)
+    : _positionTolerance(std::max(0, positionTolerance)),
+      _orientationTolerance(std::max(0, orientationTolerance)),
+      _maxWindow(std::max<std::size_t>(1, maxWindow)),
+      _anchor(),
+      _window(),
+      _removed(0)
+{
+}
+
+template <class T>
+std::optional<T> PathSimplifier<T>::push(T value)
+{
+    // The first point has nothing to be merged with.
+    if (!_anchor.has_value())
+    {
+        _anchor.emplace(value);
+        return value;
+    }
+
+    const vasily::RobotData& data = getData(value);
+    const vasily::RobotData& previous = _window.empty() ? getData(*_anchor)
+                                                        : getData(_window.back());
+    if (_window.empty()
+        || (_window.size() < _maxWindow && data.parameters == previous.parameters
+            && isWindowCovered(data)))
+    {
+        _window.push_back(std::move(value));
+        return std::nullopt;
+    }
+
+    // New point bends path, so previous one is a corner and has to be kept.
+    std::optional<T> result = closeWindow();
+    _window.push_back(std::move(value));
+    return result;
+}
+
+template <class T>
+std::optional<T> PathSimplifier<T>::flush()
+{
+    return closeWindow();
+}
+
+template <class T>
+void PathSimplifier<T>::reset()
+{
+    _anchor.reset();
+    _window.clear();
+}
+
+template <class T>
+bool PathSimplifier<T>::empty() const noexcept
+{
+    return _window.empty();
+}
+
+template <class T>
+std::uint64_t PathSimplifier<T>::getRemoved() const noexcept
+{
+    return _removed;
+}
+
+template <class T>
+const vasily::RobotData& PathSimplifier<T>::getData(const T& value) noexcept
+{
+    if constexpr (std::is_same_v<T, vasily::RobotData>)
+    {
+        return value;
+    }
+    else
+    {
+        return value.robotData;
+    }
+}
+
+template <class T>
+bool PathSimplifier<T>::isWindowCovered(const vasily::RobotData& last) const
+{
+    constexpr std::size_t kAxes = 3;
+
+    const vasily::RobotData& first = getData(*_anchor);
+
+    // Segment is parametrized by position, pure rotation is parametrized by orientation.
+    std::array<double, vasily::RobotData::NUMBER_OF_COORDINATES> direction{};
+    for (std::size_t i = 0; i < direction.size(); ++i)
+    {
+        direction[i] = static_cast<double>(last.coordinates[i]) - first.coordinates[i];
+    }
+    double positionLength = 0.0;
+    double orientationLength = 0.0;
+    for (std::size_t i = 0; i < kAxes; ++i)
+    {
+        positionLength += direction[i] * direction[i];
+        orientationLength += direction[i + kAxes] * direction[i + kAxes];
+    }
+    const std::size_t parameterAxis = positionLength > 0.0 ? 0 : kAxes;
+    const double length = positionLength > 0.0 ? positionLength : orientationLength;
+
+    for (const T& value : _window)
+    {
+        const vasily::RobotData& point = getData(value);
+
+        // Projection is clamped, so point behind either end of segment is a real turn back.
+        double t = 0.0;
+        if (length > 0.0)
+        {
+            for (std::size_t i = parameterAxis; i < parameterAxis + kAxes; ++i)
+            {
+                t += (static_cast<double>(point.coordinates[i]) - first.coordinates[i])
+                     * direction[i];
+            }
+            t = std::clamp(t / length, 0.0, 1.0);
+        }
+
+        double positionDeviation = 0.0;
+        double orientationDeviation = 0.0;
+        for (std::size_t i = 0; i < kAxes; ++i)
+        {
+            const double position = point.coordinates[i] - (first.coordinates[i]
+                                                            + t * direction[i]);
+            const double orientation = point.coordinates[i + kAxes]
+                                       - (first.coordinates[i + kAxes]
+                                          + t * direction[i + kAxes]);
+            positionDeviation += position * position;
+            orientationDeviation += orientation * orientation;
+        }
+
+        if (std::sqrt(positionDeviation) > _positionTolerance
+            || std::sqrt(orientationDeviation) > _orientationTolerance)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class T>
+std::optional<T> PathSimplifier<T>::closeWindow()
+{
+    if (_window.empty())
+    {
+        return std::nullopt;
+    }
+
+    _removed += _window.size() - 1;
+    _anchor.emplace(std::move(_window.back()));
+    _window.clear();
+    return _anchor;
+}
+
+#endif // PATH_SIMPLIFIER_INL
@@ -0,0 +1,256 @@
+#ifndef ANSWER_WINDOW_H
+#define ANSWER_WINDOW_H
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Message.h"
+
+
+/**
+ * \brief Additional namespace to work with messages on the wire.
+ */
+namespace protocol
+{
+
+/**
+ * \brief   Class used to keep points which were sent to robot and match answers to them.
+ * \details Binary answer carries number of its point. Text answer has no number, robot answers
+ *          points in order of sending and answer contains reached point. Text point which
+ *          answer timed out leaves window but its late answer is still expected (overdue
+ *          point), it is matched only when answer contains its coordinates. Overdue point
+ *          which isn't answered until its deadline or is pushed out by newer overdue points is
+ *          lost, its answer will never be matched.
+ * \tparam T Type of sent points.
+ */
+template <class T>
+class AnswerWindow
+{
+public:
+    /**
+     * \brief Clock used for deadlines of overdue points.
+     */
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * \brief Point which answer was received.
+     */
+    struct Completion
+    {
+        /**
+         * \brief Answered point.
+         */
+        T                       value;
+
+        /**
+         * \brief Answer came after point timed out.
+         */
+        bool                    isOverdue;
+    };
+
+
+    /**
+     * \brief                     Constructor which sets limits.
+     * \param[in] size            Maximum number of points which wait for answer in window.
+     * \param[in] overdueCapacity Maximum number of overdue points.
+     */
+                                AnswerWindow(const std::size_t size,
+                                             const std::size_t overdueCapacity);
+
+    /**
+     * \brief                    Set if link has no delimiters between messages.
+     * \details                  Unterminated link can't separate two messages written one after
+     *                           another, so the next point is sent only when answer of previous
+     *                           one is received or given up (window of one point, overdue point
+     *                           is counted too).
+     * \param[in] isUnterminated True for link without delimiters.
+     */
+    void                        setUnterminated(const bool isUnterminated) noexcept;
+
+    /**
+     * \brief  Check if one more point can be sent.
+     * \return True if window isn't full.
+     */
+    bool                        hasPlace() const noexcept;
+
+    /**
+     * \brief              Add sent point.
+     * \param[in] value    Sent point.
+     * \param[in] sequence Number of message with point.
+     * \param[in] point    Coordinates of point or std::nullopt if point was sent without
+     *                     parsing (such point can't be matched by coordinates).
+     */
+    void                        push(T value, const std::uint32_t sequence,
+                                     const std::optional<vasily::RobotData>& point);
+
+    /**
+     * \brief  Check if window is empty (overdue points aren't counted).
+     * \return True if no point waits for answer in time.
+     */
+    bool                        empty() const noexcept;
+
+    /**
+     * \brief  Get number of points in window (overdue points aren't counted).
+     * \return Number of points.
+     */
+    std::size_t                 size() const noexcept;
+
+    /**
+     * \brief  Get the oldest point in window.
+     * \return Reference to point.
+     */
+    const T&                    front() const;
+
+    /**
+     * \brief  Get the newest point in window.
+     * \return Reference to point.
+     */
+    const T&                    back() const;
+
+    /**
+     * \brief              Release the oldest point which answer didn't come in time.
+     * \param[in] isText   Answers have no numbers, so the point becomes overdue.
+     * \param[in] deadline Time when overdue point is lost.
+     */
+    void                        timeOut(const bool isText, const Clock::time_point deadline);
+
+    /**
+     * \brief         Lose overdue points which deadline passed.
+     * \param[in] now Current time.
+     */
+    void                        expireOverdue(const Clock::time_point now);
+
+    /**
+     * \brief  Get the nearest deadline of overdue points.
+     * \return Deadline or std::nullopt if there are no overdue points.
+     */
+    std::optional<Clock::time_point> getOverdueDeadline() const;
+
+    /**
+     * \brief  Get number of overdue points.
+     * \return Number of points.
+     */
+    std::size_t                 getOverdueCount() const noexcept;
+
+    /**
+     * \brief            Find point of text answer.
+     * \details          Answer which contains coordinates of overdue point belongs to it, overdue
+     *                   points sent before it are lost. Any other answer belongs to the oldest
+     *                   point in window and all overdue points are lost, because robot answers
+     *                   in order. Answer without coordinates can't be checked, it belongs to the
+     *                   oldest point (overdue one first).
+     * \param[in] answer Received line.
+     * \return           Answered point or std::nullopt if no point waits for answer.
+     */
+    std::optional<Completion>   completeText(const std::string& answer);
+
+    /**
+     * \brief              Find point of binary answer.
+     * \details            Points sent before answered one will never be answered, they are
+     *                     released.
+     * \param[in] sequence Number of answered message.
+     * \return             Answered point or std::nullopt if there is no point with number.
+     */
+    std::optional<Completion>   completeBinary(const std::uint32_t sequence);
+
+    /**
+     * \brief  Take points which answers will never be matched since last call.
+     * \return Lost points in order of sending.
+     */
+    std::vector<T>              takeLost();
+
+    /**
+     * \brief  Take all points in window (e.g. to send them again), overdue and lost points are
+     *         forgotten.
+     * \return Points in order of sending.
+     */
+    std::deque<T>               takeAll();
+
+
+private:
+    /**
+     * \brief Sent point with data used to match answer.
+     */
+    struct Entry
+    {
+        /**
+         * \brief Sent point.
+         */
+        T                                   value;
+
+        /**
+         * \brief Number of message with point.
+         */
+        std::uint32_t                       sequence;
+
+        /**
+         * \brief Coordinates of point (std::nullopt if point wasn't parsed).
+         */
+        std::optional<vasily::RobotData>    point;
+
+        /**
+         * \brief Time when overdue point is lost.
+         */
+        Clock::time_point                   deadline;
+    };
+
+
+    /**
+     * \brief Maximum number of points in window.
+     */
+    std::size_t             _size;
+
+    /**
+     * \brief Maximum number of overdue points.
+     */
+    std::size_t             _overdueCapacity;
+
+    /**
+     * \brief Link has no delimiters between messages.
+     */
+    bool                    _isUnterminated;
+
+    /**
+     * \brief Points which wait for answer (in order of sending).
+     */
+    std::deque<Entry>       _points;
+
+    /**
+     * \brief Points which answer timed out but still can come (in order of sending).
+     */
+    std::deque<Entry>       _overduePoints;
+
+    /**
+     * \brief Points which answers will never be matched.
+     */
+    std::vector<T>          _lost;
+
+
+    /**
+     * \brief           Lose the oldest overdue points.
+     * \param[in] count Number of points to lose.
+     */
+    void                    loseOverdue(const std::size_t count);
+
+    /**
+     * \brief             Check if answer contains coordinates of point.
+     * \param[in] entry   Sent point.
+     * \param[in] reached Point from answer.
+     * \return            True if coordinates are the same.
+     */
+    static bool             isReached(const Entry& entry, const vasily::RobotData& reached);
+};
+
+#include "AnswerWindow.inl"
+
+} // namespace protocol
+
+#endif // ANSWER_WINDOW_H
@@ -0,0 +1,200 @@
+#ifndef ANSWER_WINDOW_INL
+#define ANSWER_WINDOW_INL
+
+template <class T>
+AnswerWindow<T>::AnswerWindow(const std::size_t size, const std::size_t overdueCapacity)
+    : _size(std::max<std::size_t>(1, size)),
+      _overdueCapacity(std::max<std::size_t>(1, overdueCapacity)),
+      _isUnterminated(false),
+      _points(),
+      _overduePoints(),
+      _lost()
+{
+}
+
+template <class T>
+void AnswerWindow<T>::setUnterminated(const bool isUnterminated) noexcept
+{
+    _isUnterminated = isUnterminated;
+}
+
+template <class T>
+bool AnswerWindow<T>::hasPlace() const noexcept
+{
+    if (_isUnterminated)
+    {
+        return _points.empty() && _overduePoints.empty();
+    }
+    return _points.size() < _size;
+}
+
+template <class T>
+void AnswerWindow<T>::push(T value, const std::uint32_t sequence,
+                           const std::optional<vasily::RobotData>& point)
+{
+    _points.push_back({ std::move(value), sequence, point, Clock::time_point() });
+}
+
+template <class T>
+bool AnswerWindow<T>::empty() const noexcept
+{
+    return _points.empty();
+}
+
+template <class T>
+std::size_t AnswerWindow<T>::size() const noexcept
+{
+    return _points.size();
+}
+
+template <class T>
+const T& AnswerWindow<T>::front() const
+{
+    assert(!_points.empty());
+    return _points.front().value;
+}
+
+template <class T>
+const T& AnswerWindow<T>::back() const
+{
+    assert(!_points.empty());
+    return _points.back().value;
+}
+
+template <class T>
+void AnswerWindow<T>::timeOut(const bool isText, const Clock::time_point deadline)
+{
+    if (_points.empty())
+    {
+        return;
+    }
+
+    // Binary answer finds its point by number, so late answer is simply not matched.
+    if (isText)
+    {
+        if (_overduePoints.size() >= _overdueCapacity)
+        {
+            loseOverdue(1);
+        }
+        _overduePoints.push_back(std::move(_points.front()));
+        _overduePoints.back().deadline = deadline;
+    }
+    _points.pop_front();
+}
+
+template <class T>
+void AnswerWindow<T>::expireOverdue(const Clock::time_point now)
+{
+    // Points became overdue in order of sending, so their deadlines are ordered too.
+    const auto it = std::find_if(_overduePoints.begin(), _overduePoints.end(),
+                                 [now](const Entry& entry) { return entry.deadline > now; });
+    loseOverdue(static_cast<std::size_t>(std::distance(_overduePoints.begin(), it)));
+}
+
+template <class T>
+std::optional<typename AnswerWindow<T>::Clock::time_point>
+AnswerWindow<T>::getOverdueDeadline() const
+{
+    if (_overduePoints.empty())
+    {
+        return std::nullopt;
+    }
+    return _overduePoints.front().deadline;
+}
+
+template <class T>
+std::size_t AnswerWindow<T>::getOverdueCount() const noexcept
+{
+    return _overduePoints.size();
+}
+
+template <class T>
+std::optional<typename AnswerWindow<T>::Completion> AnswerWindow<T>::completeText(
+    const std::string& answer)
+{
+    const auto reached = parseTextAnswer(answer);
+    if (reached.has_value() && !_overduePoints.empty())
+    {
+        const auto it = std::find_if(_overduePoints.begin(), _overduePoints.end(),
+                                     [&reached](const Entry& entry)
+                                     {
+                                         return isReached(entry, *reached);
+                                     });
+        // Answer of later point means that answers of all previous points are lost.
+        loseOverdue(static_cast<std::size_t>(std::distance(_overduePoints.begin(), it)));
+    }
+
+    if (!_overduePoints.empty())
+    {
+        Completion completion{ std::move(_overduePoints.front().value), true };
+        _overduePoints.pop_front();
+        return completion;
+    }
+
+    if (_points.empty())
+    {
+        return std::nullopt;
+    }
+
+    Completion completion{ std::move(_points.front().value), false };
+    _points.pop_front();
+    return completion;
+}
+
+template <class T>
+std::optional<typename AnswerWindow<T>::Completion> AnswerWindow<T>::completeBinary(
+    const std::uint32_t sequence)
+{
+    const auto it = std::find_if(_points.begin(), _points.end(),
+                                 [sequence](const Entry& entry)
+                                 {
+                                     return entry.sequence == sequence;
+                                 });
+    if (it == _points.end())
+    {
+        return std::nullopt;
+    }
+
+    // Robot executes points in order, so points before answered one will never be answered.
+    Completion completion{ std::move(it->value), false };
+    _points.erase(_points.begin(), std::next(it));
+    return completion;
+}
+
+template <class T>
+std::vector<T> AnswerWindow<T>::takeLost()
+{
+    return std::exchange(_lost, {});
+}
+
+template <class T>
+std::deque<T> AnswerWindow<T>::takeAll()
+{
+    std::deque<T> values;
+    for (Entry& entry : _points)
+    {
+        values.push_back(std::move(entry.value));
+    }
+    _points.clear();
+    _overduePoints.clear();
+    _lost.clear();
+    return values;
+}
+
+template <class T>
+void AnswerWindow<T>::loseOverdue(const std::size_t count)
+{
+    for (std::size_t i = 0; i < count && !_overduePoints.empty(); ++i)
+    {
+        _lost.push_back(std::move(_overduePoints.front().value));
+        _overduePoints.pop_front();
+    }
+}
+
+template <class T>
+bool AnswerWindow<T>::isReached(const Entry& entry, const vasily::RobotData& reached)
+{
+    return entry.point.has_value() && entry.point->coordinates == reached.coordinates;
+}
+
+#endif // ANSWER_WINDOW_INL
@@ -0,0 +1,197 @@
+#include <algorithm>
+
+#include "Framer.h"
+
+
+namespace protocol
+{
+
+Framer::Framer(const std::size_t maxMessageSize) noexcept
+    : _begin(0),
+      _scanned(0),
+      _maxMessageSize(maxMessageSize),
+      _droppedMessages(0),
+      _isSkipping(false),
+      _bytesToSkip(0),
+      _format(WireFormat::TEXT)
+{
+}
+
+std::string Framer::frame(const std::string_view message)
+{
+    std::string result;
+    result.reserve(message.size() + 1);
+    result.append(message);
+    result.push_back(DELIMITER);
+    return result;
+}
+
+void Framer::append(const std::string_view data)
+{
+    compact();
+    _buffer.append(data);
+}
+
+std::optional<std::string> Framer::nextMessage()
+{
+    if (_format == WireFormat::BINARY)
+    {
+        return nextBinaryMessage();
+    }
+    return nextTextMessage();
+}
+
+std::optional<std::string> Framer::nextTextMessage()
+{
+    while (true)
+    {
+        // Don't scan the same bytes twice if message comes in many small pieces.
+        const std::size_t position = _buffer.find(DELIMITER, _scanned);
+        if (position == std::string::npos)
+        {
+            _scanned = _buffer.size();
+
+            // Oversized message is thrown away piece by piece, so buffer doesn't grow forever.
+            if (!_isSkipping && _scanned - _begin > _maxMessageSize)
+            {
+                ++_droppedMessages;
+                _isSkipping = true;
+            }
+            if (_isSkipping)
+            {
+                _begin = _scanned;
+            }
+            return std::nullopt;
+        }
+
+        const std::size_t begin = _begin;
+        _begin   = position + 1;
+        _scanned = _begin;
+
+        if (_isSkipping)
+        {
+            _isSkipping = false;
+            continue;
+        }
+
+        if (position - begin > _maxMessageSize)
+        {
+            ++_droppedMessages;
+            continue;
+        }
+
+        // Tolerate peers which terminate lines with "\r\n".
+        std::size_t end = position;
+        if (end > begin && _buffer[end - 1] == '\r')
+        {
+            --end;
+        }
+        return _buffer.substr(begin, end - begin);
+    }
+}
+
+std::optional<std::string> Framer::nextBinaryMessage()
+{
+    while (true)
+    {
+        if (_bytesToSkip > 0)
+        {
+            const std::size_t skipped = std::min(_bytesToSkip, _buffer.size() - _begin);
+            _begin       += skipped;
+            _bytesToSkip -= skipped;
+            if (_bytesToSkip > 0)
+            {
+                return std::nullopt;
+            }
+        }
+
+        const std::string_view rest = std::string_view(_buffer).substr(_begin);
+        if (rest.size() < HEADER_SIZE)
+        {
+            return std::nullopt;
+        }
+
+        const auto frameSize = getFrameSize(rest);
+        if (!frameSize.has_value())
+        {
+            // Stream is broken and there is no way to find next message boundary reliably.
+            ++_droppedMessages;
+            _begin = _buffer.size();
+            return std::nullopt;
+        }
+
+        if (*frameSize - HEADER_SIZE > _maxMessageSize)
+        {
+            ++_droppedMessages;
+            _bytesToSkip = *frameSize;
+            continue;
+        }
+
+        if (rest.size() < *frameSize)
+        {
+            return std::nullopt;
+        }
+
+        _begin += *frameSize;
+        return std::string(rest.substr(0, *frameSize));
+    }
+}
+
+std::vector<std::string> Framer::extractMessages()
+{
+    std::vector<std::string> result;
+    while (auto message = nextMessage())
+    {
+        result.emplace_back(std::move(*message));
+    }
+    return result;
+}
+
+WireFormat Framer::getFormat() const noexcept
+{
+    return _format;
+}
+
+void Framer::setFormat(const WireFormat format) noexcept
+{
+    _format     = format;
+    _scanned    = _begin;
+    _isSkipping = false;
+}
+
+std::size_t Framer::getBufferedSize() const noexcept
+{
+    return _buffer.size() - _begin;
+}
+
+std::size_t Framer::getDroppedMessages() const noexcept
+{
+    return _droppedMessages;
+}
+
+void Framer::reset() noexcept
+{
+    _buffer.clear();
+    _begin       = 0;
+    _scanned     = 0;
+    _isSkipping  = false;
+    _bytesToSkip = 0;
+    _format      = WireFormat::TEXT;
+}
+
+void Framer::compact()
+{
+    if (_begin == 0)
+    {
+        return;
+    }
+
+    if (_begin == _buffer.size() || _begin > _buffer.size() / 2)
+    {
+        _buffer.erase(0, _begin);
+        _scanned = std::max(_scanned, _begin) - _begin;
+        _begin   = 0;
+    }
+}
+
+} // namespace protocol
@@ -0,0 +1,165 @@
+#ifndef FRAMER_H
+#define FRAMER_H
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Message.h"
+
+
+/**
+ * \brief Additional namespace to work with messages on the wire.
+ */
+namespace protocol
+{
+
+/**
+ * \brief   Class used to cut continuous socket stream into messages.
+ * \details In text format every message is terminated by delimiter, in binary format message
+ *          size is taken from its header. Data may come in any pieces (TCP splits and merges
+ *          them), so framer keeps incomplete tail until the rest arrives. One framer should be
+ *          used per socket.
+ */
+class Framer
+{
+public:
+    /**
+     * \brief Character which terminates every message.
+     */
+    static constexpr char        DELIMITER = '\n';
+
+    /**
+     * \brief Default limit of one message size, bigger messages are dropped.
+     */
+    static constexpr std::size_t DEFAULT_MAX_MESSAGE_SIZE = 64 * 1024;
+
+
+    /**
+     * \brief                    Constructor.
+     * \param[in] maxMessageSize Limit of one message size without delimiter.
+     */
+    explicit                    Framer(const std::size_t maxMessageSize
+                                           = DEFAULT_MAX_MESSAGE_SIZE) noexcept;
+
+    /**
+     * \brief             Add delimiter to message to send it.
+     * \param[in] message Message to frame.
+     * \return            Data ready to be written to socket.
+     */
+    static std::string          frame(const std::string_view message);
+
+    /**
+     * \brief          Add received data to the end of stream.
+     * \param[in] data Piece of data received from socket.
+     */
+    void                        append(const std::string_view data);
+
+    /**
+     * \brief  Extract next complete message from stream.
+     * \return Message without delimiter (text format), header with payload (binary format) or
+     *         std::nullopt if there is no complete message yet.
+     */
+    std::optional<std::string>  nextMessage();
+
+    /**
+     * \brief  Extract all complete messages from stream.
+     * \return Messages in order of arrival (may be empty).
+     */
+    std::vector<std::string>    extractMessages();
+
+    /**
+     * \brief  Get format of messages which framer expects.
+     * \return Current format.
+     */
+    WireFormat                  getFormat() const noexcept;
+
+    /**
+     * \brief            Change format of messages, data which was not extracted yet is parsed
+     *                   in new format.
+     * \param[in] format Format of next messages.
+     */
+    void                        setFormat(const WireFormat format) noexcept;
+
+    /**
+     * \brief  Get size of data which doesn't form complete message yet.
+     * \return Number of buffered bytes.
+     */
+    std::size_t                 getBufferedSize() const noexcept;
+
+    /**
+     * \brief  Get number of messages dropped because they exceeded limit or were broken.
+     * \return Number of dropped messages.
+     */
+    std::size_t                 getDroppedMessages() const noexcept;
+
+    /**
+     * \brief Clear parse state and return to text format (e.g. after socket reconnection).
+     */
+    void                        reset() noexcept;
+
+
+private:
+    /**
+     * \brief Received data, consumed part is removed lazily.
+     */
+    std::string _buffer;
+
+    /**
+     * \brief Position of the first byte which doesn't belong to extracted messages.
+     */
+    std::size_t _begin;
+
+    /**
+     * \brief Position up to which buffer was already scanned for delimiter.
+     */
+    std::size_t _scanned;
+
+    /**
+     * \brief Limit of one message size without delimiter.
+     */
+    std::size_t _maxMessageSize;
+
+    /**
+     * \brief Number of messages dropped because they exceeded limit.
+     */
+    std::size_t _droppedMessages;
+
+    /**
+     * \brief Oversized message is skipped until its delimiter arrives.
+     */
+    bool        _isSkipping;
+
+    /**
+     * \brief Number of bytes of oversized binary message which are still to be skipped.
+     */
+    std::size_t _bytesToSkip;
+
+    /**
+     * \brief Format of messages which framer expects.
+     */
+    WireFormat  _format;
+
+
+    /**
+     * \brief  Extract next message terminated by delimiter.
+     * \return Message without delimiter or std::nullopt if there is no complete message yet.
+     */
+    std::optional<std::string> nextTextMessage();
+
+    /**
+     * \brief  Extract next message which size is taken from its header.
+     * \return Header and payload or std::nullopt if there is no complete message yet.
+     */
+    std::optional<std::string> nextBinaryMessage();
+
+    /**
+     * \brief Remove consumed part of buffer if it takes most of it.
+     */
+    void compact();
+};
+
+} // namespace protocol
+
+#endif // FRAMER_H
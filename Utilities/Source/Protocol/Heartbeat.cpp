@@ -0,0 +1,64 @@
+#include "Heartbeat.h"
+
+
+namespace protocol
+{
+
+Heartbeat::Heartbeat(const std::size_t maxMissedPongs) noexcept
+    : _maxMissedPongs(maxMissedPongs),
+      _missedPongs(0),
+      _sequence(0),
+      _pingTime(std::nullopt),
+      _latencies()
+{
+}
+
+Message Heartbeat::makeNextPing(const Clock::time_point now)
+{
+    if (_pingTime.has_value())
+    {
+        ++_missedPongs;
+    }
+
+    _pingTime = now;
+    return makePing(++_sequence);
+}
+
+std::optional<std::chrono::microseconds> Heartbeat::receivePong(const Message& message,
+                                                                const Clock::time_point now)
+{
+    if (message.type != MessageType::PONG || message.sequence != _sequence
+        || !_pingTime.has_value())
+    {
+        return std::nullopt;
+    }
+
+    const auto roundTrip = std::chrono::duration_cast<std::chrono::microseconds>(now - *_pingTime);
+    _latencies.record(roundTrip);
+    _pingTime.reset();
+    _missedPongs = 0;
+    return roundTrip;
+}
+
+bool Heartbeat::isAlive() const noexcept
+{
+    return _missedPongs < _maxMissedPongs;
+}
+
+void Heartbeat::reset() noexcept
+{
+    _missedPongs = 0;
+    _pingTime.reset();
+}
+
+std::size_t Heartbeat::getMissedPongs() const noexcept
+{
+    return _missedPongs;
+}
+
+const stats::Histogram& Heartbeat::getLatencies() const noexcept
+{
+    return _latencies;
+}
+
+} // namespace protocol
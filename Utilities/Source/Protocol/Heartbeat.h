@@ -0,0 +1,112 @@
+#ifndef HEARTBEAT_H
+#define HEARTBEAT_H
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+#include "Histogram/Histogram.h"
+#include "Message.h"
+
+
+/**
+ * \brief Additional namespace to work with messages on the wire.
+ */
+namespace protocol
+{
+
+/**
+ * \brief   Class used to track heartbeats of one connection.
+ * \details Owner sends ping created by this class on every tick of its timer and passes every
+ *          received pong back. Ping which is not answered before the next tick counts as missed,
+ *          connection is considered dead after several missed pings in a row. Round-trip time of
+ *          every answered ping is recorded into histogram.
+ */
+class Heartbeat
+{
+public:
+    /**
+     * \brief Clock used to measure round-trip time.
+     */
+    using Clock = std::chrono::steady_clock;
+
+
+    /**
+     * \brief                    Constructor which sets limit of missed pings.
+     * \param[in] maxMissedPongs Number of unanswered pings in a row after which connection is
+     *                           considered dead.
+     */
+    explicit                    Heartbeat(const std::size_t maxMissedPongs) noexcept;
+
+    /**
+     * \brief         Create next ping, previous one is counted as missed if it wasn't answered.
+     * \param[in] now Time of sending.
+     * \return        Ping to send.
+     */
+    [[nodiscard]]
+    Message                     makeNextPing(const Clock::time_point now = Clock::now());
+
+    /**
+     * \brief             Process received pong.
+     * \param[in] message PONG message.
+     * \param[in] now     Time of receiving.
+     * \return            Round-trip time or std::nullopt if pong doesn't answer the last ping
+     *                    (late pong of previous ping is ignored).
+     */
+    std::optional<std::chrono::microseconds> receivePong(const Message& message,
+                                                        const Clock::time_point now = Clock::now());
+
+    /**
+     * \brief  Check if limit of missed pings is not reached.
+     * \return True if connection is considered alive.
+     */
+    bool                        isAlive() const noexcept;
+
+    /**
+     * \brief Forget unanswered ping (e.g. after reconnection), statistics are kept.
+     */
+    void                        reset() noexcept;
+
+    /**
+     * \brief  Get number of unanswered pings in a row.
+     * \return Number of missed pongs.
+     */
+    std::size_t                 getMissedPongs() const noexcept;
+
+    /**
+     * \brief  Get distribution of round-trip times.
+     * \return Histogram of all answered pings.
+     */
+    const stats::Histogram&     getLatencies() const noexcept;
+
+
+private:
+    /**
+     * \brief Number of unanswered pings in a row after which connection is considered dead.
+     */
+    std::size_t                 _maxMissedPongs;
+
+    /**
+     * \brief Number of unanswered pings in a row.
+     */
+    std::size_t                 _missedPongs;
+
+    /**
+     * \brief Sequence number of the last ping.
+     */
+    std::uint32_t               _sequence;
+
+    /**
+     * \brief Time of sending the last ping if it wasn't answered yet.
+     */
+    std::optional<Clock::time_point> _pingTime;
+
+    /**
+     * \brief Round-trip times of answered pings.
+     */
+    stats::Histogram            _latencies;
+};
+
+} // namespace protocol
+
+#endif // HEARTBEAT_H
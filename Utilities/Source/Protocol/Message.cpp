@@ -0,0 +1,528 @@
+#include <sstream>
+
+#include "Parsing/Parsing.h"
+#include "Protocol/Framer.h"
+
+#include "Message.h"
+
+
+namespace protocol
+{
+
+namespace
+{
+
+/**
+ * \brief             Append integer to buffer in little-endian order.
+ * \tparam T          Unsigned integer type.
+ * \param[out] buffer Buffer to append.
+ * \param[in] value   Value to write.
+ */
+template <class T>
+void writeLittleEndian(std::string& buffer, const T value)
+{
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+    {
+        buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+/**
+ * \brief          Read integer in little-endian order.
+ * \tparam T       Unsigned integer type.
+ * \param[in] data Buffer which contains at least sizeof(T) bytes.
+ * \return         Read value.
+ */
+template <class T>
+T readLittleEndian(const char* data)
+{
+    T result = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+    {
+        result |= static_cast<T>(static_cast<unsigned char>(data[i])) << (8 * i);
+    }
+    return result;
+}
+
+/**
+ * \brief               Parse decimal number without sign.
+ * \param[in] text      Digits only.
+ * \param[in] maxDigits Maximum number of digits, keeps result from overflow.
+ * \return              Parsed number or std::nullopt if text is not a number.
+ */
+std::optional<std::uint64_t> parseUnsigned(const std::string_view text,
+                                           const std::size_t maxDigits)
+{
+    if (text.empty() || text.size() > maxDigits)
+    {
+        return std::nullopt;
+    }
+
+    std::uint64_t result = 0;
+    for (const char digit : text)
+    {
+        if (digit < '0' || digit > '9')
+        {
+            return std::nullopt;
+        }
+        result = result * 10 + static_cast<std::uint64_t>(digit - '0');
+    }
+    return result;
+}
+
+/**
+ * \brief          Parse number of point in stream.
+ * \param[in] text Digits only.
+ * \return         Parsed number or std::nullopt if text is not a 32-bit number.
+ */
+std::optional<std::uint32_t> parseSequence(const std::string_view text)
+{
+    const auto number = parseUnsigned(text, 10);
+    if (!number.has_value() || *number > UINT32_MAX)
+    {
+        return std::nullopt;
+    }
+    return static_cast<std::uint32_t>(*number);
+}
+
+/**
+ * \brief             Get size of message payload in binary format.
+ * \param[in] message Message to encode.
+ * \return            Number of bytes after header.
+ */
+std::size_t getPayloadSize(const Message& message)
+{
+    switch (message.type)
+    {
+        case MessageType::POINT:
+            [[fallthrough]];
+        case MessageType::ANSWER:
+            return ROBOT_DATA_SIZE;
+
+        case MessageType::COORDINATE_SYSTEM:
+            return 1;
+
+        case MessageType::TEXT:
+            return message.text.size();
+
+        case MessageType::PING:
+            [[fallthrough]];
+        case MessageType::PONG:
+            return 0;
+
+        default:
+            assert(false);
+            return 0;
+    }
+}
+
+/**
+ * \brief             Append message in binary format to buffer.
+ * \details           Header and payload are written in place, so many messages share one
+ *                    allocation.
+ * \param[out] buffer Buffer to append.
+ * \param[in] message Message to encode.
+ */
+void appendEncoded(std::string& buffer, const Message& message)
+{
+    const std::size_t payloadSize = getPayloadSize(message);
+    writeLittleEndian(buffer, MAGIC);
+    writeLittleEndian(buffer, static_cast<std::uint8_t>(message.type));
+    writeLittleEndian(buffer, message.flags);
+    writeLittleEndian(buffer, message.sequence);
+    writeLittleEndian(buffer, static_cast<std::uint32_t>(payloadSize));
+
+    switch (message.type)
+    {
+        case MessageType::POINT:
+            [[fallthrough]];
+        case MessageType::ANSWER:
+            for (const int coordinate : message.robotData.coordinates)
+            {
+                writeLittleEndian(buffer, static_cast<std::uint32_t>(coordinate));
+            }
+            for (const int parameter : message.robotData.parameters)
+            {
+                writeLittleEndian(buffer, static_cast<std::uint32_t>(parameter));
+            }
+            break;
+
+        case MessageType::COORDINATE_SYSTEM:
+            buffer.push_back(static_cast<char>(message.coordinateSystem));
+            break;
+
+        case MessageType::TEXT:
+            buffer += message.text;
+            break;
+
+        default:
+            break;
+    }
+}
+
+} // anonymous namespace
+
+Message makePoint(const vasily::RobotData& robotData)
+{
+    Message message;
+    message.type      = MessageType::POINT;
+    message.robotData = robotData;
+    return message;
+}
+
+Message makePriorityPoint(const vasily::RobotData& robotData)
+{
+    Message message = makePoint(robotData);
+    message.flags   = PRIORITY_FLAG;
+    return message;
+}
+
+bool isPriority(const Message& message) noexcept
+{
+    return message.type == MessageType::POINT && (message.flags & PRIORITY_FLAG) != 0;
+}
+
+std::optional<std::string_view> stripPriorityPrefix(const std::string_view text)
+{
+    if (text.substr(0, PRIORITY_PREFIX.size()) != PRIORITY_PREFIX)
+    {
+        return std::nullopt;
+    }
+    return text.substr(PRIORITY_PREFIX.size());
+}
+
+std::optional<std::string_view> parseRejectedLine(const std::string_view text)
+{
+    if (text.substr(0, REJECT_PREFIX.size()) != REJECT_PREFIX)
+    {
+        return std::nullopt;
+    }
+
+    const std::string_view line = text.substr(REJECT_PREFIX.size());
+    return line.substr(0, line.rfind(REJECT_POINTS));
+}
+
+std::optional<vasily::RobotData> parseTextAnswer(const std::string_view text)
+{
+    std::istringstream stream{ std::string(text) };
+    vasily::RobotData robotData;
+    for (auto& coordinate : robotData.coordinates)
+    {
+        stream >> coordinate;
+    }
+    if (stream.fail())
+    {
+        return std::nullopt;
+    }
+
+    for (auto& parameter : robotData.parameters)
+    {
+        int value;
+        if (!(stream >> value))
+        {
+            break;
+        }
+        parameter = value;
+    }
+    return robotData;
+}
+
+Message makeAnswer(const vasily::RobotData& robotData)
+{
+    Message message;
+    message.type      = MessageType::ANSWER;
+    message.robotData = robotData;
+    return message;
+}
+
+Message makeCoordinateSystem(const vasily::CoordinateSystem coordinateSystem)
+{
+    Message message;
+    message.type             = MessageType::COORDINATE_SYSTEM;
+    message.coordinateSystem = coordinateSystem;
+    return message;
+}
+
+Message makeText(const std::string_view text)
+{
+    Message message;
+    message.type = MessageType::TEXT;
+    message.text = text;
+    return message;
+}
+
+Message makePing(const std::uint32_t sequence)
+{
+    Message message;
+    message.type     = MessageType::PING;
+    message.sequence = sequence;
+    return message;
+}
+
+Message makePong(const std::uint32_t sequence)
+{
+    Message message;
+    message.type     = MessageType::PONG;
+    message.sequence = sequence;
+    return message;
+}
+
+std::optional<Message> parseHeartbeat(const std::string_view text)
+{
+    MessageType type;
+    if (text.substr(0, PING_PREFIX.size()) == PING_PREFIX)
+    {
+        type = MessageType::PING;
+    }
+    else if (text.substr(0, PONG_PREFIX.size()) == PONG_PREFIX)
+    {
+        type = MessageType::PONG;
+    }
+    else
+    {
+        return std::nullopt;
+    }
+
+    const auto sequence = parseSequence(text.substr(PING_PREFIX.size()));
+    if (!sequence.has_value())
+    {
+        return std::nullopt;
+    }
+
+    Message message;
+    message.type     = type;
+    message.sequence = *sequence;
+    return message;
+}
+
+std::string makeEtaRequest(const std::optional<std::uint32_t> sequence)
+{
+    std::string result(ETA_PREFIX);
+    if (sequence.has_value())
+    {
+        result += ' ' + std::to_string(*sequence);
+    }
+    return result;
+}
+
+std::optional<Eta> parseEtaRequest(const std::string_view text)
+{
+    if (text == ETA_PREFIX)
+    {
+        return Eta{};
+    }
+    if (text.substr(0, ETA_PREFIX.size()) != ETA_PREFIX || text.size() <= ETA_PREFIX.size()
+        || text[ETA_PREFIX.size()] != ' ')
+    {
+        return std::nullopt;
+    }
+
+    const auto sequence = parseSequence(text.substr(ETA_PREFIX.size() + 1));
+    if (!sequence.has_value())
+    {
+        return std::nullopt;
+    }
+    return Eta{ sequence };
+}
+
+std::string makeEtaAnswer(const Eta& eta)
+{
+    const std::string point = eta.sequence.has_value() ? std::to_string(*eta.sequence)
+                                                       : std::string(ETA_TOTAL);
+    const long long time = eta.time.count() < 0 ? -1 : static_cast<long long>(eta.time.count());
+    return std::string(ETA_PREFIX) + ' ' + point + ' ' + std::to_string(time);
+}
+
+std::optional<Eta> parseEtaAnswer(const std::string_view text)
+{
+    if (text.substr(0, ETA_PREFIX.size() + 1) != std::string(ETA_PREFIX) + ' ')
+    {
+        return std::nullopt;
+    }
+
+    const std::string_view rest = text.substr(ETA_PREFIX.size() + 1);
+    const std::size_t space = rest.find(' ');
+    if (space == std::string_view::npos)
+    {
+        return std::nullopt;
+    }
+
+    Eta eta;
+    const std::string_view point = rest.substr(0, space);
+    if (point != ETA_TOTAL)
+    {
+        eta.sequence = parseSequence(point);
+        if (!eta.sequence.has_value())
+        {
+            return std::nullopt;
+        }
+    }
+
+    // Unknown time stays negative.
+    const std::string_view time = rest.substr(space + 1);
+    if (time != "-1")
+    {
+        const auto microseconds = parseUnsigned(time, 18);
+        if (!microseconds.has_value())
+        {
+            return std::nullopt;
+        }
+        eta.time = std::chrono::microseconds(static_cast<long long>(*microseconds));
+    }
+    return eta;
+}
+
+std::string encode(const Message& message)
+{
+    std::string result;
+    result.reserve(HEADER_SIZE + getPayloadSize(message));
+    appendEncoded(result, message);
+    return result;
+}
+
+void setSequence(std::string& frame, const std::uint32_t sequence)
+{
+    assert(frame.size() >= HEADER_SIZE);
+
+    std::string encoded;
+    encoded.reserve(sizeof(sequence));
+    writeLittleEndian(encoded, sequence);
+    frame.replace(4, encoded.size(), encoded);
+}
+
+std::optional<Message> decode(const std::string_view frame)
+{
+    const auto frameSize = getFrameSize(frame);
+    if (!frameSize.has_value() || *frameSize != frame.size())
+    {
+        return std::nullopt;
+    }
+
+    Message message;
+    message.type     = static_cast<MessageType>(readLittleEndian<std::uint8_t>(frame.data() + 2));
+    message.flags    = readLittleEndian<std::uint8_t>(frame.data() + 3);
+    message.sequence = readLittleEndian<std::uint32_t>(frame.data() + 4);
+
+    const std::string_view payload = frame.substr(HEADER_SIZE);
+    switch (message.type)
+    {
+        case MessageType::POINT:
+            [[fallthrough]];
+        case MessageType::ANSWER:
+        {
+            if (payload.size() != ROBOT_DATA_SIZE)
+            {
+                return std::nullopt;
+            }
+
+            const char* data = payload.data();
+            for (auto& coordinate : message.robotData.coordinates)
+            {
+                coordinate = static_cast<int>(readLittleEndian<std::uint32_t>(data));
+                data += 4;
+            }
+            for (auto& parameter : message.robotData.parameters)
+            {
+                parameter = static_cast<int>(readLittleEndian<std::uint32_t>(data));
+                data += 4;
+            }
+            break;
+        }
+
+        case MessageType::COORDINATE_SYSTEM:
+        {
+            if (payload.size() != 1
+                || static_cast<unsigned char>(payload.front())
+                   > static_cast<unsigned char>(vasily::CoordinateSystem::WORLD))
+            {
+                return std::nullopt;
+            }
+            message.coordinateSystem = static_cast<vasily::CoordinateSystem>(payload.front());
+            break;
+        }
+
+        case MessageType::TEXT:
+            message.text = payload;
+            break;
+
+        case MessageType::PING:
+            [[fallthrough]];
+        case MessageType::PONG:
+            if (!payload.empty())
+            {
+                return std::nullopt;
+            }
+            break;
+
+        default:
+            return std::nullopt;
+    }
+
+    return message;
+}
+
+std::optional<std::size_t> getFrameSize(const std::string_view buffer)
+{
+    if (buffer.size() < HEADER_SIZE
+        || readLittleEndian<std::uint16_t>(buffer.data()) != MAGIC)
+    {
+        return std::nullopt;
+    }
+
+    return HEADER_SIZE + readLittleEndian<std::uint32_t>(buffer.data() + 8);
+}
+
+std::string toText(const Message& message)
+{
+    switch (message.type)
+    {
+        case MessageType::POINT:
+            if ((message.flags & PRIORITY_FLAG) != 0)
+            {
+                return std::string(PRIORITY_PREFIX) + message.robotData.toString();
+            }
+            return message.robotData.toString();
+
+        case MessageType::ANSWER:
+            // Keep answer in the same form as robot sends it in text format.
+            return utils::parseFullData(message.robotData.toString());
+
+        case MessageType::COORDINATE_SYSTEM:
+            return std::to_string(static_cast<int>(message.coordinateSystem));
+
+        case MessageType::TEXT:
+            return message.text;
+
+        case MessageType::PING:
+            return std::string(PING_PREFIX) + std::to_string(message.sequence);
+
+        case MessageType::PONG:
+            return std::string(PONG_PREFIX) + std::to_string(message.sequence);
+
+        default:
+            assert(false);
+            return {};
+    }
+}
+
+std::string serialize(const Message& message, const WireFormat format)
+{
+    if (format == WireFormat::BINARY)
+    {
+        return encode(message);
+    }
+    return Framer::frame(toText(message));
+}
+
+void serialize(const Message& message, const WireFormat format, std::string& buffer)
+{
+    if (format == WireFormat::BINARY)
+    {
+        appendEncoded(buffer, message);
+        return;
+    }
+    buffer += toText(message);
+    buffer.push_back(Framer::DELIMITER);
+}
+
+} // namespace protocol
@@ -0,0 +1,359 @@
+#ifndef MESSAGE_H
+#define MESSAGE_H
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "RobotData/RobotData.h"
+
+
+/**
+ * \brief Additional namespace to work with messages on the wire.
+ */
+namespace protocol
+{
+
+/**
+ * \brief Array of formats which messages can be encoded in.
+ */
+enum class WireFormat
+{
+    TEXT,
+    BINARY
+};
+
+/**
+ * \brief Array of message types in binary format.
+ */
+enum class MessageType : std::uint8_t
+{
+    TEXT              = 0,
+    POINT             = 1,
+    COORDINATE_SYSTEM = 2,
+    ANSWER            = 3,
+    PING              = 4,
+    PONG              = 5
+};
+
+/**
+ * \brief Line which asks peer to switch to binary format and confirms switching.
+ * \details Handshake is sent as text. After sending request sender writes binary messages;
+ *          peer switches its parser right after request and answers with the same line, after
+ *          which it writes binary messages too.
+ */
+constexpr std::string_view HANDSHAKE_BINARY = "#PROTOCOL BINARY";
+
+/**
+ * \brief Lines which layer sends to client when its queue is full and when client can continue
+ *        sending (in binary format they are sent as TEXT messages).
+ */
+constexpr std::string_view QUEUE_FULL   = "#QUEUE FULL";
+constexpr std::string_view QUEUE_RESUME = "#QUEUE RESUME";
+
+/**
+ * \brief   Prefixes of heartbeat lines in text format, followed by sequence number of ping.
+ * \details In binary format PING and PONG messages have empty payload and sequence number in
+ *          header. Peer answers every ping with pong which has the same sequence number.
+ */
+constexpr std::string_view PING_PREFIX = "#PING ";
+constexpr std::string_view PONG_PREFIX = "#PONG ";
+
+/**
+ * \brief   Prefix of point line in text format which layer has to pass before queued points.
+ * \details In binary format the same is marked by PRIORITY_FLAG in header. Layer removes the
+ *          mark before sending point to robot.
+ */
+constexpr std::string_view PRIORITY_PREFIX = "#PRIORITY ";
+
+/**
+ * \brief   Prefix of lines which ask layer when queued points will be reached and of its
+ *          answers (in binary format they are sent as TEXT messages).
+ * \details Client sends "#ETA" for the whole queue or "#ETA <sequence>" for one its point.
+ *          Layer answers "#ETA TOTAL <microseconds>" or "#ETA <sequence> <microseconds>", time
+ *          is counted from moment of answer and is -1 if point is not in queue.
+ */
+constexpr std::string_view ETA_PREFIX = "#ETA";
+constexpr std::string_view ETA_TOTAL  = "TOTAL";
+
+/**
+ * \brief   Prefix of line which layer sends when it rejects point or program of client, and
+ *          separator of numbers of points outside of workspace which may follow rejected line
+ *          (in binary format it is sent as TEXT message).
+ * \details Rejected points are never sent to robot, so they are never answered.
+ */
+constexpr std::string_view REJECT_PREFIX = "INCORRECT COORDINATES: ";
+constexpr std::string_view REJECT_POINTS = " POINTS:";
+
+/**
+ * \brief Flag in binary header of point which layer has to pass before queued points.
+ */
+constexpr std::uint8_t     PRIORITY_FLAG = 0x01;
+
+/**
+ * \brief Value which starts every binary message, used to detect broken stream.
+ */
+constexpr std::uint16_t    MAGIC = 0x5646;
+
+/**
+ * \brief Size of binary header: magic (2), type (1), flags (1), sequence (4), length (4).
+ */
+constexpr std::size_t      HEADER_SIZE = 12;
+
+/**
+ * \brief Size of RobotData in binary format: 9 little-endian 32-bit integers.
+ */
+constexpr std::size_t      ROBOT_DATA_SIZE = (vasily::RobotData::NUMBER_OF_COORDINATES
+                                              + vasily::RobotData::NUMBER_OF_PARAMETERS) * 4;
+
+
+/**
+ * \brief Structure which keeps decoded message of any type.
+ */
+struct Message
+{
+    /**
+     * \brief Type of message.
+     */
+    MessageType                 type = MessageType::TEXT;
+
+    /**
+     * \brief Flags from binary header (e.g. PRIORITY_FLAG).
+     */
+    std::uint8_t                flags = 0;
+
+    /**
+     * \brief Number of message in stream of sender.
+     */
+    std::uint32_t               sequence = 0;
+
+    /**
+     * \brief Point for POINT and ANSWER messages.
+     */
+    vasily::RobotData           robotData{};
+
+    /**
+     * \brief Coordinate system for COORDINATE_SYSTEM messages.
+     */
+    vasily::CoordinateSystem    coordinateSystem = vasily::CoordinateSystem::INVALID;
+
+    /**
+     * \brief Content of TEXT messages.
+     */
+    std::string                 text;
+};
+
+
+/**
+ * \brief Structure which keeps request or answer about time left to queued points.
+ */
+struct Eta
+{
+    /**
+     * \brief Number of point in stream of client or std::nullopt for the whole queue.
+     */
+    std::optional<std::uint32_t> sequence;
+
+    /**
+     * \brief Time left to the end of point or queue, negative if it is unknown (only answer).
+     */
+    std::chrono::microseconds   time{ -1 };
+};
+
+
+/**
+ * \brief               Create message with point to send to robot.
+ * \param[in] robotData Point to send.
+ * \return              Created message.
+ */
+[[nodiscard]]
+Message                 makePoint(const vasily::RobotData& robotData);
+
+/**
+ * \brief               Create message with point which has to pass before queued points
+ *                      (e.g. stop or return home).
+ * \param[in] robotData Point to send.
+ * \return              Created message.
+ */
+[[nodiscard]]
+Message                 makePriorityPoint(const vasily::RobotData& robotData);
+
+/**
+ * \brief             Check if point has to pass before queued points.
+ * \details           Only point marked by sender (PRIORITY_FLAG or text prefix) is priority, stop
+ *                    flag of regular point doesn't make it priority.
+ * \param[in] message Message to check.
+ * \return            True for priority point.
+ */
+[[nodiscard]]
+bool                    isPriority(const Message& message) noexcept;
+
+/**
+ * \brief          Remove priority prefix from line received in text format.
+ * \param[in] text Line without delimiter.
+ * \return         Rest of line or std::nullopt if line has no prefix.
+ */
+[[nodiscard]]
+std::optional<std::string_view> stripPriorityPrefix(const std::string_view text);
+
+/**
+ * \brief          Extract line which layer rejected.
+ * \param[in] text Line received from layer.
+ * \return         Rejected line as client sent it or std::nullopt if line is not a rejection.
+ */
+[[nodiscard]]
+std::optional<std::string_view> parseRejectedLine(const std::string_view text);
+
+/**
+ * \brief          Parse point which robot reached from its text answer.
+ * \details        Robot answers with coordinates and may omit some parameters of point, missing
+ *                 parameters keep default values.
+ * \param[in] text Line without delimiter.
+ * \return         Reached point or std::nullopt if line has no coordinates.
+ */
+[[nodiscard]]
+std::optional<vasily::RobotData> parseTextAnswer(const std::string_view text);
+
+/**
+ * \brief               Create message with point which robot reached.
+ * \param[in] robotData Reached point.
+ * \return              Created message.
+ */
+[[nodiscard]]
+Message                 makeAnswer(const vasily::RobotData& robotData);
+
+/**
+ * \brief                      Create message with coordinate system.
+ * \param[in] coordinateSystem Coordinate system to send.
+ * \return                     Created message.
+ */
+[[nodiscard]]
+Message                 makeCoordinateSystem(const vasily::CoordinateSystem coordinateSystem);
+
+/**
+ * \brief          Create message with arbitrary text.
+ * \param[in] text Text to send.
+ * \return         Created message.
+ */
+[[nodiscard]]
+Message                 makeText(const std::string_view text);
+
+/**
+ * \brief              Create heartbeat request.
+ * \param[in] sequence Number of ping which peer returns in pong.
+ * \return             Created message.
+ */
+[[nodiscard]]
+Message                 makePing(const std::uint32_t sequence);
+
+/**
+ * \brief              Create answer to heartbeat request.
+ * \param[in] sequence Number of received ping.
+ * \return             Created message.
+ */
+[[nodiscard]]
+Message                 makePong(const std::uint32_t sequence);
+
+/**
+ * \brief          Parse heartbeat line received in text format.
+ * \param[in] text Line without delimiter.
+ * \return         PING or PONG message or std::nullopt if line is not a heartbeat.
+ */
+[[nodiscard]]
+std::optional<Message>  parseHeartbeat(const std::string_view text);
+
+/**
+ * \brief              Create line which asks layer about time left to queued points.
+ * \param[in] sequence Number of point or std::nullopt for the whole queue.
+ * \return             Line without delimiter.
+ */
+[[nodiscard]]
+std::string             makeEtaRequest(const std::optional<std::uint32_t> sequence);
+
+/**
+ * \brief          Parse line which asks layer about time left to queued points.
+ * \param[in] text Line without delimiter.
+ * \return         Request without time or std::nullopt if line is not a request.
+ */
+[[nodiscard]]
+std::optional<Eta>      parseEtaRequest(const std::string_view text);
+
+/**
+ * \brief         Create line which answers request about time left to queued points.
+ * \param[in] eta Requested point and time left to it.
+ * \return        Line without delimiter.
+ */
+[[nodiscard]]
+std::string             makeEtaAnswer(const Eta& eta);
+
+/**
+ * \brief          Parse line which answers request about time left to queued points.
+ * \param[in] text Line without delimiter.
+ * \return         Answer or std::nullopt if line is not an answer.
+ */
+[[nodiscard]]
+std::optional<Eta>      parseEtaAnswer(const std::string_view text);
+
+/**
+ * \brief             Encode message in binary format.
+ * \param[in] message Message to encode.
+ * \return            Header and payload ready to be written to socket.
+ */
+[[nodiscard]]
+std::string             encode(const Message& message);
+
+/**
+ * \brief              Change sequence number of message encoded in binary format in place.
+ * \param[out] frame   Header and payload of one message.
+ * \param[in] sequence New sequence number.
+ */
+void                    setSequence(std::string& frame, const std::uint32_t sequence);
+
+/**
+ * \brief           Decode message in binary format.
+ * \param[in] frame Header and payload of one message.
+ * \return          Decoded message or std::nullopt if frame is incorrect.
+ */
+[[nodiscard]]
+std::optional<Message>  decode(const std::string_view frame);
+
+/**
+ * \brief            Get size of binary message which buffer starts with.
+ * \param[in] buffer Received data which contains at least header.
+ * \return           Size of header and payload or std::nullopt if header is incorrect.
+ */
+[[nodiscard]]
+std::optional<std::size_t> getFrameSize(const std::string_view buffer);
+
+/**
+ * \brief             Convert message to representation used by text format.
+ * \param[in] message Message to convert.
+ * \return            Text representation without delimiter.
+ */
+[[nodiscard]]
+std::string             toText(const Message& message);
+
+/**
+ * \brief             Convert message to data ready to be written to socket.
+ * \param[in] message Message to convert.
+ * \param[in] format  Format which peer expects.
+ * \return            Framed text or binary message.
+ */
+[[nodiscard]]
+std::string             serialize(const Message& message, const WireFormat format);
+
+/**
+ * \brief             Append message to buffer in the same way as serialize does.
+ * \details           Used to send many messages with one write without temporary strings.
+ * \param[in] message Message to convert.
+ * \param[in] format  Format which peer expects.
+ * \param[out] buffer Buffer to append.
+ */
+void                    serialize(const Message& message, const WireFormat format,
+                                  std::string& buffer);
+
+} // namespace protocol
+
+#endif // MESSAGE_H
@@ -0,0 +1,133 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <atomic>
+#include <memory>
+#include <optional>
+
+
+/**
+ * \brief Additional namespace for containers shared between threads.
+ */
+namespace container
+{
+
+/**
+ * \brief   Fixed-capacity queue for one producer thread and one consumer thread.
+ * \details Buffer never allocates after construction and uses no mutex: producer owns tail,
+ *          consumer owns head, each side only reads the other one. Full buffer rejects new
+ *          elements, so caller decides what to do (wait, drop or notify sender).
+ * \tparam T Type of elements, has to be default constructible and movable.
+ */
+template <class T>
+class RingBuffer
+{
+public:
+    /**
+     * \brief              Constructor which allocates storage.
+     * \param[in] capacity Maximum number of elements (rounded up to power of two).
+     */
+    explicit                    RingBuffer(const std::size_t capacity);
+
+    /**
+     * \brief Default destructor.
+     */
+                                ~RingBuffer() = default;
+
+    /**
+     * \brief           Deleted copy constructor.
+     * \param[in] other Other object.
+     */
+                                RingBuffer(const RingBuffer& other) = delete;
+
+    /**
+     * \brief           Deleted copy assignment operator.
+     * \param[in] other Other object.
+     * \return          Returns nothing because it's deleted.
+     */
+    RingBuffer&                 operator=(const RingBuffer& other) = delete;
+
+    /**
+     * \brief           Add element to the end of queue (producer thread only).
+     * \param[in] value Element to add.
+     * \return          False if queue is full and element was not added.
+     */
+    bool                        tryPush(T value);
+
+    /**
+     * \brief  Remove element from the beginning of queue (consumer thread only).
+     * \return Removed element or std::nullopt if queue is empty.
+     */
+    std::optional<T>            tryPop();
+
+    /**
+     * \brief  Get first element without removing it (consumer thread only).
+     * \return Pointer to element or nullptr if queue is empty.
+     */
+    const T*                    front() const noexcept;
+
+    /**
+     * \brief  Get number of elements, exact only if called from one of owner threads.
+     * \return Number of elements.
+     */
+    std::size_t                 size() const noexcept;
+
+    /**
+     * \brief  Check if queue has no elements.
+     * \return True if queue is empty.
+     */
+    bool                        empty() const noexcept;
+
+    /**
+     * \brief  Get maximum number of elements.
+     * \return Capacity of storage.
+     */
+    std::size_t                 capacity() const noexcept;
+
+    /**
+     * \brief  Get the largest number of elements which queue ever kept.
+     * \return High-water mark.
+     */
+    std::size_t                 getHighWaterMark() const noexcept;
+
+
+private:
+    /**
+     * \brief Storage of elements.
+     */
+    std::unique_ptr<T[]>        _storage;
+
+    /**
+     * \brief Mask used instead of modulo, capacity is power of two.
+     */
+    std::size_t                 _mask;
+
+    /**
+     * \brief Number of popped elements (written by consumer).
+     */
+    std::atomic<std::size_t>    _head;
+
+    /**
+     * \brief Number of pushed elements (written by producer).
+     */
+    std::atomic<std::size_t>    _tail;
+
+    /**
+     * \brief The largest number of elements which queue ever kept (written by producer).
+     */
+    std::atomic<std::size_t>    _highWaterMark;
+
+
+    /**
+     * \brief              Round value up to power of two.
+     * \param[in] capacity Requested capacity.
+     * \return             The smallest power of two which is not less than capacity.
+     */
+    static std::size_t          roundCapacity(const std::size_t capacity) noexcept;
+};
+
+#include "RingBuffer.inl"
+
+} // namespace container
+
+#endif // RING_BUFFER_H
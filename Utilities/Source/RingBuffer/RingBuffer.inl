@@ -0,0 +1,95 @@
+#ifndef RING_BUFFER_INL
+#define RING_BUFFER_INL
+
+
+template <class T>
+RingBuffer<T>::RingBuffer(const std::size_t capacity)
+    : _storage(std::make_unique<T[]>(roundCapacity(capacity))),
+      _mask(roundCapacity(capacity) - 1),
+      _head(0),
+      _tail(0),
+      _highWaterMark(0)
+{
+}
+
+template <class T>
+bool RingBuffer<T>::tryPush(T value)
+{
+    const std::size_t tail = _tail.load(std::memory_order_relaxed);
+    const std::size_t size = tail - _head.load(std::memory_order_acquire);
+    if (size > _mask)
+    {
+        return false;
+    }
+
+    _storage[tail & _mask] = std::move(value);
+    _tail.store(tail + 1, std::memory_order_release);
+
+    if (size + 1 > _highWaterMark.load(std::memory_order_relaxed))
+    {
+        _highWaterMark.store(size + 1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+template <class T>
+std::optional<T> RingBuffer<T>::tryPop()
+{
+    const std::size_t head = _head.load(std::memory_order_relaxed);
+    if (head == _tail.load(std::memory_order_acquire))
+    {
+        return std::nullopt;
+    }
+
+    std::optional<T> result(std::move(_storage[head & _mask]));
+    _head.store(head + 1, std::memory_order_release);
+    return result;
+}
+
+template <class T>
+const T* RingBuffer<T>::front() const noexcept
+{
+    const std::size_t head = _head.load(std::memory_order_relaxed);
+    if (head == _tail.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
+    return &_storage[head & _mask];
+}
+
+template <class T>
+std::size_t RingBuffer<T>::size() const noexcept
+{
+    return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+}
+
+template <class T>
+bool RingBuffer<T>::empty() const noexcept
+{
+    return size() == 0;
+}
+
+template <class T>
+std::size_t RingBuffer<T>::capacity() const noexcept
+{
+    return _mask + 1;
+}
+
+template <class T>
+std::size_t RingBuffer<T>::getHighWaterMark() const noexcept
+{
+    return _highWaterMark.load(std::memory_order_relaxed);
+}
+
+template <class T>
+std::size_t RingBuffer<T>::roundCapacity(const std::size_t capacity) noexcept
+{
+    std::size_t result = 1;
+    while (result < capacity)
+    {
+        result <<= 1;
+    }
+    return result;
+}
+
+#endif // RING_BUFFER_INL
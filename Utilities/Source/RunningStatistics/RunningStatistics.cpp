@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <cmath>
+
+#include "RunningStatistics.h"
+
+
+namespace stats
+{
+
+RunningStatistics::RunningStatistics() noexcept
+    : _count(0),
+      _mean(0.0),
+      _squaredDeviations(0.0),
+      _min(0.0),
+      _max(0.0)
+{
+}
+
+void RunningStatistics::record(const double value) noexcept
+{
+    ++_count;
+    if (_count == 1)
+    {
+        _min = value;
+        _max = value;
+    }
+    else
+    {
+        _min = std::min(_min, value);
+        _max = std::max(_max, value);
+    }
+
+    // Deviation is taken from mean before and after update, their product needs no subtraction
+    // of big close numbers.
+    const double delta = value - _mean;
+    _mean += delta / static_cast<double>(_count);
+    _squaredDeviations += delta * (value - _mean);
+}
+
+void RunningStatistics::reset() noexcept
+{
+    *this = RunningStatistics();
+}
+
+std::uint64_t RunningStatistics::getCount() const noexcept
+{
+    return _count;
+}
+
+double RunningStatistics::getMean() const noexcept
+{
+    return _mean;
+}
+
+double RunningStatistics::getVariance() const noexcept
+{
+    return _count < 2 ? 0.0 : _squaredDeviations / static_cast<double>(_count - 1);
+}
+
+double RunningStatistics::getStandardDeviation() const noexcept
+{
+    return std::sqrt(getVariance());
+}
+
+double RunningStatistics::getMin() const noexcept
+{
+    return _min;
+}
+
+double RunningStatistics::getMax() const noexcept
+{
+    return _max;
+}
+
+} // namespace stats
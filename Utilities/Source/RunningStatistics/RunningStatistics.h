@@ -0,0 +1,103 @@
+#ifndef RUNNING_STATISTICS_H
+#define RUNNING_STATISTICS_H
+
+#include <cstdint>
+
+
+/**
+ * \brief Additional namespace for runtime statistics.
+ */
+namespace stats
+{
+
+/**
+ * \brief   Class used to keep count, mean, variance and range of endless stream of samples.
+ * \details Mean and variance are updated by Welford's method, so memory is fixed and precision
+ *          doesn't degrade when mean is much bigger than spread.
+ */
+class RunningStatistics
+{
+public:
+    /**
+     * \brief Default constructor.
+     */
+                                RunningStatistics() noexcept;
+
+    /**
+     * \brief           Add one sample.
+     * \param[in] value Measured value.
+     */
+    void                        record(const double value) noexcept;
+
+    /**
+     * \brief Remove all samples.
+     */
+    void                        reset() noexcept;
+
+    /**
+     * \brief  Get number of samples.
+     * \return Number of recorded samples.
+     */
+    std::uint64_t               getCount() const noexcept;
+
+    /**
+     * \brief  Get average of samples.
+     * \return Mean or zero if there are no samples.
+     */
+    double                      getMean() const noexcept;
+
+    /**
+     * \brief  Get unbiased variance of samples.
+     * \return Variance or zero if there are less than two samples.
+     */
+    double                      getVariance() const noexcept;
+
+    /**
+     * \brief  Get standard deviation of samples.
+     * \return Square root of variance.
+     */
+    double                      getStandardDeviation() const noexcept;
+
+    /**
+     * \brief  Get the smallest sample.
+     * \return Minimal value or zero if there are no samples.
+     */
+    double                      getMin() const noexcept;
+
+    /**
+     * \brief  Get the largest sample.
+     * \return Maximal value or zero if there are no samples.
+     */
+    double                      getMax() const noexcept;
+
+
+private:
+    /**
+     * \brief Number of samples.
+     */
+    std::uint64_t               _count;
+
+    /**
+     * \brief Mean of samples.
+     */
+    double                      _mean;
+
+    /**
+     * \brief Sum of squared differences from mean.
+     */
+    double                      _squaredDeviations;
+
+    /**
+     * \brief The smallest sample.
+     */
+    double                      _min;
+
+    /**
+     * \brief The largest sample.
+     */
+    double                      _max;
+};
+
+} // namespace stats
+
+#endif // RUNNING_STATISTICS_H
@@ -0,0 +1,75 @@
+#include <algorithm>
+
+#include "Timeline.h"
+
+
+namespace utils
+{
+
+Timeline::Duration Timeline::append(const std::uint64_t tag, const Duration duration)
+{
+    _appendedTime += duration;
+    _numbers[tag] = _released + _entries.size();
+    _entries.push_back({ tag, _appendedTime });
+    return _appendedTime - _releasedTime;
+}
+
+Timeline::Duration Timeline::release(const std::size_t count)
+{
+    const std::size_t released = std::min(count, _entries.size());
+    if (released == 0)
+    {
+        return Duration(0);
+    }
+
+    for (std::size_t i = 0; i < released; ++i)
+    {
+        // Tag could be given to later operation, then it stays in table.
+        const auto it = _numbers.find(_entries[i].tag);
+        if (it != _numbers.end() && it->second == _released + i)
+        {
+            _numbers.erase(it);
+        }
+    }
+
+    const Duration previous = _releasedTime;
+    _releasedTime = _entries[released - 1].finish;
+    _entries.erase(_entries.begin(), _entries.begin() + static_cast<std::ptrdiff_t>(released));
+    _released += released;
+    return _releasedTime - previous;
+}
+
+void Timeline::clear()
+{
+    _released += _entries.size();
+    _releasedTime = _appendedTime;
+    _entries.clear();
+    _numbers.clear();
+}
+
+std::optional<Timeline::Duration> Timeline::find(const std::uint64_t tag) const
+{
+    const auto it = _numbers.find(tag);
+    if (it == _numbers.end())
+    {
+        return std::nullopt;
+    }
+    return _entries[static_cast<std::size_t>(it->second - _released)].finish - _releasedTime;
+}
+
+Timeline::Duration Timeline::getRemaining() const noexcept
+{
+    return _appendedTime - _releasedTime;
+}
+
+std::size_t Timeline::size() const noexcept
+{
+    return _entries.size();
+}
+
+bool Timeline::empty() const noexcept
+{
+    return _entries.empty();
+}
+
+} // namespace utils
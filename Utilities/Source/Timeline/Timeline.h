@@ -0,0 +1,130 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <unordered_map>
+
+
+/**
+ * \brief Unique namespace for utilities functions.
+ */
+namespace utils
+{
+
+/**
+ * \brief   Queue of planned operations which knows when every one of them finishes.
+ * \details Every operation keeps sum of durations of all operations appended before it and its
+ *          own one. Time left to operation is its sum minus sum of released operations, so
+ *          appending, releasing and lookup take constant time however long queue is.
+ */
+class Timeline
+{
+public:
+    /**
+     * \brief Type of durations of operations.
+     */
+    using Duration = std::chrono::microseconds;
+
+
+    /**
+     * \brief Default constructor.
+     */
+                                Timeline() = default;
+
+    /**
+     * \brief              Add operation to the end of queue.
+     * \details            Tag which is already in queue is given to the new operation.
+     * \param[in] tag      Identifier used to find operation.
+     * \param[in] duration Predicted duration of operation.
+     * \return             Time from beginning of queue to the end of operation.
+     */
+    Duration                    append(const std::uint64_t tag, const Duration duration);
+
+    /**
+     * \brief           Remove operations from the beginning of queue.
+     * \param[in] count Number of operations to remove, extra ones are ignored.
+     * \return          Sum of durations of removed operations.
+     */
+    Duration                    release(const std::size_t count);
+
+    /**
+     * \brief Remove all operations.
+     */
+    void                        clear();
+
+    /**
+     * \brief         Find time from beginning of queue to the end of operation.
+     * \param[in] tag Identifier of operation.
+     * \return        Time left to operation or std::nullopt if it is not in queue.
+     */
+    std::optional<Duration>     find(const std::uint64_t tag) const;
+
+    /**
+     * \brief  Get time needed to finish all operations.
+     * \return Sum of durations of operations in queue.
+     */
+    Duration                    getRemaining() const noexcept;
+
+    /**
+     * \brief  Get number of operations.
+     * \return Size of queue.
+     */
+    std::size_t                 size() const noexcept;
+
+    /**
+     * \brief  Check if queue has no operations.
+     * \return True if queue is empty.
+     */
+    bool                        empty() const noexcept;
+
+
+private:
+    /**
+     * \brief Operation and sum of durations up to its end.
+     */
+    struct Entry
+    {
+        /**
+         * \brief Identifier of operation.
+         */
+        std::uint64_t   tag;
+
+        /**
+         * \brief Sum of durations of all operations ever appended up to this one.
+         */
+        Duration        finish;
+    };
+
+
+    /**
+     * \brief Operations in order of appending.
+     */
+    std::deque<Entry>           _entries;
+
+    /**
+     * \brief Number of appended operation for every tag in queue.
+     */
+    std::unordered_map<std::uint64_t, std::uint64_t> _numbers;
+
+    /**
+     * \brief Number of operations removed from queue.
+     */
+    std::uint64_t               _released = 0;
+
+    /**
+     * \brief Sum of durations of all operations ever appended.
+     */
+    Duration                    _appendedTime{ 0 };
+
+    /**
+     * \brief Sum of durations of removed operations.
+     */
+    Duration                    _releasedTime{ 0 };
+};
+
+} // namespace utils
+
+#endif // TIMELINE_H
@@ -0,0 +1,22 @@
+#include <cassert>
+
+#include "Trace.h"
+
+
+namespace stats
+{
+
+void Trace::mark(const std::size_t stage, const Clock::time_point time) noexcept
+{
+    assert(stage < MAX_STAGES);
+
+    stamps[stage] = time;
+    passed |= static_cast<std::uint8_t>(1u << stage);
+}
+
+bool Trace::isMarked(const std::size_t stage) const noexcept
+{
+    return stage < MAX_STAGES && (passed & (1u << stage)) != 0;
+}
+
+} // namespace stats
@@ -0,0 +1,67 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+
+/**
+ * \brief Additional namespace for runtime statistics.
+ */
+namespace stats
+{
+
+/**
+ * \brief   Structure which travels with one point and keeps time when point passed every stage.
+ * \details Stages are indices defined by owner (e.g. receive, enqueue, dispatch). Time is taken
+ *          from monotonic clock, so only stamps made in one process can be compared.
+ */
+struct Trace
+{
+    /**
+     * \brief Clock used for all stamps.
+     */
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * \brief Maximum number of stages in one trace.
+     */
+    static constexpr std::size_t MAX_STAGES = 8;
+
+
+    /**
+     * \brief Identifier of traced point.
+     */
+    std::uint64_t                               id = 0;
+
+    /**
+     * \brief Time when point passed every stage.
+     */
+    std::array<Clock::time_point, MAX_STAGES>   stamps{};
+
+    /**
+     * \brief Bit mask of stages which were passed.
+     */
+    std::uint8_t                                passed = 0;
+
+
+    /**
+     * \brief           Remember that point passed stage (again passed stage gets new time).
+     * \param[in] stage Index of stage.
+     * \param[in] time  Time of passing.
+     */
+    void                mark(const std::size_t stage, const Clock::time_point time = Clock::now())
+                            noexcept;
+
+    /**
+     * \brief           Check if point passed stage.
+     * \param[in] stage Index of stage.
+     * \return          True if stage was marked.
+     */
+    bool                isMarked(const std::size_t stage) const noexcept;
+};
+
+} // namespace stats
+
+#endif // TRACE_H
@@ -0,0 +1,132 @@
+#include <cassert>
+#include <optional>
+#include <sstream>
+
+#include "TraceRecorder.h"
+
+
+namespace stats
+{
+
+namespace
+{
+
+/**
+ * \brief           Get duration in microseconds.
+ * \param[in] begin Beginning of interval.
+ * \param[in] end   End of interval.
+ * \return          Duration.
+ */
+std::chrono::microseconds measure(const Trace::Clock::time_point begin,
+                                  const Trace::Clock::time_point end)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
+}
+
+} // anonymous namespace
+
+TraceRecorder::TraceRecorder(std::vector<std::string> stageNames, const std::string& fileName)
+    : _stageNames(std::move(stageNames)),
+      _spans(_stageNames.size()),
+      _total(),
+      _file(),
+      _start(Trace::Clock::now()),
+      _count(0)
+{
+    assert(_stageNames.size() <= Trace::MAX_STAGES);
+
+    if (!fileName.empty())
+    {
+        _file.open(fileName);
+    }
+}
+
+void TraceRecorder::record(const Trace& trace, const std::string_view tag)
+{
+    std::optional<Trace::Clock::time_point> first;
+    Trace::Clock::time_point previous;
+    if (_file.is_open())
+    {
+        _file << trace.id;
+        if (!tag.empty())
+        {
+            _file << ' ' << tag;
+        }
+    }
+
+    for (std::size_t stage = 0; stage < _stageNames.size(); ++stage)
+    {
+        if (!trace.isMarked(stage))
+        {
+            if (first.has_value() && _file.is_open())
+            {
+                _file << " -";
+            }
+            continue;
+        }
+
+        const Trace::Clock::time_point stamp = trace.stamps[stage];
+        const std::chrono::microseconds span = first.has_value()
+                                             ? measure(previous, stamp)
+                                             : measure(_start, stamp);
+        if (first.has_value())
+        {
+            _spans[stage].record(span);
+        }
+        else
+        {
+            first = stamp;
+        }
+        if (_file.is_open())
+        {
+            _file << ' ' << span.count();
+        }
+        previous = stamp;
+    }
+
+    if (first.has_value())
+    {
+        _total.record(measure(*first, previous));
+    }
+    if (_file.is_open())
+    {
+        _file << '\n';
+    }
+    ++_count;
+}
+
+std::uint64_t TraceRecorder::getCount() const noexcept
+{
+    return _count;
+}
+
+const Histogram& TraceRecorder::getSpan(const std::size_t stage) const
+{
+    return _spans.at(stage);
+}
+
+const Histogram& TraceRecorder::getTotal() const noexcept
+{
+    return _total;
+}
+
+std::string TraceRecorder::getSummary() const
+{
+    std::stringstream result;
+    const auto write = [&result](const std::string& name, const Histogram& histogram)
+    {
+        result << name << " p50 " << histogram.getPercentile(0.5).count()
+               << " p99 " << histogram.getPercentile(0.99).count()
+               << " p999 " << histogram.getPercentile(0.999).count() << " us";
+    };
+
+    write("total", _total);
+    for (std::size_t stage = 1; stage < _stageNames.size(); ++stage)
+    {
+        result << ", ";
+        write(_stageNames[stage - 1] + "->" + _stageNames[stage], _spans[stage]);
+    }
+    return result.str();
+}
+
+} // namespace stats
@@ -0,0 +1,105 @@
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Histogram/Histogram.h"
+#include "Trace.h"
+
+
+/**
+ * \brief Additional namespace for runtime statistics.
+ */
+namespace stats
+{
+
+/**
+ * \brief   Class used to collect finished traces of one thread.
+ * \details Every stage gets histogram of time since the previous passed stage, whole trace gets
+ *          histogram of time from the first to the last passed stage. Every trace is also
+ *          written to file as one line: identifier, optional tag, time of the first stage since
+ *          recorder creation and spans of other stages in microseconds ('-' if stage was not
+ *          passed).
+ */
+class TraceRecorder
+{
+public:
+    /**
+     * \brief                Constructor which opens trace file.
+     * \param[in] stageNames Names of stages in order of passing (used in summary).
+     * \param[in] fileName   File to write traces, empty name means no file.
+     */
+                                TraceRecorder(std::vector<std::string> stageNames,
+                                              const std::string& fileName);
+
+    /**
+     * \brief           Add finished trace.
+     * \param[in] trace Trace to add.
+     * \param[in] tag   Additional text written to file after identifier (e.g. origin of point).
+     */
+    void                        record(const Trace& trace, const std::string_view tag = {});
+
+    /**
+     * \brief  Get number of recorded traces.
+     * \return Number of traces.
+     */
+    std::uint64_t               getCount() const noexcept;
+
+    /**
+     * \brief           Get distribution of time which point spends before stage.
+     * \param[in] stage Index of stage (the first stage has no span and its histogram is empty).
+     * \return          Histogram of spans from the previous passed stage.
+     */
+    const Histogram&            getSpan(const std::size_t stage) const;
+
+    /**
+     * \brief  Get distribution of time from the first to the last passed stage.
+     * \return Histogram of whole traces.
+     */
+    const Histogram&            getTotal() const noexcept;
+
+    /**
+     * \brief  Get p50, p99 and p999 of every span and whole trace.
+     * \return Summary in one line.
+     */
+    std::string                 getSummary() const;
+
+
+private:
+    /**
+     * \brief Names of stages.
+     */
+    std::vector<std::string>    _stageNames;
+
+    /**
+     * \brief Spans of every stage.
+     */
+    std::vector<Histogram>      _spans;
+
+    /**
+     * \brief Whole traces.
+     */
+    Histogram                   _total;
+
+    /**
+     * \brief File to write traces.
+     */
+    std::ofstream               _file;
+
+    /**
+     * \brief Time of recorder creation, the first stamps in file are counted from it.
+     */
+    Trace::Clock::time_point    _start;
+
+    /**
+     * \brief Number of recorded traces.
+     */
+    std::uint64_t               _count;
+};
+
+} // namespace stats
+
+#endif // TRACE_RECORDER_H
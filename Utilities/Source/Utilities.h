@@ -15,6 +15,28 @@
 
 #include "RobotData/RobotData.h"
 
+#include "Protocol/Message.h"
+#include "Protocol/Framer.h"
+#include "Protocol/Heartbeat.h"
+#include "Protocol/AnswerWindow.h"
+
+#include "RingBuffer/RingBuffer.h"
+
+#include "Backoff/Backoff.h"
+
+#include "PathSimplifier/PathSimplifier.h"
+
+#include "Capture/Capture.h"
+
+#include "Interpolation/InterpolationTable.h"
+#include "Interpolation/InterpolationGrid.h"
+#include "Timeline/Timeline.h"
+
+#include "Histogram/Histogram.h"
+#include "RunningStatistics/RunningStatistics.h"
+#include "Trace/Trace.h"
+#include "Trace/TraceRecorder.h"
+
 #include "Printer/Printer.h"
 
 #endif // UTILITIES_H